@@ -0,0 +1,474 @@
+/*
+ * Copyright (C) 2020 Andrew Messing
+ *
+ * grstaps is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 3 of the License,
+ * or any later version.
+ *
+ * grstaps is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with grstaps; if not, write to the Free Software Foundation,
+ * Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+// Micro and macro benchmarks for the planning pipeline. The scheduler benchmarks run on synthetic STNs and need no
+// input. Everything else runs on problem folders in the IJRR layout (domain.pddl, problem.pddl, config.json and
+// map.json) given with --problem; --map replaces the map of every problem, e.g. with one of tests/data/maps.
+//
+// Results are written as JSON to pipeline_benchmark.json unless --benchmark_out/--benchmark_out_format say otherwise
+
+// Global
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+
+// External
+#include <args.hxx>
+#include <benchmark/benchmark.h>
+#include <boost/make_shared.hpp>
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+// Local
+#include <grstaps/Connections/taskAllocationToScheduling.h>
+#include <grstaps/Graph/Graph.h>
+#include <grstaps/Graph/Node.h>
+#include <grstaps/Scheduling/Scheduler.h>
+#include <grstaps/Scheduling/TAScheduleTime.h>
+#include <grstaps/Search/AStarSearch.h>
+#include <grstaps/Task_Allocation/AllocationDistance.h>
+#include <grstaps/Task_Allocation/AllocationExpander.h>
+#include <grstaps/Task_Allocation/AllocationIsGoal.h>
+#include <grstaps/Task_Allocation/TaskAllocation.h>
+#include <grstaps/motion_planning/motion_planner.hpp>
+#include <grstaps/problem.hpp>
+#include <grstaps/solution.hpp>
+#include <grstaps/solver_base.hpp>
+#include <grstaps/task_planning/plan.hpp>
+#include <grstaps/task_planning/planner_parameters.hpp>
+#include <grstaps/task_planning/setup.hpp>
+#include <grstaps/task_planning/successors.hpp>
+#include <grstaps/task_planning/task_planner.hpp>
+
+namespace grstaps
+{
+    namespace benchmarks
+    {
+        /**
+         * Random STN with \p n actions. Every action is ordered after up to two earlier actions and, for the
+         * disjunctive variant, n / 2 random pairs of actions must not overlap
+         */
+        struct SchedulingInstance
+        {
+            std::vector<float> durations;
+            std::vector<std::vector<int>> orderingConstraints;
+            std::vector<std::vector<int>> disjunctiveConstraints;
+
+            SchedulingInstance(int n, unsigned int seed)
+            {
+                std::mt19937 rng(seed);
+                std::uniform_real_distribution<float> duration(1.0f, 10.0f);
+                std::bernoulli_distribution ordered(0.5);
+                durations.reserve(n);
+                for(int i = 0; i < n; ++i)
+                {
+                    durations.push_back(duration(rng));
+                    for(int k = 0; i > 0 && k < 2; ++k)
+                    {
+                        if(ordered(rng))
+                        {
+                            orderingConstraints.push_back({std::uniform_int_distribution<int>(0, i - 1)(rng), i});
+                        }
+                    }
+                }
+                std::uniform_int_distribution<int> action(0, n - 1);
+                for(int i = 0; i < n / 2; ++i)
+                {
+                    const int a = action(rng);
+                    const int b = action(rng);
+                    if(a != b)
+                    {
+                        disjunctiveConstraints.push_back({a, b});
+                    }
+                }
+            }
+        };
+
+        void scheduleBenchmark(benchmark::State& state)
+        {
+            SchedulingInstance instance(state.range(0), 0);
+            for(auto _: state)
+            {
+                Scheduler scheduler;
+                benchmark::DoNotOptimize(scheduler.schedule(instance.durations, instance.orderingConstraints));
+                benchmark::DoNotOptimize(scheduler.getMakeSpan());
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+        BENCHMARK(scheduleBenchmark)->Name("Scheduler/schedule")->RangeMultiplier(2)->Range(8, 512);
+
+        // The disjunctive constraints are resolved by the tabu search inside Scheduler::schedule
+        void scheduleTabuBenchmark(benchmark::State& state)
+        {
+            SchedulingInstance instance(state.range(0), 0);
+            float makespan = 0;
+            for(auto _: state)
+            {
+                Scheduler scheduler;
+                benchmark::DoNotOptimize(scheduler.schedule(
+                    instance.durations, instance.orderingConstraints, instance.disjunctiveConstraints));
+                makespan = scheduler.getMakeSpan();
+            }
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+            state.counters["makespan"] = makespan;
+        }
+        BENCHMARK(scheduleTabuBenchmark)->Name("Scheduler/tabu")->RangeMultiplier(2)->Range(8, 128);
+
+        /**
+         * Loads a problem, finds its first task plan and prepares everything the allocation benchmarks need
+         *
+         * \note Derives from SolverBase for its motion planner and task allocation setup
+         */
+        class PipelineInstance : public SolverBase
+        {
+           public:
+            static constexpr unsigned int s_max_expansions   = 10000;
+            static constexpr unsigned int s_max_sample_plans = 256;
+            static constexpr unsigned int s_max_queries      = 64;
+
+            PipelineInstance(const std::string& folder, const std::string& map_file)
+                : name(std::filesystem::path(folder).lexically_normal().string())
+                , domain(fmt::format("{}/domain.pddl", folder))
+                , problem_file(fmt::format("{}/problem.pddl", folder))
+                , plan(nullptr)
+            {
+                problem.init(domain.c_str(),
+                             problem_file.c_str(),
+                             fmt::format("{}/config.json", folder).c_str(),
+                             map_file.empty() ? fmt::format("{}/map.json", folder).c_str() : map_file.c_str());
+                solve(problem);
+            }
+
+            //! Runs the task planner until the first solution, keeping a sample of the generated plans
+            std::shared_ptr<Solution> solve(Problem& p) override
+            {
+                task_planner = std::make_unique<TaskPlanner>(p.task());
+                for(unsigned int i = 0; i < s_max_expansions && !task_planner->emptySearchSpace(); ++i)
+                {
+                    Plan* base = task_planner->poll();
+                    if(base->isSolution())
+                    {
+                        plan = base;
+                        break;
+                    }
+                    std::vector<Plan*> children = task_planner->getNextSuccessors(base);
+                    for(unsigned int j = 0; j < children.size() && sample_plans.size() < s_max_sample_plans; ++j)
+                    {
+                        sample_plans.push_back(children[j]);
+                    }
+                    task_planner->update(base, children);
+                }
+
+                initial_state = std::make_unique<TState>(p.task());
+                successors.initialize(initial_state.get(), p.task(), false, false, &til_actions);
+
+                motion_planners = setupMotionPlanners(p);
+                if(plan == nullptr)
+                {
+                    return std::make_shared<Solution>(nullptr, nullptr, nlohmann::json{{"error", "could not find plan"}});
+                }
+
+                ordering_constraints = boost::make_shared<std::vector<std::vector<int>>>();
+                durations            = boost::make_shared<std::vector<float>>();
+                noncum_trait_cutoff  = boost::make_shared<std::vector<std::vector<float>>>();
+                goal_distribution    = boost::make_shared<std::vector<std::vector<float>>>();
+                action_locations     = boost::make_shared<std::vector<std::pair<unsigned int, unsigned int>>>();
+                setupTaskAllocationParameters(plan,
+                                              p,
+                                              ordering_constraints,
+                                              durations,
+                                              noncum_trait_cutoff,
+                                              goal_distribution,
+                                              action_locations);
+
+                std::set<unsigned int> locations(p.startingLocations().begin(), p.startingLocations().end());
+                for(const std::pair<unsigned int, unsigned int>& l: *action_locations)
+                {
+                    locations.insert(l.first);
+                    locations.insert(l.second);
+                }
+                for(unsigned int from: locations)
+                {
+                    for(unsigned int to: locations)
+                    {
+                        if(from != to && queries.size() < s_max_queries)
+                        {
+                            queries.emplace_back(from, to);
+                        }
+                    }
+                }
+                return std::make_shared<Solution>(nullptr, nullptr, nlohmann::json{});
+            }
+
+            //! \returns Motion planners that have not answered any query yet
+            boost::shared_ptr<std::vector<boost::shared_ptr<MotionPlanner>>> freshMotionPlanners()
+            {
+                return setupMotionPlanners(problem);
+            }
+
+            //! \returns A fresh root allocation for the first task plan
+            TaskAllocation rootAllocation(boost::shared_ptr<std::vector<boost::shared_ptr<MotionPlanner>>> mps,
+                                          bool lazy = false)
+            {
+                taskAllocationToScheduling ta_to_sched(mps, &problem.startingLocations(), problem.longestPath);
+                ta_to_sched.setActionLocations(action_locations);
+                ta_to_sched.setLazyMotionPlanning(lazy);
+                return TaskAllocation(false,
+                                      goal_distribution,
+                                      &problem.robotTraits(),
+                                      noncum_trait_cutoff,
+                                      ta_to_sched,
+                                      durations,
+                                      ordering_constraints,
+                                      boost::make_shared<std::vector<int>>(problem.robotTraits().size(), 1),
+                                      problem.speedIndex,
+                                      problem.mpIndex);
+            }
+
+            std::string name;
+            std::string domain;
+            std::string problem_file;
+            Problem problem;
+            std::unique_ptr<TaskPlanner> task_planner;
+            Plan* plan;
+            std::vector<Plan*> sample_plans;
+            std::unique_ptr<TState> initial_state;
+            std::vector<SASAction*> til_actions;
+            Successors successors;
+            boost::shared_ptr<std::vector<boost::shared_ptr<MotionPlanner>>> motion_planners;
+            boost::shared_ptr<std::vector<std::vector<int>>> ordering_constraints;
+            boost::shared_ptr<std::vector<float>> durations;
+            boost::shared_ptr<std::vector<std::vector<float>>> noncum_trait_cutoff;
+            boost::shared_ptr<std::vector<std::vector<float>>> goal_distribution;
+            boost::shared_ptr<std::vector<std::pair<unsigned int, unsigned int>>> action_locations;
+            std::vector<std::pair<unsigned int, unsigned int>> queries;
+        };
+
+        void preprocessBenchmark(benchmark::State& state, PipelineInstance* instance)
+        {
+            for(auto _: state)
+            {
+                PlannerParameters parameters;
+                parameters.domainFileName  = instance->domain.c_str();
+                parameters.problemFileName = instance->problem_file.c_str();
+                SASTask* task              = Setup::doPreprocess(&parameters);
+                state.counters["grounded_actions"] = task->actions.size();
+                delete task;
+            }
+        }
+
+        void evaluateBenchmark(benchmark::State& state, PipelineInstance* instance)
+        {
+            unsigned int i = 0;
+            for(auto _: state)
+            {
+                instance->successors.evaluate(instance->sample_plans[i++ % instance->sample_plans.size()]);
+            }
+            state.SetItemsProcessed(state.iterations());
+        }
+
+        void frontierStateBenchmark(benchmark::State& state, PipelineInstance* instance)
+        {
+            unsigned int i = 0;
+            for(auto _: state)
+            {
+                delete instance->successors.getFrontierState(
+                    instance->sample_plans[i++ % instance->sample_plans.size()]);
+            }
+            state.SetItemsProcessed(state.iterations());
+        }
+
+        // Expands the root allocation of the first task plan; the motion plans are cached after the first expansion
+        void allocationExpandBenchmark(benchmark::State& state, PipelineInstance* instance)
+        {
+            auto expander = boost::make_shared<const AllocationExpander>(boost::make_shared<const AllocationDistance>(),
+                                                                         boost::make_shared<const TAScheduleTime>());
+            TaskAllocation ta = instance->rootAllocation(instance->motion_planners);
+            int64_t children  = 0;
+            for(auto _: state)
+            {
+                state.PauseTiming();
+                Graph<TaskAllocation> graph;
+                auto root = boost::make_shared<Node<TaskAllocation>>(ta.getID(), ta);
+                root->setData(ta);
+                graph.addNode(root);
+                state.ResumeTiming();
+
+                (*expander)(graph, root);
+                children += root->leavingEdges.size();
+            }
+            state.SetItemsProcessed(children);
+        }
+
+        // Allocates and schedules the first task plan, as the sequential solver does. When lazy, nodes are scored with
+        // straight line travel times until they are expanded
+        void allocationSearchBenchmark(benchmark::State& state, PipelineInstance* instance, bool lazy)
+        {
+            auto is_goal  = boost::make_shared<const AllocationIsGoal>();
+            auto expander = boost::make_shared<const AllocationExpander>(boost::make_shared<const AllocationDistance>(),
+                                                                         boost::make_shared<const TAScheduleTime>());
+            TaskAllocation ta = instance->rootAllocation(instance->motion_planners, lazy);
+            int64_t expanded  = 0;
+            float makespan    = -1;
+            for(auto _: state)
+            {
+                auto root = boost::make_shared<Node<TaskAllocation>>(ta.getID(), ta);
+                root->setData(ta);
+                Graph<TaskAllocation> graph;
+                graph.addNode(root);
+
+                auto package = std::make_unique<SearchResultPackager<TaskAllocation>>();
+                AStarSearch<TaskAllocation> search(graph, root);
+                while(!search.empty())
+                {
+                    search.search(is_goal, expander, package.get());
+                    if(package->foundGoal && package->finalNode->getData().getScheduleTime() > 0.0)
+                    {
+                        makespan = package->finalNode->getData().getScheduleTime();
+                        break;
+                    }
+                }
+                expanded += search.nodesExpanded;
+            }
+            state.counters["nodes_expanded"] =
+                benchmark::Counter(static_cast<double>(expanded), benchmark::Counter::kAvgIterations);
+            state.counters["makespan"] = makespan;
+        }
+
+        // Every iteration queries a motion planner that has not planned any path yet
+        void motionPlanningColdBenchmark(benchmark::State& state, PipelineInstance* instance)
+        {
+            for(auto _: state)
+            {
+                state.PauseTiming();
+                auto mps = instance->freshMotionPlanners();
+                state.ResumeTiming();
+
+                for(const std::pair<unsigned int, unsigned int>& q: instance->queries)
+                {
+                    benchmark::DoNotOptimize((*mps)[0]->query(q.first, q.second));
+                }
+            }
+            state.SetItemsProcessed(state.iterations() * instance->queries.size());
+        }
+
+        // Queries that have all been answered before
+        void motionPlanningWarmBenchmark(benchmark::State& state, PipelineInstance* instance)
+        {
+            MotionPlanner& mp = *(*instance->motion_planners)[0];
+            for(const std::pair<unsigned int, unsigned int>& q: instance->queries)
+            {
+                mp.query(q.first, q.second);
+            }
+            for(auto _: state)
+            {
+                for(const std::pair<unsigned int, unsigned int>& q: instance->queries)
+                {
+                    benchmark::DoNotOptimize(mp.query(q.first, q.second));
+                }
+            }
+            state.SetItemsProcessed(state.iterations() * instance->queries.size());
+        }
+
+        void registerBenchmarks(PipelineInstance* instance)
+        {
+            const std::string& n = instance->name;
+            benchmark::RegisterBenchmark(
+                fmt::format("Setup/doPreprocess/{}", n).c_str(), preprocessBenchmark, instance)
+                ->Unit(benchmark::kMillisecond);
+            if(!instance->sample_plans.empty())
+            {
+                benchmark::RegisterBenchmark(
+                    fmt::format("Evaluator/evaluate/{}", n).c_str(), evaluateBenchmark, instance);
+                benchmark::RegisterBenchmark(
+                    fmt::format("Linearizer/getFrontierState/{}", n).c_str(), frontierStateBenchmark, instance);
+            }
+            if(instance->plan == nullptr)
+            {
+                std::cerr << fmt::format("No task plan found for {}, skipping allocation benchmarks", n)
+                          << std::endl;
+                return;
+            }
+            benchmark::RegisterBenchmark(
+                fmt::format("AllocationExpander/expand/{}", n).c_str(), allocationExpandBenchmark, instance)
+                ->Unit(benchmark::kMicrosecond);
+            benchmark::RegisterBenchmark(
+                fmt::format("AStarSearch/allocate/{}", n).c_str(), allocationSearchBenchmark, instance, false)
+                ->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(
+                fmt::format("AStarSearch/allocate_lazy/{}", n).c_str(), allocationSearchBenchmark, instance, true)
+                ->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(
+                fmt::format("MotionPlanner/query_cold/{}", n).c_str(), motionPlanningColdBenchmark, instance)
+                ->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(
+                fmt::format("MotionPlanner/query_warm/{}", n).c_str(), motionPlanningWarmBenchmark, instance)
+                ->Unit(benchmark::kMicrosecond);
+        }
+
+        int main(int argc, char** argv)
+        {
+            // Default to JSON output; flags given on the command line come later and take precedence
+            std::string out_flag = "--benchmark_out=pipeline_benchmark.json";
+            std::string format_flag = "--benchmark_out_format=json";
+            std::vector<char*> arguments = {argv[0], out_flag.data(), format_flag.data()};
+            arguments.insert(arguments.end(), argv + 1, argv + argc);
+            int num_arguments = arguments.size();
+            benchmark::Initialize(&num_arguments, arguments.data());
+
+            args::ArgumentParser parser("Planning pipeline benchmarks");
+            args::HelpFlag help(parser, "help", "Display this help menu", {'h', "help"});
+            args::ValueFlagList<std::string> problems(parser, "folder", "IJRR problem folder", {'p', "problem"});
+            args::ValueFlag<std::string> map(parser, "map", "Map file used instead of each problem's map.json",
+                                             {'m', "map"});
+            try
+            {
+                parser.ParseCLI(num_arguments, arguments.data());
+            }
+            catch(args::Help)
+            {
+                std::cout << parser;
+                return 0;
+            }
+            catch(args::ParseError& e)
+            {
+                std::cerr << e.what() << std::endl;
+                std::cerr << parser;
+                return 1;
+            }
+
+            std::vector<std::unique_ptr<PipelineInstance>> instances;
+            for(const std::string& folder: args::get(problems))
+            {
+                instances.push_back(std::make_unique<PipelineInstance>(folder, args::get(map)));
+                registerBenchmarks(instances.back().get());
+            }
+
+            benchmark::RunSpecifiedBenchmarks();
+            benchmark::Shutdown();
+            return 0;
+        }
+    }  // namespace benchmarks
+}  // namespace grstaps
+
+int main(int argc, char** argv)
+{
+    return grstaps::benchmarks::main(argc, argv);
+}
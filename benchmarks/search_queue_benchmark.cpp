@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2020 Andrew Messing
+ *
+ * grstaps is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 3 of the License,
+ * or any later version.
+ *
+ * grstaps is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with grstaps; if not, write to the Free Software Foundation,
+ * Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+// Compares the serial SearchQueue (behind a global mutex) with the ConcurrentSearchQueue on a stream of plan
+// expansions. Each line of a stream file is one expansion: the number of successors followed by the g, h and
+// hLand values of each successor. Worker threads repeatedly poll a plan and add the next recorded batch of
+// successors until the stream is exhausted. Without a stream file, a synthetic best-first stream is generated
+
+// Global
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+
+// External
+#include <args.hxx>
+#include <fmt/format.h>
+
+// Local
+#include <grstaps/task_planning/selector.hpp>
+
+namespace grstaps
+{
+    namespace benchmarks
+    {
+        struct PlanKey
+        {
+            uint16_t g;
+            float h;
+            uint16_t hLand;
+        };
+
+        using Stream = std::vector<std::vector<PlanKey>>;
+
+        Stream readStream(const std::string& filename)
+        {
+            Stream stream;
+            std::ifstream in(filename);
+            std::string line;
+            while(std::getline(in, line))
+            {
+                std::istringstream ss(line);
+                unsigned int n;
+                if(!(ss >> n))
+                {
+                    continue;
+                }
+                stream.emplace_back(n);
+                for(PlanKey& k: stream.back())
+                {
+                    ss >> k.g >> k.h >> k.hLand;
+                }
+            }
+            return stream;
+        }
+
+        // Successors get a heuristic value close to a random open plan, as in a greedy best-first search
+        Stream generateStream(unsigned int expansions, unsigned int seed)
+        {
+            std::mt19937 rng(seed);
+            std::uniform_int_distribution<int> branching(1, 12);
+            std::uniform_int_distribution<int> delta(-2, 2);
+            Stream stream(expansions);
+            float h    = 100;
+            uint16_t g = 0;
+            for(std::vector<PlanKey>& batch: stream)
+            {
+                batch.resize(branching(rng));
+                for(PlanKey& k: batch)
+                {
+                    k.g     = g + 1;
+                    k.h     = std::max(0.0f, h + delta(rng));
+                    k.hLand = (uint16_t)(k.h / 2);
+                }
+                h = std::max(0.0f, h + delta(rng));
+                g++;
+            }
+            return stream;
+        }
+
+        struct Result
+        {
+            double seconds;
+            double meanPolledH;
+        };
+
+        // Replays the stream with the given queue type. Queue must provide add(vector), poll() and size()
+        template <typename Queue>
+        Result replay(Queue& q, const Stream& stream, std::vector<std::unique_ptr<Plan>>& plans, unsigned int numThreads)
+        {
+            std::atomic<unsigned int> next(0);
+            std::atomic<unsigned int> nextPlan(1);
+            std::atomic<double> sumH(0);
+            std::atomic<unsigned int> numPolled(0);
+            std::vector<Plan*> first = {plans[0].get()};
+            q.add(first);
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads;
+            for(unsigned int t = 0; t < numThreads; t++)
+            {
+                threads.emplace_back([&]() {
+                    std::vector<Plan*> batch;
+                    double localH       = 0;
+                    unsigned int polled = 0;
+                    while(true)
+                    {
+                        unsigned int i = next.fetch_add(1);
+                        if(i >= stream.size())
+                        {
+                            break;
+                        }
+                        Plan* p = q.poll();
+                        if(p != nullptr)
+                        {
+                            localH += p->h;
+                            polled++;
+                        }
+                        unsigned int firstPlan = nextPlan.fetch_add(stream[i].size());
+                        batch.clear();
+                        for(unsigned int j = 0; j < stream[i].size(); j++)
+                        {
+                            batch.push_back(plans[firstPlan + j].get());
+                        }
+                        q.add(batch);
+                    }
+                    double expected = sumH.load();
+                    while(!sumH.compare_exchange_weak(expected, expected + localH))
+                        ;
+                    numPolled += polled;
+                });
+            }
+            for(std::thread& t: threads)
+            {
+                t.join();
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            return {elapsed.count(), numPolled > 0 ? sumH / numPolled : 0};
+        }
+
+        // Serial heap made thread-safe with a single lock
+        class LockedSearchQueue
+        {
+           private:
+            std::mutex lock;
+            SearchQueue q;
+
+           public:
+            LockedSearchQueue(int index)
+                : q(index)
+            {}
+
+            unsigned int add(const std::vector<Plan*>& plans)
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                return q.add(plans);
+            }
+
+            Plan* poll()
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                return q.size() > 0 ? q.poll() : nullptr;
+            }
+        };
+
+        std::vector<std::unique_ptr<Plan>> createPlans(const Stream& stream)
+        {
+            std::vector<std::unique_ptr<Plan>> plans;
+            plans.emplace_back(new Plan(nullptr, nullptr, 0));
+            plans[0]->h = plans[0]->hLand = 0;
+            for(const std::vector<PlanKey>& batch: stream)
+            {
+                for(const PlanKey& k: batch)
+                {
+                    Plan* p  = new Plan(nullptr, nullptr, plans.size());
+                    p->g     = k.g;
+                    p->h     = k.h;
+                    p->hLand = k.hLand;
+                    plans.emplace_back(p);
+                }
+            }
+            return plans;
+        }
+
+        int main(int argc, char** argv)
+        {
+            args::ArgumentParser parser("Search queue benchmark");
+            args::HelpFlag help(parser, "help", "Display this help menu", {'h', "help"});
+            args::ValueFlag<std::string> stream_file(parser, "stream_file", "Recorded expansion stream", {'s'});
+            args::ValueFlag<unsigned int> expansions(parser, "expansions", "Synthetic stream length", {'n'}, 200000);
+            args::ValueFlag<unsigned int> max_threads(parser, "max_threads", "Maximum number of threads", {'t'},
+                                                      std::thread::hardware_concurrency());
+            args::ValueFlag<unsigned int> shards(parser, "shards", "Queues per thread in the MultiQueue", {'q'}, 4);
+
+            try
+            {
+                parser.ParseCLI(argc, argv);
+            }
+            catch (args::Help)
+            {
+                std::cout << parser;
+                return 0;
+            }
+            catch (args::ParseError e)
+            {
+                std::cerr << e.what() << std::endl;
+                std::cerr << parser;
+                return 1;
+            }
+
+            Stream stream = stream_file ? readStream(stream_file.Get()) : generateStream(expansions.Get(), 0);
+            std::vector<std::unique_ptr<Plan>> plans = createPlans(stream);
+            std::cout << fmt::format("{0} expansions, {1} plans", stream.size(), plans.size()) << std::endl;
+            std::cout << "threads,queue,seconds,mean_polled_h" << std::endl;
+            for(unsigned int t = 1; t <= std::max(max_threads.Get(), 1u); t <<= 1)
+            {
+                LockedSearchQueue serial(SEARCH_HFF);
+                Result r = replay(serial, stream, plans, t);
+                std::cout << fmt::format("{0},serial,{1:.4f},{2:.3f}", t, r.seconds, r.meanPolledH) << std::endl;
+
+                ConcurrentSearchQueue concurrent(SEARCH_HFF, t * shards.Get());
+                r = replay(concurrent, stream, plans, t);
+                std::cout << fmt::format("{0},multiqueue,{1:.4f},{2:.3f}", t, r.seconds, r.meanPolledH) << std::endl;
+            }
+            return 0;
+        }
+    }  // namespace benchmarks
+}  // namespace grstaps
+
+int main(int argc, char** argv)
+{
+    return grstaps::benchmarks::main(argc, argv);
+}
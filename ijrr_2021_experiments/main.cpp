@@ -51,6 +51,7 @@ namespace grstaps
             args::Flag ta_anytime(group2, "ta_anytime", "TA Anytime", {"ta_a"});
 
             args::ValueFlag<float> ns_time(sequential, "ns_time", "Time taken by the non-sequential version", {"nst"});
+            args::ValueFlag<unsigned int> tp_threads(fcpop, "tp_threads", "Threads of the task planner", {"tpt"}, 1);
 
             try
             {
@@ -120,7 +121,7 @@ namespace grstaps
             {
                 std::cout << "Fcpop: problem " << problem_nr.Get() << " instance " << instance_nr.Get() << std::endl;
                 std::string folder = fmt::format("problems{2}/{0}/{1}", problem_nr.Get(), instance_nr.Get(), ext.Get());
-                SolverFcpop solver;
+                SolverFcpop solver(tp_threads.Get());
                 nlohmann::json fcpop_output = solver.solve(fmt::format("{0}/domain_fcpop.pddl", folder),
                                                            fmt::format("{0}/problem_fcpop.pddl", folder));
                 if(!std::filesystem::exists(folder))
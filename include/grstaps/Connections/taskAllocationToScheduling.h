@@ -22,6 +22,7 @@
 #include <vector>
 
 #include <boost/shared_ptr.hpp>
+#include <nlohmann/json.hpp>
 #include <grstaps/Scheduling/Scheduler.h>
 
 using std::string;
@@ -53,12 +54,13 @@ namespace grstaps
          * Get the schedule for a task allocation that does not use species
          *
          * \param the allocation that needs to be scheduled
+         * \param whether to use straight line travel times instead of querying the motion planners
          *
          * \return the makespan of the schedule
          *
          */
 
-        float getNonSpeciesSchedule(TaskAllocation* allocObject);
+        float getNonSpeciesSchedule(TaskAllocation* allocObject, bool lowerBound = false);
 
         /**
          * Get the schedule for a task allocation that does use species
@@ -87,10 +89,11 @@ namespace grstaps
          *
          * \param the schedule that needs to be adjusted
          * \param the allocation that needs to be scheduled
+         * \param whether to use straight line travel times instead of querying the motion planners
          *
          *
          */
-        float addMotionPlanningNonSpeciesSchedule(TaskAllocation* TaskAlloc);
+        float addMotionPlanningNonSpeciesSchedule(TaskAllocation* TaskAlloc, bool lowerBound = false);
 
         /**
          * Save motion plans of agents
@@ -103,19 +106,89 @@ namespace grstaps
          */
         std::pair<bool, vector<agent_motion_plans>> saveMotionPlanningNonSpeciesSchedule(TaskAllocation* TaskAlloc);
 
+        /**
+         * Lower bound on the makespan of every allocation of a plan, computed before any allocation is searched
+         *
+         * The bound is the longest path through the ordering constraints, where an action takes at least its duration
+         * plus its straight line move and cannot start before a robot could reach it. It is raised to the work of each
+         * cumulative trait divided by the fleet's capacity for it, since concurrent actions share the robots.
+         *
+         * \param the durations of the actions
+         * \param the ordering constraints between the actions
+         * \param the trait requirements of the actions
+         * \param the non cumulative trait cutoffs of the actions
+         * \param the traits of each species
+         * \param the number of robots of each species
+         * \param the index of the speed trait, -1 if there is none
+         * \param the index of the trait that selects the motion planner
+         *
+         * \return -1 if no allocation of the plan can be scheduled, otherwise the bound
+         *
+         * \note Requires the action locations of the plan to be set
+         */
+        float planLowerBound(const std::vector<float>& durations,
+                             const std::vector<std::vector<int>>& orderingConstraints,
+                             const std::vector<std::vector<float>>& goalDistribution,
+                             const std::vector<std::vector<float>>& nonCumTraitCutoff,
+                             const std::vector<std::vector<float>>& speciesDistribution,
+                             const std::vector<int>& numSpec,
+                             int speedIndex,
+                             int mpIndex);
+
         /**
          * Sets a list of the indices of the start and end locations for the actions
          */
         void setActionLocations(boost::shared_ptr<const std::vector<std::pair<unsigned int, unsigned int>>> action_locations);
 
+        /**
+         * Sets the seed, the exact search and the lazy motion planning from a problem configuration. Missing keys
+         * ("schedule_seed", "schedule_exact_budget", "schedule_exact_max_disjuncts" and "lazy_motion_planning")
+         * keep the defaults
+         */
+        void configure(const nlohmann::json& config);
+
+        /**
+         * Sets the seed used by the scheduler when it searches over the disjunctive constraints
+         */
+        void setSeed(unsigned int seed);
+
+        /**
+         * Sets the budget and size limit of the exact search over the disjunctive constraints
+         */
+        void setExactSearch(float budget, int maxDisjuncts);
+
+        /**
+         * Sets whether allocations are first scheduled with straight line travel times, which are a lower bound on the
+         * motion planning travel times
+         */
+        void setLazyMotionPlanning(bool lazy);
+
+        //! \returns whether allocations are first scheduled with straight line travel times
+        bool lazyMotionPlanning() const;
+
         Scheduler sched;
 
        private:
+        /**
+         * Length of the path an agent of a species takes between two locations
+         *
+         * \param the allocation
+         * \param the index of the species, -1 for the straight line
+         * \param the index of the start location
+         * \param the index of the goal location
+         * \param whether to return the straight line distance instead of querying the motion planner
+         *
+         * \return whether the path exists and its length
+         *
+         */
+        std::pair<bool, float> travelLength(TaskAllocation* TaskAlloc, int species, unsigned int from, unsigned int to, bool lowerBound);
+
         std::vector<std::vector<float>> stn;
         std::vector<int> actionOrder;
         std::vector<float> maxTraitTeam;
         std::vector<int> concurrent;
         float longestMP;
+        bool m_lazy_motion_planning = false;
 
         boost::shared_ptr<std::vector<boost::shared_ptr<MotionPlanner>>> m_motion_planners;
         const std::vector<unsigned int>* m_starting_locations;
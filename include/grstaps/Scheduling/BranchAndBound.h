@@ -0,0 +1,118 @@
+/*
+ * Copyright (C)2020 Glen Neville
+ *
+ * GRSTAPS is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 3 of the License,
+ * or any later version.
+ *
+ * GRSTAPS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GRSTAPS; if not, write to the Free Software Foundation,
+ * Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef GRSTAPS_BRANCHANDBOUND_H
+#define GRSTAPS_BRANCHANDBOUND_H
+
+#include <chrono>
+#include <vector>
+
+#include <grstaps/Scheduling/Scheduler.h>
+
+namespace grstaps
+{
+    /**
+     *
+     * Exact search over the orientations of the disjunctive constraints
+     *
+     * Depth first branch and bound. A node is bounded by the critical path of its stn and every unoriented pair by
+     * the longest path through it for each orientation. A pair whose orientation cannot improve on the incumbent is
+     * fixed to the other one before branching
+     *
+     */
+    class BranchAndBound
+    {
+       public:
+        /**
+         *
+         * \param wall clock budget of the search in seconds
+         *
+         */
+        explicit BranchAndBound(float budget);
+
+        /**
+         *
+         * Orients all disjunctive constraints of the scheduler
+         *
+         * \param the scheduler with the disjunctive constraints
+         *
+         * \return whether the best schedule found was proven optimal
+         *
+         */
+        bool solve(const Scheduler& initialSched);
+
+        /**
+         *
+         * \return whether a schedule with all disjunctive constraints oriented was found
+         *
+         */
+        bool hasSolution() const;
+
+        /**
+         *
+         * \return the best schedule found
+         *
+         */
+        const Scheduler& solution() const;
+
+        /**
+         *
+         * \return the makespan of the best schedule found
+         *
+         */
+        float makespan() const;
+
+        /**
+         *
+         * \return the number of nodes expanded by the last search
+         *
+         */
+        unsigned int nodesExpanded() const;
+
+       private:
+        void branch(Scheduler& node);
+
+        /**
+         *
+         * Fixes every pair that only has one orientation left
+         *
+         * \param the node to propagate
+         *
+         * \return the index of the pair to branch on, -1 if all pairs are oriented and -2 if the node can be pruned
+         *
+         */
+        int propagate(Scheduler& node);
+
+        //! Longest path from the end of each action to the end of the schedule
+        void computeTails(Scheduler& node);
+
+        //! Lower bound on the makespan if first is ordered before second
+        float orientedBound(const Scheduler& node, int first, int second) const;
+
+        //! Adds the ordering of the ith disjunctive constraint to the node
+        static bool orient(Scheduler& node, int i, bool ordering);
+
+        float budget;
+        std::chrono::steady_clock::time_point deadline;
+        bool timedOut;
+        unsigned int nodes;
+        float bestMakespan;
+        Scheduler bestSolution;
+        std::vector<float> tails;
+    };
+}  // namespace grstaps
+#endif  // GRSTAPS_BRANCHANDBOUND_H
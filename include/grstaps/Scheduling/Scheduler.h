@@ -20,9 +20,12 @@
 
 // external
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <map>
+#include <random>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <../lib/unordered_map/robin_hood.h>
@@ -34,6 +37,8 @@ namespace grstaps
     class tabu;
     class Scheduler
     {
+        friend class BranchAndBound;
+
        public:
         /**
          *
@@ -62,6 +67,15 @@ namespace grstaps
          */
         Scheduler(const Scheduler& toCopy);
 
+        /**
+         *
+         * copy assignment, copies the same members as the copy constructor
+         *
+         * \param scheduler to copy
+         *
+         */
+        Scheduler& operator=(const Scheduler& toCopy);
+
         /**
          *
          * builds the stn and returns the makespan
@@ -109,18 +123,6 @@ namespace grstaps
                        std::vector<std::vector<int>>& beforeConstraintVec,
                        std::vector<std::vector<int>>& afterConstraintVec);
 
-        /**
-         *
-         * Adds a constraint from the passed stn between two actions
-         *
-         * \param index of action that comes first
-         * \param index of action that comes second
-         * \param the stn that you will be editing
-         *
-         * \return successfully added
-         */
-        float addOCTime2(int first, int second, float newMakespan);
-
         /**
          *
          * Changes the duration of an action
@@ -164,17 +166,6 @@ namespace grstaps
          */
         void removeOCTime(int first, int second, std::vector<std::vector<float>>& stnCopy);
 
-        /**
-         *
-         * Removes a constraint from the passed stn between two actions
-         *
-         * \param index of action that comes first
-         * \param index of action that comes second
-         * \param a stn that you will be editing
-         *
-         */
-        float removeOCTime2(int first, int second);
-
         /**
          *
          * Gets makespan of past stn
@@ -262,6 +253,33 @@ namespace grstaps
          */
         void getRandomDisjunct(Scheduler&);
 
+        /**
+         *
+         * Sets the seed of the generator used to pick the initial disjunctive orderings
+         *
+         * \param the seed
+         *
+         */
+        void setSeed(unsigned int seed);
+
+        /**
+         *
+         * Enables the exact search over the disjunctive constraints. If it does not finish within the budget the
+         * tabu search is run and the better of the two schedules is kept
+         *
+         * \param wall clock budget of the exact search in seconds, 0 disables it
+         * \param the largest number of disjunctive constraints the exact search is tried on
+         *
+         */
+        void setExactSearch(float budget, int maxDisjuncts);
+
+        /**
+         *
+         * \return whether the orderings of the disjunctive constraints were proven to give the shortest makespan
+         *
+         */
+        bool isOptimal() const;
+
         /**
          *
          * gives makespan of if ordering constraint was added between the two actions
@@ -291,12 +309,34 @@ namespace grstaps
 
         /**
          *
-         * returns the disjunctive ordering as a string
+         * returns the Zobrist hash of the disjunctive orderings
          *
-         * \return disjunctive constraints string
+         * \return hash of the disjunctive orderings
+         *
+         */
+        uint64_t getDisjuctiveID() const;
+
+        /**
+         *
+         * returns the Zobrist hash of the disjunctive orderings with the ith ordering switched
+         *
+         * \param the number of the disjunctive ordering to switch
+         *
+         * \return hash of the switched disjunctive orderings
+         *
+         */
+        uint64_t getDisjuctiveSwitchID(int i) const;
+
+        /**
+         *
+         * returns the ith disjunctive ordering
+         *
+         * \param the number of the disjunctive ordering
+         *
+         * \return the ordering of the disjunctive constraint
          *
          */
-        std::string getDisjuctiveID();
+        bool getDisjuctiveOrdering(int i) const;
 
         /**
          *
@@ -350,14 +390,90 @@ namespace grstaps
 
        private:
         std::vector<std::vector<int>> disjuctiveConstraints;  // list of disjunctive constraints
-        std::vector<int> disjuctiveOrderings;                 // the orderings on those constraints
+        /**
+         *
+         * sets the ith disjunctive ordering and updates the hash of the orderings
+         *
+         * \param the number of the disjunctive ordering
+         * \param the ordering of the disjunctive constraint
+         *
+         */
+        void setDisjuctiveOrdering(int i, bool ordering);
+
+        //! resets all disjunctive orderings to 0
+        void clearDisjuctiveOrderings();
+
+        //! \returns the random key that is xor-ed into the hash when the ith ordering is 1
+        static uint64_t zobristKey(int i);
+
+        /**
+         *
+         * resets the topological order of the actions to their indices
+         *
+         */
+        void initOrder();
+
+        /**
+         *
+         * updates the topological order for a new ordering constraint (Pearce-Kelly). Only the actions between the
+         * two positions are visited
+         *
+         * \param index of action that comes first
+         * \param index of action that comes second
+         *
+         * \return false if the constraint would create a cycle, in which case the order is unchanged
+         *
+         */
+        bool insertOrder(int first, int second);
+
+        /**
+         *
+         * checks if there is a path of ordering constraints between two actions, only visiting actions that are
+         * not after the target in the topological order
+         *
+         * \param index of the action to start from
+         * \param index of the action to reach
+         *
+         * \return whether the target is reachable
+         *
+         */
+        bool reachable(int from, int to);
+
+        /**
+         *
+         * recomputes the start times of an action and everything that depends on it with one longest path pass over
+         * the topological suffix starting at the action
+         *
+         * \param index of the action
+         * \param whether the end of the action has changed, so its successors must be updated
+         *
+         */
+        void propagate(int actionIndex, bool changed = false);
+
+        //! \returns the mark for the current search, invalidating all previous marks
+        uint32_t nextMark();
+
+        std::vector<uint64_t> disjuctiveOrderings;            // the orderings on those constraints, packed 64 per word
         int lastAction;
-        std::string disID;
+        uint64_t disID;                                       // zobrist hash of the orderings
+        unsigned int seed = 0;                                // seed restored at the start of every disjunctive search
+        std::minstd_rand rng;                                 // per scheduler stream for the random orderings
+        float exactBudget = 0;                                // seconds given to the exact search, 0 disables it
+        int exactMaxDisjuncts = 0;                            // largest disjunctive set given to the exact search
+        bool optimal = true;                                  // the orderings were proven optimal
         int flag = 1;
         std::vector<std::vector<float>> copySTN;
         std::vector<int> constraintsToUpdate;
-        robin_hood::unordered_map<int, std::vector<float>> editedActionTimes;
         float longestMotion;
+        std::vector<int> topologicalOrder;  // actions sorted so that every ordering constraint points forward
+        std::vector<int> topologicalIndex;  // position of each action in topologicalOrder
+        std::vector<uint32_t> marks;        // visited/dirty marks for the searches on the ordering graph
+        uint32_t mark = 0;
+        std::vector<int> forwardSet;
+        std::vector<int> backwardSet;
+        std::vector<int> positions;
+        bool logSTN = false;                             // record the changes to stn in stnLog
+        std::vector<std::tuple<int, float, float>> stnLog;  // (action, start, end) before each change to stn
     };
 }  // namespace grstaps
 #endif  // GRSTAPS_SCHEDULER_H
@@ -1,9 +1,9 @@
 #ifndef TABU
 #define TABU
 
-#include <string>
+#include <cstdint>
 #include <iostream>
-#include <../lib/unordered_map/robin_hood.h>
+#include <vector>
 #include <grstaps/Scheduling/Scheduler.h>
 
 #define TABU_LENGTH 200
@@ -13,6 +13,44 @@
 
 namespace grstaps
 {
+    /**
+     *
+     * Open addressing table from the hash of a set of disjunctive orderings to the iteration until which it is tabu
+     * and its makespan. Clearing only bumps a generation counter
+     *
+     */
+    class TabuMemory
+    {
+       public:
+        struct Entry
+        {
+            uint64_t key;
+            uint32_t generation;
+            int tabuUntil;
+            float makespan;
+        };
+
+        TabuMemory();
+
+        //! \returns the entry for key or nullptr if it is not in the table
+        const Entry* find(uint64_t key) const;
+
+        //! sets the tabu tenure and the makespan of key
+        void set(uint64_t key, int tabuUntil, float makespan);
+
+        //! removes all entries
+        void clear();
+
+       private:
+        size_t slot(uint64_t key) const;
+        void grow();
+
+        std::vector<Entry> entries;
+        size_t mask;
+        size_t count;
+        uint32_t generation;
+    };
+
     class tabu
     {
        public:
@@ -22,8 +60,7 @@ namespace grstaps
 
        private:
         double bestSolverScore;
-        robin_hood::unordered_map<std::string, int> tabu_list;
-        robin_hood::unordered_map<std::string, float> foundMakespans;
+        TabuMemory tabu_list;
         Scheduler bestSolution;
         Scheduler currentSched;
         double bestSolutionScore;
@@ -84,8 +84,11 @@ namespace grstaps
         /**
          * Update the Current node
          *
+         * \param if set, nodes whose cost was only estimated are reevaluated and put back on the frontier if
+         *        their cost increased
+         *
          */
-        bool updateCurrent();
+        bool updateCurrent(const NodeExpander<TaskAllocation> *expander = nullptr);
 
         //! \returns Whether the frontier is empty
         bool empty() const;
@@ -181,7 +184,7 @@ namespace grstaps
                                    boost::shared_ptr<const NodeExpander<TaskAllocation>> expander,
                                    SearchResultPackager<Data> *results)
     {
-        bool searchFailed = updateCurrent();
+        bool searchFailed = updateCurrent(expander.get());
         while(!searchFailed)
         {
             if((*goal)(this->graph, currentNode))
@@ -198,13 +201,13 @@ namespace grstaps
                 auto node = this->graph.findNode(itr->second->getTailNode());
                 frontier.push(node);
             }
-            searchFailed = updateCurrent();
+            searchFailed = updateCurrent(expander.get());
         }
         results->addResults(this->graph, currentNode, searchFailed);
     }
 
     template <class Data>
-    bool AStarSearch<Data>::updateCurrent()
+    bool AStarSearch<Data>::updateCurrent(const NodeExpander<TaskAllocation> *expander)
     {
         bool searchFailed = false;
         if(frontier.empty())
@@ -220,8 +223,16 @@ namespace grstaps
             //}
             //cout << "done" << endl;
             currentNode = frontier.top();
-            closedList.push(currentNode);
             frontier.pop();
+
+            // The true cost can only be higher than the estimate, so the node is expanded only if it is still the best
+            while(expander != nullptr && expander->reevaluate(this->graph, currentNode))
+            {
+                frontier.push(currentNode);
+                currentNode = frontier.top();
+                frontier.pop();
+            }
+            closedList.push(currentNode);
             nodesExpanded += 1;
         }
         return searchFailed;
@@ -61,6 +61,17 @@ namespace grstaps
         // operator function () on objects of increment
         virtual bool operator()(Graph<Data>&, nodePtr<Data>) const = 0;
 
+        /**
+         * Computes the true cost of a node taken from the frontier whose cost was only estimated
+         *
+         * \param the graph
+         * \param the node
+         *
+         * \return whether the cost increased, in which case the node has to go back on the frontier
+         *
+         */
+        virtual bool reevaluate(Graph<Data>&, nodePtr<Data>) const;
+
         boost::shared_ptr<const Heuristic> heuristicFunc;  //!< heuristic object
         boost::shared_ptr<const Cost> costFunc;            //!< cost object
     };
@@ -60,6 +60,17 @@ namespace grstaps
          */
         bool operator()(Graph<TaskAllocation>& graph, nodePtr<TaskAllocation> expandNode) const override;
 
+        /**
+         * Replaces the straight line travel times of a node by the motion planning ones
+         *
+         * \param the graph
+         * \param the node taken from the frontier
+         *
+         * \return whether the heuristic of the node increased
+         *
+         */
+        bool reevaluate(Graph<TaskAllocation>& graph, nodePtr<TaskAllocation> node) const override;
+
         /**
          * Gets the id of the new node by editing the parent node
          *
@@ -121,6 +121,22 @@ namespace grstaps
          */
         float getScheduleTime();
 
+        /**
+         * runs the scheduler with the motion planners on this allocation if its schedule time is only a lower bound
+         *
+         * \return the time to schedule, 0 if the motion plans are infeasible
+         *
+         */
+        float getExactScheduleTime();
+
+        /**
+         * Was the schedule time computed with straight line travel times
+         *
+         * \return bool is the schedule time a lower bound
+         *
+         */
+        bool isScheduleLowerBound() const;
+
         /**
          * Is this node a goal node
          *
@@ -362,6 +378,7 @@ namespace grstaps
         boost::shared_ptr<vector<vector<float>>> actionNoncumulativeTraitValue{};
         boost::shared_ptr<vector<vector<int>>> orderingConstraints{};
         float scheduleTime;
+        bool scheduleLowerBound = false;
         float goalDistance;
 
 
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C)2020 Andrew Messing
+ *
+ * GRSTAPS is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 3 of the License,
+ * or any later version.
+ *
+ * GRSTAPS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GRSTAPS; if not, write to the Free Software Foundation,
+ * Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef GRSTAPS_COMPILED_MAP_HPP
+#define GRSTAPS_COMPILED_MAP_HPP
+
+// global
+#include <string>
+#include <vector>
+
+// external
+#include <clipper/clipper.hpp>
+#include <nlohmann/json.hpp>
+
+namespace grstaps
+{
+    /**
+     * The free space polygons of a map together with the values that are derived from them
+     *
+     * Compiling unions, smooths and simplifies the buildings and roads of a json map. The result can be written to
+     * a compact binary file so later solves skip the polygon operations.
+     */
+    class CompiledMap
+    {
+       public:
+        /**
+         * Builds the ground map from the buildings and roads of a json map and the aerial map from its bounds
+         */
+        static CompiledMap compile(const nlohmann::json& map);
+
+        /**
+         * Loads a map file that is either a json map or a compiled map
+         *
+         * \throws std::runtime_error If a compiled map is truncated or from another version
+         */
+        static CompiledMap load(const std::string& filepath);
+
+        //! \returns Whether the file starts with the header of a compiled map
+        static bool isCompiled(const std::string& filepath);
+
+        //! Writes the map to a binary file that load() reads back
+        void write(const std::string& filepath) const;
+
+        std::vector<ClipperLib2::Paths> maps;  //!< Free space of each species map, ground then aerial
+        float boundaryMin;                     //!< Lower bound for either axis of the motion planners
+        float boundaryMax;                     //!< Upper bound for either axis of the motion planners
+        float longestPerimeter;                //!< Largest total perimeter of the polygons of a species map
+    };
+}  // namespace grstaps
+
+#endif  // GRSTAPS_COMPILED_MAP_HPP
@@ -38,6 +38,22 @@ namespace grstaps
     class Logger
     {
        public:
+        /**
+         * Writes a message to the logger using fmt format with
+         * the trace level
+         *
+         * \param message The format string for the log message
+         * \param args The arguments to be format into the log message
+         *
+         * \tparam Args A list of argument types to formatted into the
+         *              log message
+         */
+        template <typename... Args>
+        static void trace(const std::string &message, Args &&... args)
+        {
+            getInstance()->trace(message.c_str(), std::forward<Args>(args)...);
+        }
+
         /**
          * Writes a message to the logger using fmt format with
          * the debug level
@@ -121,37 +137,42 @@ namespace grstaps
        private:
         /**
          * Returns the logger as a singleton
+         *
+         * \note The logger is created once and cached, so logging does not go through the spdlog registry
          */
-        static std::shared_ptr<spdlog::logger> getInstance()
+        static const std::shared_ptr<spdlog::logger>& getInstance()
         {
-            // Only initialize once
-            static bool first = true;
-            if(first)
+            static const std::shared_ptr<spdlog::logger> logger = createInstance();
+            return logger;
+        }
+
+        /**
+         * Creates the logger and registers it in spdlog
+         */
+        static std::shared_ptr<spdlog::logger> createInstance()
+        {
+            time_t now = time(nullptr);
+
+            // Create the logs folder if it does not exist
+            std::experimental::filesystem::path logs_folder = "logs";
+            if(! std::experimental::filesystem::exists(logs_folder))
             {
-                first      = false;
-                time_t now = time(nullptr);
-
-                // Create the logs folder if it does not exist
-                std::experimental::filesystem::path logs_folder = "logs";
-                if(! std::experimental::filesystem::exists(logs_folder))
-                {
-                    std::experimental::filesystem::create_directory(logs_folder);
-                }
-
-                // Create logger sinks
-                std::vector<spdlog::sink_ptr> sinks;
-                sinks.push_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
-                sinks.push_back(std::make_shared<spdlog::sinks::basic_file_sink_mt>(
-                    fmt::format("logs/{}.txt", asctime(localtime(&now)))));
-
-                // Configure a logger
-                auto logger = std::make_shared<spdlog::logger>("grstaps", begin(sinks), end(sinks));
-                spdlog::set_pattern("[%H:%M:%S %z] [thread %t] [%I] %v");
-                spdlog::register_logger(logger);
-                spdlog::set_level(spdlog::level::debug);
+                std::experimental::filesystem::create_directory(logs_folder);
             }
 
-            return spdlog::get("grstaps");
+            // Create logger sinks
+            std::vector<spdlog::sink_ptr> sinks;
+            sinks.push_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+            sinks.push_back(std::make_shared<spdlog::sinks::basic_file_sink_mt>(
+                fmt::format("logs/{}.txt", asctime(localtime(&now)))));
+
+            // Configure a logger
+            auto logger = std::make_shared<spdlog::logger>("grstaps", begin(sinks), end(sinks));
+            spdlog::set_pattern("[%H:%M:%S %z] [thread %t] [%I] %v");
+            spdlog::register_logger(logger);
+            // The GRSTAPS_LOG_* macros already leave out the levels below GRSTAPS_LOG_ACTIVE_LEVEL
+            spdlog::set_level(spdlog::level::trace);
+            return logger;
         }
 
         /**
@@ -161,4 +182,61 @@ namespace grstaps
     };
 }  // namespace grstaps
 
+/*
+ * Compile-time log levels (in the style of SPDLOG_ACTIVE_LEVEL). Calls through the GRSTAPS_LOG_* macros below
+ * GRSTAPS_LOG_ACTIVE_LEVEL are removed by the preprocessor, arguments included. Use them in hot loops. The level
+ * defaults to INFO when NDEBUG is defined and to DEBUG otherwise
+ */
+#define GRSTAPS_LOG_LEVEL_TRACE 0
+#define GRSTAPS_LOG_LEVEL_DEBUG 1
+#define GRSTAPS_LOG_LEVEL_INFO 2
+#define GRSTAPS_LOG_LEVEL_WARN 3
+#define GRSTAPS_LOG_LEVEL_ERROR 4
+#define GRSTAPS_LOG_LEVEL_CRITICAL 5
+#define GRSTAPS_LOG_LEVEL_OFF 6
+
+#ifndef GRSTAPS_LOG_ACTIVE_LEVEL
+#ifdef NDEBUG
+#define GRSTAPS_LOG_ACTIVE_LEVEL GRSTAPS_LOG_LEVEL_INFO
+#else
+#define GRSTAPS_LOG_ACTIVE_LEVEL GRSTAPS_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+#if GRSTAPS_LOG_ACTIVE_LEVEL <= GRSTAPS_LOG_LEVEL_TRACE
+#define GRSTAPS_LOG_TRACE(...) ::grstaps::Logger::trace(__VA_ARGS__)
+#else
+#define GRSTAPS_LOG_TRACE(...) ((void)0)
+#endif
+
+#if GRSTAPS_LOG_ACTIVE_LEVEL <= GRSTAPS_LOG_LEVEL_DEBUG
+#define GRSTAPS_LOG_DEBUG(...) ::grstaps::Logger::debug(__VA_ARGS__)
+#else
+#define GRSTAPS_LOG_DEBUG(...) ((void)0)
+#endif
+
+#if GRSTAPS_LOG_ACTIVE_LEVEL <= GRSTAPS_LOG_LEVEL_INFO
+#define GRSTAPS_LOG_INFO(...) ::grstaps::Logger::info(__VA_ARGS__)
+#else
+#define GRSTAPS_LOG_INFO(...) ((void)0)
+#endif
+
+#if GRSTAPS_LOG_ACTIVE_LEVEL <= GRSTAPS_LOG_LEVEL_WARN
+#define GRSTAPS_LOG_WARN(...) ::grstaps::Logger::warn(__VA_ARGS__)
+#else
+#define GRSTAPS_LOG_WARN(...) ((void)0)
+#endif
+
+#if GRSTAPS_LOG_ACTIVE_LEVEL <= GRSTAPS_LOG_LEVEL_ERROR
+#define GRSTAPS_LOG_ERROR(...) ::grstaps::Logger::error(__VA_ARGS__)
+#else
+#define GRSTAPS_LOG_ERROR(...) ((void)0)
+#endif
+
+#if GRSTAPS_LOG_ACTIVE_LEVEL <= GRSTAPS_LOG_LEVEL_CRITICAL
+#define GRSTAPS_LOG_CRITICAL(...) ::grstaps::Logger::critical(__VA_ARGS__)
+#else
+#define GRSTAPS_LOG_CRITICAL(...) ((void)0)
+#endif
+
 #endif  // GRSTAPS_LOGGER_HPP
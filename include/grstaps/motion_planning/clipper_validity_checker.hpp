@@ -5,6 +5,10 @@
 #ifndef GRSTAPS_CLIPPER_VALIDITY_CHECKER_HPP
 #define GRSTAPS_CLIPPER_VALIDITY_CHECKER_HPP
 
+// global
+#include <array>
+#include <vector>
+
 #include <clipper/clipper.hpp>
 #include <ompl/base/StateValidityChecker.h>
 
@@ -29,6 +33,7 @@ namespace grstaps
 
        private:
         ClipperLib2::Paths m_internals;
+        std::vector<std::array<ClipperLib2::cInt, 4>> m_bounds;  //!< min x, min y, max x, max y of each polygon
     };
 }
 
@@ -20,9 +20,11 @@
 #define GRSTAPS_MOTION_PLANNER_HPP
 
 // global
-#include <map>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <utility>
+#include <vector>
 
 // external
 #include <box2d/b2_polygon_shape.h>
@@ -33,6 +35,8 @@
 
 // local
 #include "grstaps/location.hpp"
+#include "grstaps/motion_planning/roadmap.hpp"
+#include "grstaps/motion_planning/visibility_graph.hpp"
 #include "grstaps/timer.hpp"
 
 namespace grstaps
@@ -40,7 +44,9 @@ namespace grstaps
     /**
      * Wrapper for Open Motion Planning Library
      *
-     * \note Currently using Lazy PRM*
+     * \note Currently using Lazy PRM*, or a visibility graph for maps given as clipper polygons
+     * \note query and getWaypoints can be called from several threads at once, but the setters must not run
+     *       concurrently with them: query reads the number of locations and the distance matrix without the lock
      */
     class MotionPlanner : public Noncopyable
     {
@@ -76,14 +82,38 @@ namespace grstaps
          */
         void setLocations(const std::vector<Location>& locations);
 
+        /**
+         * Sets the number of milestones of the roadmap that answers all queries from a location at once
+         *
+         * \note Pairs the roadmap does not connect are planned with a query of their own. 0, the default, plans every
+         *       pair with a query of its own
+         */
+        void setRoadmapSize(unsigned int num_milestones);
+
+        /**
+         * Sets whether queries are answered exactly with a visibility graph instead of by sampling
+         *
+         * \param enabled Whether to use the visibility graph
+         * \param robot_radius The distance the robot keeps from the boundary of the free space
+         *
+         * \note Only used for maps that are set as clipper polygons. The graph is built here and whenever the map
+         *       changes, so queries only search it
+         */
+        void setVisibilityGraph(bool enabled, float robot_radius = 0);
+
         /**
          * \param from The identifier for the location that a robot is travelling from
          * \param to The identifier for the location that a robot is travelling to
          *
          * \returns Whether a motion plan can be created and the length of the motion plan
+         *
+         * \note Pairs that have been planned before are a single load from the distance matrix without locking
          */
         std::pair<bool, float> query(unsigned int from, unsigned int to);
 
+        /**
+         * \returns Whether a motion plan can be created, the length of the motion plan and a copy of its waypoints
+         */
         std::tuple<bool, float, std::vector<std::pair<float, float>>> getWaypoints(unsigned int from, unsigned int to);
 
         //! \returns The total time spent motion planning
@@ -93,8 +123,36 @@ namespace grstaps
        private:
         bool waypointQuery(unsigned int from, unsigned int to, ompl::base::ProblemDefinitionPtr problem_def);
 
+        //! Plans the path between a pair of locations if it is not known yet, requires the lock
+        //! \returns The length of the path, -1 if there is none
+        float plan(unsigned int from, unsigned int to);
+
+        //! Stores a path in both directions unless the pair is already known
+        void remember(unsigned int from,
+                      unsigned int to,
+                      bool found,
+                      float length,
+                      const std::vector<std::pair<float, float>>& waypoints);
+
+        //! Forgets every path, sized for the current locations
+        void resetMemory();
+
+        //! Adds the paths from a location to every location that the roadmap connects to the memory
+        void roadmapQuery(unsigned int from);
+
+        //! Builds the visibility graph if it is enabled and the map was set as clipper polygons, requires the lock
+        void buildVisibilityGraph();
+
         bool m_map_set;                     //!< Whether the map has been set for the motion planner
         float m_query_time;                 //!< How long a query can run for
+        float m_connection_range;           //!< Longest edge of the roadmap
+        unsigned int m_roadmap_size;        //!< Number of milestones of the roadmap, 0 disables it
+        std::unique_ptr<Roadmap> m_roadmap; //!< Built on the first query after the map or locations change
+        std::vector<bool> m_roadmap_sources;  //!< Locations whose paths have been added from the roadmap
+        bool m_use_visibility_graph;        //!< Whether to answer queries with the visibility graph
+        float m_robot_radius;               //!< Offset of the free space for the visibility graph
+        ClipperLib2::Paths m_clipper_map;   //!< Empty unless the map was set as clipper polygons
+        std::unique_ptr<VisibilityGraph> m_visibility_graph;  //!< Built when it is enabled or the map changes
         ompl::base::PlannerPtr m_planner;   //!< The OMPL motion planner
         ompl::base::StateSpacePtr m_space;  //!< Outline of the space
         ompl::base::SpaceInformationPtr
@@ -102,7 +160,19 @@ namespace grstaps
         std::mutex m_mutex;
         Timer m_timer;
 
-        std::map<std::pair<unsigned int, unsigned int>, std::tuple<bool, float, std::vector<std::pair<float, float>>>> m_memory;
+        //! Slice of the waypoint arena that holds the path of a pair of locations
+        struct PathRange
+        {
+            unsigned int offset;
+            unsigned int count;
+            bool reversed;  //!< The waypoints were stored for the opposite direction
+        };
+
+        //! Length of the path for each pair, indexed by from * number of locations + to. -1 if there is no path and
+        //! -2 if the pair has not been planned
+        std::unique_ptr<std::atomic<float>[]> m_distances;
+        std::vector<PathRange> m_paths;                    //!< Same indexing as the distances
+        std::vector<std::pair<float, float>> m_waypoints;  //!< Waypoints of every path that has been planned
     };
 }  // namespace grstaps
 
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C)2020 Andrew Messing
+ *
+ * GRSTAPS is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 3 of the License,
+ * or any later version.
+ *
+ * GRSTAPS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GRSTAPS; if not, write to the Free Software Foundation,
+ * Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef GRSTAPS_ROADMAP_HPP
+#define GRSTAPS_ROADMAP_HPP
+
+// global
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// external
+#include <ompl/base/SpaceInformation.h>
+
+// local
+#include "grstaps/location.hpp"
+
+namespace grstaps
+{
+    /**
+     * Probabilistic roadmap (PRM*) over a map that answers the paths from one location to every other location with a
+     * single graph search
+     *
+     * \note Edges are only collision checked when the search settles a vertex through them, and the result is kept
+     *       for later searches
+     */
+    class Roadmap
+    {
+       public:
+        using Path = std::tuple<bool, float, std::vector<std::pair<float, float>>>;
+
+        /**
+         * Samples the milestones and connects them and the locations to their nearest neighbors
+         *
+         * \param space_information The space to plan in, including its validity checker
+         * \param locations The locations that are queried, they become the first vertices
+         * \param num_milestones The number of valid states to sample
+         * \param connection_range The longest edge, 0 for no limit
+         */
+        Roadmap(const ompl::base::SpaceInformationPtr& space_information,
+                const std::vector<Location>& locations,
+                unsigned int num_milestones,
+                float connection_range);
+
+        /**
+         * \param from The identifier for the location to start from
+         *
+         * \returns Whether each location is reachable, the length of the path to it and its waypoints
+         */
+        std::vector<Path> query(unsigned int from);
+
+       private:
+        struct Edge
+        {
+            unsigned int from;
+            unsigned int to;
+            float length;
+            char state;  //!< 0 unchecked, 1 valid, 2 in collision
+        };
+
+        //! Connects a vertex to its k nearest vertices within the connection range
+        void connect(unsigned int vertex, unsigned int k, float connection_range);
+
+        //! \returns Whether the motion along an edge is collision free, checking it on first use
+        bool edgeValid(unsigned int edge);
+
+        ompl::base::SpaceInformationPtr m_space_information;
+        unsigned int m_num_locations;
+        std::vector<std::pair<double, double>> m_vertices;                      //!< locations first, then milestones
+        std::vector<bool> m_vertex_valid;
+        std::vector<Edge> m_edges;
+        std::vector<std::vector<std::pair<unsigned int, unsigned int>>> m_adjacency;  //!< (neighbor, edge) per vertex
+    };
+}  // namespace grstaps
+
+#endif  // GRSTAPS_ROADMAP_HPP
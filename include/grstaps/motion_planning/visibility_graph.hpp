@@ -0,0 +1,115 @@
+/*
+ * Copyright (C)2020 Andrew Messing
+ *
+ * GRSTAPS is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 3 of the License,
+ * or any later version.
+ *
+ * GRSTAPS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GRSTAPS; if not, write to the Free Software Foundation,
+ * Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef GRSTAPS_VISIBILITY_GRAPH_HPP
+#define GRSTAPS_VISIBILITY_GRAPH_HPP
+
+// global
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// external
+#include <clipper/clipper.hpp>
+
+// local
+#include "grstaps/location.hpp"
+
+namespace grstaps
+{
+    /**
+     * Reduced visibility graph over a polygonal map that answers shortest path queries exactly
+     *
+     * The map uses the same representation as the ClipperValidityChecker: the polygons enclose the free space and
+     * their coordinates are scaled by 1E6. The nodes are the reflex corners of the free space and only the edges
+     * that are tangent to the boundary at both of their nodes are kept, which contains every shortest path. The edges
+     * of the boundary are bucketed in a uniform grid, so a visibility test only looks at the edges near the segment.
+     *
+     * \note Deterministic: the same map and locations always give the same paths
+     */
+    class VisibilityGraph
+    {
+       public:
+        using Path = std::tuple<bool, float, std::vector<std::pair<float, float>>>;
+
+        /**
+         * Shrinks the free space by the robot radius and connects the corners that can see each other
+         *
+         * \param map The polygons that enclose the free space
+         * \param locations The locations that are queried
+         * \param robot_radius The distance the robot keeps from the boundary of the free space
+         */
+        VisibilityGraph(const ClipperLib2::Paths& map, const std::vector<Location>& locations, float robot_radius);
+
+        /**
+         * Replaces the locations that are queried, the graph between the corners is kept
+         */
+        void setLocations(const std::vector<Location>& locations);
+
+        /**
+         * \param from The identifier for the location to start from
+         * \param to The identifier for the location to go to
+         *
+         * \returns Whether a path exists, its length and its waypoints
+         */
+        Path query(unsigned int from, unsigned int to);
+
+        //! \returns The number of corners in the graph
+        unsigned int numNodes() const;
+
+       private:
+        using Point = std::pair<double, double>;
+
+        //! \returns Whether a point is in the free space or on its boundary
+        bool isFree(const Point& point) const;
+
+        //! \returns Whether the segment between two points stays in the free space
+        bool isVisible(const Point& a, const Point& b) const;
+
+        //! \returns Whether the line from a node towards a point does not cut into the obstacle at the node
+        bool isTangent(unsigned int node, const Point& point) const;
+
+        //! Calls visit with the index of every grid cell that the segment between two points passes through
+        template <typename Visit>
+        void forEachCell(const Point& a, const Point& b, Visit visit) const;
+
+        //! \returns The boundary edges in the given cells, without repetitions
+        std::vector<unsigned int> boundaryEdges(const std::vector<unsigned int>& cells) const;
+
+        //! \returns The nodes that a location can see with the distance to each, computed on first use
+        const std::vector<std::pair<unsigned int, double>>& locationEdges(unsigned int location);
+
+        ClipperLib2::Paths m_map;                                          //!< The free space after the offset
+        std::vector<std::pair<Point, Point>> m_boundary;                   //!< Every edge of the free space
+        Point m_grid_min;                                                  //!< Lower corner of the grid
+        Point m_grid_max;                                                  //!< Upper corner of the grid
+        double m_cell_size;
+        unsigned int m_num_columns;
+        unsigned int m_num_rows;
+        std::vector<std::vector<unsigned int>> m_cells;  //!< Boundary edges that pass through each cell, by rows
+        std::vector<Point> m_nodes;                                        //!< Reflex corners of the free space
+        std::vector<std::pair<Point, Point>> m_node_neighbors;             //!< Previous and next corner of each node
+        std::vector<std::vector<std::pair<unsigned int, double>>> m_edges;  //!< (node, length) per node
+        std::vector<Point> m_locations;
+        std::vector<bool> m_location_free;
+        std::vector<bool> m_location_connected;
+        std::vector<std::vector<std::pair<unsigned int, double>>> m_location_edges;  //!< (node, length) per location
+    };
+}  // namespace grstaps
+
+#endif  // GRSTAPS_VISIBILITY_GRAPH_HPP
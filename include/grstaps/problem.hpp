@@ -89,7 +89,6 @@ namespace grstaps
 
        protected:
         std::vector<b2PolygonShape> convertBuildingsAndStreetsToPolygons1(const nlohmann::json& buildings, const nlohmann::json& streets);
-        ClipperLib2::Paths convertBuildingsAndStreetsToPolygons2(const nlohmann::json& buildings, const nlohmann::json& streets);
 
         std::vector<Location> m_locations;  //!< coordinates and name of location
         std::map<std::string, std::pair<unsigned int, unsigned int>>
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2020 Andrew Messing
+ *
+ * grstaps is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 3 of the License,
+ * or any later version.
+ *
+ * grstaps is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with grstaps; if not, write to the Free Software Foundation,
+ * Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef GRSTAPS_PROFILER_HPP
+#define GRSTAPS_PROFILER_HPP
+
+// global
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// external
+#include <nlohmann/json.hpp>
+
+namespace grstaps
+{
+    //! Phases of the solve whose time is measured
+    enum class ProfileZone : unsigned int
+    {
+        TaskPlannerExpand,
+        TaskPlannerEvaluate,
+        MemoLookup,
+        AllocationExpand,
+        Schedule,
+        Tabu,
+        BranchAndBound,
+        MotionPlanningQuery,
+        NumZones
+    };
+
+    //! Events that are only counted
+    enum class ProfileCounter : unsigned int
+    {
+        MemoRepeatedState,
+        MotionPlanningCacheHit,
+        MotionPlanningCacheMiss,
+        PlanPrescreenRejected,
+        NumCounters
+    };
+
+    /**
+     * \brief Per-phase timing and event counters
+     *
+     * Each thread accumulates into its own counters, which are merged when the results are collected. The
+     * instrumentation points use the GRSTAPS_PROFILE_* macros, which compile to nothing unless GRSTAPS_PROFILING is
+     * defined (cmake -DENABLE_PROFILING=ON)
+     */
+    class Profiler
+    {
+       public:
+#ifdef GRSTAPS_PROFILING
+        static constexpr bool enabled = true;
+#else
+        static constexpr bool enabled = false;
+#endif
+
+        /**
+         * Adds a call to a zone
+         *
+         * \param zone The zone
+         * \param nanoseconds The time spent in the call
+         */
+        static void record(ProfileZone zone, uint64_t nanoseconds);
+
+        /**
+         * Increments an event counter
+         */
+        static void count(ProfileCounter counter, uint64_t n = 1);
+
+        /**
+         * \returns The counters of all the threads merged as json
+         */
+        static nlohmann::json collect();
+
+        /**
+         * Sets all the counters to zero
+         */
+        static void reset();
+
+        //! Counters of one thread (defined in profiler.cpp)
+        struct ThreadData;
+
+       private:
+        static ThreadData& local();
+
+        Profiler() = default;
+    };
+
+    /**
+     * \brief Records the time between its construction and destruction in a zone
+     */
+    class ScopedZone
+    {
+       public:
+        explicit ScopedZone(ProfileZone zone)
+            : m_zone(zone)
+            , m_start(std::chrono::steady_clock::now())
+        {}
+
+        ~ScopedZone()
+        {
+            auto elapsed = std::chrono::steady_clock::now() - m_start;
+            Profiler::record(m_zone, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+
+        ScopedZone(const ScopedZone&) = delete;
+        ScopedZone& operator=(const ScopedZone&) = delete;
+
+       private:
+        ProfileZone m_zone;
+        std::chrono::steady_clock::time_point m_start;
+    };
+}  // namespace grstaps
+
+#ifdef GRSTAPS_PROFILING
+#define GRSTAPS_PROFILE_CONCAT_IMPL(a, b) a##b
+#define GRSTAPS_PROFILE_CONCAT(a, b) GRSTAPS_PROFILE_CONCAT_IMPL(a, b)
+#define GRSTAPS_PROFILE_ZONE(zone) \
+    ::grstaps::ScopedZone GRSTAPS_PROFILE_CONCAT(grstaps_profile_zone_, __LINE__)(::grstaps::ProfileZone::zone)
+#define GRSTAPS_PROFILE_COUNT(counter) ::grstaps::Profiler::count(::grstaps::ProfileCounter::counter)
+#else
+#define GRSTAPS_PROFILE_ZONE(zone) ((void)0)
+#define GRSTAPS_PROFILE_COUNT(counter) ((void)0)
+#endif
+
+#endif  // GRSTAPS_PROFILER_HPP
@@ -9,8 +9,12 @@ namespace grstaps
     class SolverFcpop
     {
        public:
+        //! \param num_threads More than one runs the parallel best-first task planner
+        explicit SolverFcpop(unsigned int num_threads = 1);
+
         nlohmann::json solve(const std::string& domain_filepath, const std::string& problem_filepath);
        private:
+        unsigned int m_num_threads;
         unsigned int m_tp_nodes_expanded;
         unsigned int m_tp_nodes_visited;
     };
@@ -1,6 +1,8 @@
 #ifndef GRSTAPS_GROUNDER_HPP
 #define GRSTAPS_GROUNDER_HPP
 
+#include <../lib/unordered_map/robin_hood.h>
+
 #include "grstaps/task_planning/grounded_task.hpp"
 #include "grstaps/task_planning/preprocessed_task.hpp"
 
@@ -26,6 +28,13 @@ namespace grstaps
         std::vector<unsigned int> *paramValues;
         std::vector<unsigned int> *compatibleObjectsWithParam;
         unsigned int newValueIndex;
+        unsigned int nameId;                      // Operators with the same name share this id
+        unsigned int currentValue;                // Position in newValues of the value being matched
+        unsigned int nextMatch;                   // First match not grounded yet
+        std::vector<unsigned int> matchedValue;   // Position in newValues of the value that originated each match
+        std::vector<unsigned int> matchedParams;  // Parameters of the matches found (numParams per match)
+        std::vector<unsigned int> requiredFunctions;  // Functions in the preconditions, without repetitions
+        std::vector<unsigned int> valuePositions;     // Buffer for the positions in newValues to match
         std::vector<GrounderAssignment> preconditions;
         void initialize(Operator &o);
         ~GrounderOperator();
@@ -48,6 +57,18 @@ namespace grstaps
         float numericValue;
     };
 
+    // Hash of an integer tuple (function or action name id followed by the parameter ids)
+    class GrounderKeyHash
+    {
+       public:
+        inline size_t operator()(const std::vector<unsigned int> &key) const
+        {
+            return robin_hood::hash_bytes(key.data(), key.size() * sizeof(unsigned int));
+        }
+    };
+
+    typedef robin_hood::unordered_map<std::vector<unsigned int>, unsigned int, GrounderKeyHash> GrounderIndex;
+
     class Grounder
     {
        private:
@@ -57,18 +78,21 @@ namespace grstaps
         unsigned int numOps;
         GrounderOperator *ops;
         std::vector<GrounderOperator *> *opRequireFunction;
-        std::unordered_map<std::string, unsigned int> variableIndex;
+        GrounderIndex variableIndex;
         std::unordered_map<std::string, unsigned int> preferenceIndex;
         std::vector<ProgrammedValue> *newValues;
         std::vector<ProgrammedValue> *auxValues;
         std::vector<ProgrammedValue> *valuesByFunction;
-        std::unordered_map<std::string, unsigned int> groundedActions;
+        std::vector<std::vector<unsigned int>> newValuesByFunction;  // function -> positions in newValues
+        GrounderIndex groundedActions;
+        std::vector<unsigned int> key;  // Buffer for the variable and action keys
         unsigned int numValues;
         unsigned int startNewValues;
         unsigned int currentLevel;
 
-        std::string getVariableName(unsigned int function, const std::vector<unsigned int> &parameters);
-        std::string getVariableName(const Literal &l, const std::vector<unsigned int> &opParameters);
+        const std::vector<unsigned int> &getVariableKey(unsigned int function,
+                                                        const std::vector<unsigned int> &parameters);
+        const std::vector<unsigned int> &getVariableKey(const Literal &l, const std::vector<unsigned int> &opParameters);
         void initTypesMatrix();
         void clearMemory();
         void addTypeToMatrix(unsigned int typeIndex, unsigned int subtypeIndex);
@@ -79,9 +103,10 @@ namespace grstaps
         unsigned int getVariableIndex(const Fact &f);
         unsigned int getVariableIndex(const Literal &l, const std::vector<unsigned int> &opParameters);
         void groundRemainingParameters(GrounderOperator &op);
-        void groundAction(GrounderOperator &op);
+        void groundAction(GrounderOperator &op, const unsigned int *parameters);
+        void groundMatches(GrounderOperator &op, unsigned int value);
         bool objectIsCompatible(unsigned int objIndex, std::vector<unsigned int> &types);
-        void match(ProgrammedValue &pv);
+        void matchOperator(GrounderOperator &op);
         void swapLevels();
         int matches(GrounderOperator *op, unsigned int varIndex, unsigned int valueIndex, int startPrec);
         void stackParameters(GrounderOperator *op, int precIndex, unsigned int varIndex, unsigned int valueIndex);
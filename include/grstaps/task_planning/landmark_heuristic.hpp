@@ -10,6 +10,8 @@ namespace grstaps
 {
     class LandmarkNode;
 
+    class Plan;
+
     class SASAction;
 
     class SASTask;
@@ -23,7 +25,7 @@ namespace grstaps
         std::vector<TValue> values;
         std::vector<LandmarkCheck*> prev;
         std::vector<LandmarkCheck*> next;
-        bool checked;
+        unsigned int index;  // Position in the achieved landmarks bitset
         bool single;
 
     public:
@@ -43,19 +45,26 @@ namespace grstaps
 
         bool isInitialState(TState* state);
 
-        inline void uncheck()
+        bool isAchievedBy(SASAction* a) const;
+
+        inline void setIndex(unsigned int index)
+        {
+            this->index = index;
+        }
+
+        inline unsigned int getIndex() const
         {
-            checked = false;
+            return index;
         }
 
-        inline void check()
+        inline bool isChecked(const uint64_t* achieved) const
         {
-            checked = true;
+            return (achieved[index >> 6] >> (index & 63)) & 1;
         }
 
-        inline bool isChecked() const
+        inline void check(uint64_t* achieved) const
         {
-            return checked;
+            achieved[index >> 6] |= 1ULL << (index & 63);
         }
 
         inline bool isSingle() const
@@ -96,17 +105,24 @@ namespace grstaps
         std::string toString(SASTask* task, bool showNext);
     };
 
+    // The landmarks achieved by a plan are stored in the plan as a bitset, computed from the bitset of its parent
+    // and the effects of the new action. The heuristic has no state that changes during the search, so it can be
+    // evaluated concurrently
+
     class LandmarkHeuristic
     {        // Landmarks heuristic
     private:
         SASTask* task;
         std::vector<LandmarkCheck*> nodes;
         std::vector<LandmarkCheck*> rootNodes;
+        unsigned int numWords;  // Size of the achieved landmarks bitsets
 
         void addRootNode(LandmarkCheck* n, TState* state, std::vector<LandmarkCheck*>* toDelete);
 
         bool hasRootPredecessor(LandmarkCheck* n);
 
+        void progress(uint64_t* achieved, SASAction* a, TState* state) const;
+
     public:
         LandmarkHeuristic();
 
@@ -116,11 +132,8 @@ namespace grstaps
 
         void initialize(TState* state, SASTask* task, std::vector<SASAction*>* tilActions);
 
-        void uncheckNodes();
-
-        uint16_t evaluate();
-
-        void copyRootNodes(std::vector<LandmarkCheck*>* v);
+        // Returns a new bitset with the landmarks achieved by the plan, whose frontier state is given
+        uint64_t* computeAchievedLandmarks(Plan* p, TState* state) const;
 
         std::string toString(SASTask* task);
 
@@ -129,15 +142,12 @@ namespace grstaps
             return nodes.size();
         }
 
-        inline uint16_t countUncheckedNodes() const
+        inline uint16_t countUncheckedNodes(const uint64_t* achieved) const
         {
-            uint16_t n = 0;
-            for(unsigned int i = 0; i < nodes.size(); i++)
+            uint16_t n = nodes.size();
+            for(unsigned int i = 0; i < numWords; i++)
             {
-                if(!nodes[i]->isChecked())
-                {
-                    n++;
-                }
+                n -= __builtin_popcountll(achieved[i]);
             }
             return n;
         }
@@ -12,9 +12,6 @@
 
 namespace grstaps
 {
-    class LandmarkCheck;
-
-    class LandmarkHeuristic;
     class TState;
 
 #define INITAL_MATRIX_SIZE    400
@@ -77,7 +74,6 @@ namespace grstaps
         unsigned int iteration;                                // Current iteration
         double* time;                                        // Starting time of each time step (for computing the frontier state)
         double* duration;                                    // Duration of the actions in the plan
-        std::vector<LandmarkCheck*> openNodes;                // For hLand calculation
         TState* initialState;
         std::unordered_map<double, TTimePoint> numericMutex;
         PriorityQueue pq;
@@ -104,10 +100,6 @@ namespace grstaps
         //bool checkActionDelayNeeded();
         bool checkTopologicalOrder(std::vector<TTimePoint>* linearOrder);
 
-        void initializeOpenNodes(LandmarkHeuristic* hLand);
-
-        bool findOpenNode(LandmarkCheck* l);
-
         bool checkNumericMutexWithStartPoint(TTimePoint p, TTimePoint prev, SASAction* a);
 
         void initialPlanSchedule(std::vector<TTimePoint>* linearOrder, unsigned int numTimeSteps);
@@ -134,8 +126,6 @@ namespace grstaps
 
         void checkUnsatisfiedConditions(double currentTime, TState* state, std::vector<TTimePoint>* unsatisfiedNumCond);
 
-        void computeAchievedLandmarks(unsigned int numTimeSteps, LandmarkHeuristic* hLand);
-
         inline SASAction* getAction(TStep step)
         {
             return step < basePlanComponents.size() ? basePlanComponents[step]->action : plan->action;
@@ -226,9 +216,9 @@ namespace grstaps
 
         void topologicalOrder(std::vector<TTimePoint>* linearOrder);
 
-        TState* linearize(unsigned int numActions, unsigned int numTimeSteps, SASTask* task, LandmarkHeuristic* hLand);
+        TState* linearize(unsigned int numActions, unsigned int numTimeSteps, SASTask* task);
 
-        TState* getFrontierState(SASTask* task, LandmarkHeuristic* hLand); //, double* timeNewStep);
+        TState* getFrontierState(SASTask* task); //, double* timeNewStep);
         std::string planToPDDL(Plan* p, SASTask* task);
         nlohmann::json scheduleAsJson(Plan* p, SASTask* task);
     };
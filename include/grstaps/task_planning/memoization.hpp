@@ -1,9 +1,12 @@
 #ifndef GRSTAPS_MEMOIZATION_HPP
 #define GRSTAPS_MEMOIZATION_HPP
 
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include "grstaps/task_planning/linearizer.hpp"
+#include "grstaps/task_planning/packed_state.hpp"
 
 namespace grstaps
 {
@@ -11,15 +14,25 @@ namespace grstaps
     class SASTask;
     class TState;
 
+    class MemoEntry
+    {
+    public:
+        Plan* plan;             // nullptr for the initial state
+        PackedState state;      // Frontier state of the plan
+
+        MemoEntry(Plan* p, PackedState s)
+            : plan(p)
+            , state(s)
+        {}
+    };
+
     class Memoization
     {
     private:
         SASTask* task;
         TState* initialState;
-        std::unordered_map<uint64_t, std::vector<Plan*>*> memo;
-        Linearizer linearizer;
-
-        bool sameState(TState* state, Plan* pc);
+        std::unordered_map<uint64_t, std::vector<MemoEntry>*> memo;
+        PackedStatePool pool;   // Frontier states are stored packed so collisions are solved without linearizing
 
     public:
         Memoization();
@@ -29,6 +42,27 @@ namespace grstaps
         bool isRepeatedState(Plan* p, TState* state);
 
         void clear();
+
+        ~Memoization();
+    };
+
+    // Memoization shared by several successor generators. States are distributed among independently
+    // locked shards according to their hash code
+    class ConcurrentMemoization
+    {
+    private:
+        unsigned int numShards;
+        std::unique_ptr<Memoization[]> shards;
+        std::unique_ptr<std::mutex[]> locks;
+
+    public:
+        ConcurrentMemoization();
+
+        void initialize(SASTask* task, unsigned int numShards);
+
+        bool isRepeatedState(Plan* p, TState* state);
+
+        void clear();
     };
 }
 #endif //GRSTAPS_MEMOIZATION_HPP
@@ -0,0 +1,84 @@
+#ifndef GRSTAPS_MUTEX_MATRIX_HPP
+#define GRSTAPS_MUTEX_MATRIX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <../lib/unordered_map/robin_hood.h>
+
+// A dense matrix is always used below this size
+#define MUTEX_MATRIX_MIN_DENSE_BYTES (1UL << 22)
+// A dense matrix is never used above this size
+#define MUTEX_MATRIX_MAX_DENSE_BYTES (1UL << 26)
+// Approximate memory used by each pair in the sparse representation
+#define MUTEX_MATRIX_BYTES_PER_PAIR 32
+
+namespace grstaps
+{
+    // Binary relation over [0, size) x [0, size). It is stored as a cache-aligned bit matrix, unless it is
+    // large and sparse enough to be stored as a hash set of pairs
+    class MutexMatrix
+    {
+       private:
+        unsigned int size;
+        size_t rowWords;  // Words per row, rounded up to a full cache line
+        uint64_t* bits;   // nullptr if the sparse representation is used
+        robin_hood::unordered_flat_set<uint64_t> pairs;
+
+        inline static uint64_t getCode(unsigned int i, unsigned int j)
+        {
+            return (((uint64_t)i) << 32) + j;
+        }
+
+       public:
+        MutexMatrix();
+        ~MutexMatrix();
+        MutexMatrix(const MutexMatrix&) = delete;
+        MutexMatrix& operator=(const MutexMatrix&) = delete;
+
+        // Removes all pairs and selects the representation according to the expected number of pairs
+        void initialize(unsigned int size, size_t expectedPairs);
+        void clear();
+
+        // Appends the pairs (i << 32) + j in the relation to the given vector, sorted in increasing order
+        void getPairs(std::vector<uint64_t>* codes) const;
+
+        inline bool isDense() const
+        {
+            return bits != nullptr;
+        }
+
+        inline unsigned int getSize() const
+        {
+            return size;
+        }
+
+        inline void set(unsigned int i, unsigned int j)
+        {
+            if(bits != nullptr)
+            {
+                bits[i * rowWords + (j >> 6)] |= 1ULL << (j & 63);
+            }
+            else
+            {
+                pairs.insert(getCode(i, j));
+            }
+        }
+
+        inline bool get(unsigned int i, unsigned int j) const
+        {
+            if(i >= size || j >= size)
+            {
+                return false;
+            }
+            if(bits != nullptr)
+            {
+                return (bits[i * rowWords + (j >> 6)] >> (j & 63)) & 1;
+            }
+            return pairs.find(getCode(i, j)) != pairs.end();
+        }
+    };
+}  // namespace grstaps
+
+#endif  // GRSTAPS_MUTEX_MATRIX_HPP
@@ -0,0 +1,225 @@
+#ifndef GRSTAPS_PACKED_STATE_HPP
+#define GRSTAPS_PACKED_STATE_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <../lib/unordered_map/robin_hood.h>
+
+#include "grstaps/task_planning/sas_task.hpp"
+#include "grstaps/task_planning/utils.hpp"
+
+namespace grstaps
+{
+    class TState;
+
+#define PACKED_STATE_BLOCK_SIZE 1024
+
+    // Describes how the variables of a task are packed into 64-bit words. Each SAS variable takes
+    // ceil(log2(domain size)) bits and never straddles two words. Numeric variables are stored after
+    // the SAS words, two floats per word
+    class PackedStateLayout
+    {
+    public:
+        unsigned int numSASVars;            // Number of SAS variables
+        unsigned int numNumVars;            // Number of numeric variables
+        unsigned int numSASWords;           // Words used by the SAS variables
+        unsigned int numWords;              // Words per state (SAS + numeric + padding to an even number)
+        std::vector<uint16_t> word;         // var -> word where the variable is stored
+        std::vector<uint8_t> shift;         // var -> bit position inside the word
+        std::vector<uint64_t> mask;         // var -> mask of the variable bits (not shifted)
+        std::vector<TValue> minValue;       // var -> lowest value in the domain of the variable
+        std::vector<uint32_t> codeRange;    // var -> highest - lowest value in the domain + 1
+        std::vector<uint32_t> codeOffset;   // var -> position of the variable in localCode
+        std::vector<uint64_t> outOfRange;   // var -> code of MAX_UINT16 (undefined), or mask + 1 if not in the domain
+        std::vector<uint64_t> localCode;    // codeOffset[var] + value - minValue[var] -> code in the domain
+        std::vector<uint32_t> valueOffset;  // var -> position of the variable in globalValue
+        std::vector<TValue> globalValue;    // valueOffset[var] + code -> value
+
+        PackedStateLayout();
+
+        void initialize(SASTask* task);
+
+        inline uint64_t encode(TVariable var, TValue value) const
+        {
+            uint32_t index = (uint32_t)value - minValue[var];
+            return index < codeRange[var] ? localCode[codeOffset[var] + index] : outOfRange[var];
+        }
+
+        inline TValue decode(TVariable var, uint64_t code) const
+        {
+            return globalValue[valueOffset[var] + code];
+        }
+
+        // Code of a value stored in a state. The domain holds every value a state can take, so an
+        // out-of-domain value is a bug; it is masked so it can never spill into the bits of the next variable
+        inline uint64_t encodeShifted(TVariable var, TValue value) const
+        {
+            uint64_t code = encode(var, value);
+            assert(code <= mask[var]);
+            return (code & mask[var]) << shift[var];
+        }
+    };
+
+    // Compact state. The words are owned by the PackedStatePool that created the state
+    class PackedState
+    {
+    public:
+        const PackedStateLayout* layout;
+        uint64_t* words;
+
+        PackedState()
+            : layout(nullptr)
+            , words(nullptr)
+        {}
+
+        PackedState(const PackedStateLayout* layout, uint64_t* words)
+            : layout(layout)
+            , words(words)
+        {}
+
+        inline bool isNull() const
+        {
+            return words == nullptr;
+        }
+
+        inline TValue getSASValue(TVariable var) const
+        {
+            return layout->decode(var, (words[layout->word[var]] >> layout->shift[var]) & layout->mask[var]);
+        }
+
+        inline void setSASValue(TVariable var, TValue value)
+        {
+            uint64_t& w = words[layout->word[var]];
+            w           = (w & ~(layout->mask[var] << layout->shift[var])) | layout->encodeShifted(var, value);
+        }
+
+        inline float getNumValue(TVariable var) const
+        {
+            float value;
+            std::memcpy(&value, reinterpret_cast<const uint32_t*>(words + layout->numSASWords) + var, sizeof(float));
+            return value;
+        }
+
+        inline void setNumValue(TVariable var, float value)
+        {
+            if(value == 0)
+            {
+                value = 0;  // -0.0 and 0.0 must have the same bits
+            }
+            std::memcpy(reinterpret_cast<uint32_t*>(words + layout->numSASWords) + var, &value, sizeof(float));
+        }
+
+        // Compares the encoded condition against the word where the variable is stored, without decoding it
+        inline bool holdsCondition(const SASCondition* c) const
+        {
+            return ((words[layout->word[c->var]] >> layout->shift[c->var]) & layout->mask[c->var]) ==
+                   layout->encode(c->var, c->value);
+        }
+
+        inline bool holdsConditions(const std::vector<SASCondition>& c) const
+        {
+            for(unsigned int i = 0; i < c.size(); i++)
+            {
+                if(!holdsCondition(&(c[i])))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        inline bool isExecutable(const SASAction* a) const
+        {
+            return holdsConditions(a->startCond) && holdsConditions(a->overCond) && holdsConditions(a->endCond);
+        }
+
+        inline uint64_t getCode() const
+        {
+            return robin_hood::hash_bytes(words, layout->numWords * sizeof(uint64_t));
+        }
+
+        inline bool compareTo(const PackedState& s) const
+        {
+            return equalWords(words, s.words, layout->numWords);
+        }
+
+        void unpack(TState* s) const;
+
+        static inline bool equalWords(const uint64_t* w1, const uint64_t* w2, unsigned int numWords)
+        {
+            unsigned int i = 0;
+#if defined(__AVX2__)
+            for(; i + 4 <= numWords; i += 4)
+            {
+                __m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(w1 + i)),
+                                             _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w2 + i)));
+                if(!_mm256_testz_si256(x, x))
+                {
+                    return false;
+                }
+            }
+#endif
+#if defined(__SSE2__)
+            for(; i + 2 <= numWords; i += 2)
+            {
+                __m128i x = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(w1 + i)),
+                                           _mm_loadu_si128(reinterpret_cast<const __m128i*>(w2 + i)));
+                if(_mm_movemask_epi8(x) != 0xFFFF)
+                {
+                    return false;
+                }
+            }
+#endif
+            for(; i < numWords; i++)
+            {
+                if(w1[i] != w2[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    // Allocates the words of the packed states in blocks of PACKED_STATE_BLOCK_SIZE states, reusing the
+    // released ones
+    class PackedStatePool
+    {
+    private:
+        PackedStateLayout layout;
+        std::vector<uint64_t*> blocks;
+        std::vector<uint64_t*> freeStates;
+        unsigned int usedInBlock;
+
+        uint64_t* allocate();
+
+    public:
+        PackedStatePool();
+
+        ~PackedStatePool();
+
+        void initialize(SASTask* task);
+
+        inline const PackedStateLayout* getLayout() const
+        {
+            return &layout;
+        }
+
+        PackedState pack(TState* s);
+
+        PackedState copy(const PackedState& s);
+
+        void release(PackedState& s);
+
+        void clear();
+    };
+}  // namespace grstaps
+
+#endif  // GRSTAPS_PACKED_STATE_HPP
@@ -36,6 +36,7 @@ namespace grstaps
         float h;
         float hAux;
         uint16_t hLand;
+        uint64_t* achievedLandmarks;            // Bitset of the landmarks achieved by the plan (nullptr if not evaluated)
         uint16_t g;
         uint32_t id;
         bool task_allocatable;
@@ -14,6 +14,7 @@ namespace grstaps
         bool noSAS;
         bool generateMutexFile;
         bool generateTrace;
+        const char *cacheDirectory;  // Directory of the SAS task snapshots (GRSTAPS_TASK_CACHE if nullptr)
         PlannerParameters()
             : total_time(0)
             , domainFileName(nullptr)
@@ -24,6 +25,7 @@ namespace grstaps
             , noSAS(false)
             , generateMutexFile(false)
             , generateTrace(false)
+            , cacheDirectory(nullptr)
         {}
     };
 }  // namespace grstaps
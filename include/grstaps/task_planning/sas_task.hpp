@@ -6,6 +6,7 @@
 #include <vector>
 #include <unordered_map>
 
+#include "grstaps/task_planning/mutex_matrix.hpp"
 #include "grstaps/task_planning/utils.hpp"
 
 namespace grstaps
@@ -194,10 +195,16 @@ namespace grstaps
     class SASTask
     {
     private:
-        std::unordered_map<TMutex, bool> mutex;
+        std::vector<TMutex> mutexCodes;          // Mutex pairs added before building the mutex matrices
+        std::vector<TValue> fluentMinValue;      // var -> lowest value with a fluent id
+        std::vector<uint32_t> fluentValueRange;  // var -> highest - lowest value + 1
+        std::vector<uint32_t> fluentOffset;      // var -> fluent id of (var, fluentMinValue[var])
+        unsigned int numFluents;
+        MutexMatrix mutex;                       // fluent x fluent
         std::unordered_map<TVarValue, std::vector<TVarValue>*> mutexWithVarValue;
-        std::unordered_map<TMutex, bool> permanentMutex;
-        std::unordered_map<TMutex, bool> permanentMutexActions;
+        MutexMatrix permanentMutex;              // fluent x fluent
+        MutexMatrix permanentMutexActions;       // action x action
+        bool hasPermanentMutexActions;
         std::unordered_map<std::string, unsigned int> valuesByName;
         std::vector<TVarValue> goalList;
         bool* staticNumFunctions;
@@ -223,12 +230,14 @@ namespace grstaps
 
         void updateNumericState(float* s, SASNumericEffect* e, float duration);
 
-        bool checkActionMutex(SASAction* a1, SASAction* a2);
-
         bool checkActionOrdering(SASAction* a1, SASAction* a2);
 
+        void computeFluentIds();
+
         void computeMutexWithVarValues();
 
+        void computePermanentMutexActions(std::vector<std::vector<TVarValue>>& partners);
+
         void checkReachability(TVarValue vv, std::unordered_map<TVarValue, bool>* goals);
 
         void checkEffectReached(SASCondition* c,
@@ -238,6 +247,8 @@ namespace grstaps
 
         void addGoalToList(SASCondition* c);
 
+        friend class SASTaskCache;
+
     public:
         static const unsigned int OBJECT_TRUE = 0;
         static const unsigned int OBJECT_FALSE = 1;
@@ -266,13 +277,45 @@ namespace grstaps
 
         ~SASTask();
 
+        static constexpr uint32_t NO_FLUENT = MAX_UNSIGNED_INT;
+
         void addMutex(unsigned int var1, unsigned int value1, unsigned int var2, unsigned int value2);
 
-        bool isMutex(unsigned int var1, unsigned int value1, unsigned int var2, unsigned int value2);
+        // Flattened (var, value) index used in the mutex matrices. NO_FLUENT if the value never appears in the
+        // task for that variable
+        inline uint32_t getFluentId(unsigned int var, unsigned int value) const
+        {
+            if(var >= fluentOffset.size())
+            {
+                return NO_FLUENT;
+            }
+            uint32_t index = value - fluentMinValue[var];
+            return index < fluentValueRange[var] ? fluentOffset[var] + index : NO_FLUENT;
+        }
 
-        bool isPermanentMutex(unsigned int var1, unsigned int value1, unsigned int var2, unsigned int value2);
+        inline unsigned int getNumFluents() const
+        {
+            return numFluents;
+        }
 
-        bool isPermanentMutex(SASAction* a1, SASAction* a2);
+        // The mutex queries are available once computePermanentMutex has been called
+        inline bool isMutex(unsigned int var1, unsigned int value1, unsigned int var2, unsigned int value2) const
+        {
+            return mutex.get(getFluentId(var1, value1), getFluentId(var2, value2));
+        }
+
+        inline bool isPermanentMutex(unsigned int var1,
+                                     unsigned int value1,
+                                     unsigned int var2,
+                                     unsigned int value2) const
+        {
+            return permanentMutex.get(getFluentId(var1, value1), getFluentId(var2, value2));
+        }
+
+        inline bool isPermanentMutex(SASAction* a1, SASAction* a2) const
+        {
+            return permanentMutexActions.get(a1->index, a2->index);
+        }
 
         SASVariable* createNewVariable();
 
@@ -334,7 +377,7 @@ namespace grstaps
 
         inline bool hasPermanentMutexAction() const
         {
-            return !permanentMutexActions.empty();
+            return hasPermanentMutexActions;
         }
 
         std::vector<TVarValue>* getListOfGoals();
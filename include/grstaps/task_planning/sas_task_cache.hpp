@@ -0,0 +1,127 @@
+#ifndef GRSTAPS_SAS_TASK_CACHE_HPP
+#define GRSTAPS_SAS_TASK_CACHE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "grstaps/task_planning/sas_task.hpp"
+
+// "GRSTSAS" followed by a zero byte
+#define SAS_TASK_CACHE_MAGIC 0x0053415354535247ULL
+// Must be increased whenever the layout of the snapshot or of SASTask changes
+#define SAS_TASK_CACHE_VERSION 1U
+
+namespace grstaps
+{
+    // Binary snapshot of a translated SAS task, including its mutex relations. Snapshots are stored in a directory
+    // and named after a hash of the domain and problem files, so the parsing, preprocessing, grounding and
+    // translation stages can be skipped when the same problem is solved again. Only the data built by the
+    // translator is stored; the initial state, requirers, producers and action costs are recomputed on load
+    class SASTaskCache
+    {
+       private:
+        std::string fileName;  // Empty if the cache is disabled or the input files cannot be read
+        uint64_t key;
+        bool keepStaticData;
+
+        // Writing
+        std::string buffer;
+
+        // Reading
+        const char* pos;
+        const char* end;
+        bool failed;
+
+        static bool hashFile(const char* fileName, uint64_t* hash);
+
+        template <typename T>
+        void write(T value)
+        {
+            buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        void writeVector(const std::vector<T>& v)
+        {
+            write((uint32_t)v.size());
+            buffer.append(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+        }
+
+        void writeString(const std::string& s);
+        void writeExpression(const SASNumericExpression& e);
+        void writeGoalDescription(const SASGoalDescription& g);
+        void writeConditions(const std::vector<SASCondition>& v);
+        void writeNumericConditions(const std::vector<SASNumericCondition>& v);
+        void writeNumericEffects(const std::vector<SASNumericEffect>& v);
+        void writeAction(const SASAction& a);
+        void writeConstraint(const SASConstraint& c);
+        void writeMetric(const SASMetric& m);
+        void writeMutexMatrix(const MutexMatrix& m);
+
+        template <typename T>
+        T read()
+        {
+            T value = T();
+            if(failed || (size_t)(end - pos) < sizeof(T))
+            {
+                failed = true;
+                return value;
+            }
+            std::memcpy(&value, pos, sizeof(T));
+            pos += sizeof(T);
+            return value;
+        }
+
+        // Reads the number of elements of a sequence, checking that at least minBytes per element remain
+        uint32_t readSize(size_t minBytes);
+
+        template <typename T>
+        void readVector(std::vector<T>* v)
+        {
+            uint32_t n = readSize(sizeof(T));
+            v->resize(n);
+            if(n > 0)
+            {
+                std::memcpy(v->data(), pos, n * sizeof(T));
+                pos += n * sizeof(T);
+            }
+        }
+
+        std::string readString();
+        void readExpression(SASNumericExpression* e);
+        void readGoalDescription(SASGoalDescription* g);
+        void readConditions(std::vector<SASCondition>* v);
+        void readNumericConditions(std::vector<SASNumericCondition>* v);
+        void readNumericEffects(std::vector<SASNumericEffect>* v);
+        void readAction(SASAction* a);
+        void readConstraint(SASConstraint* c);
+        void readMetric(SASMetric* m);
+        void readMutexMatrix(MutexMatrix* m, unsigned int size);
+        SASTask* readTask();
+
+       public:
+        // The cache is disabled if directory is nullptr. keepStaticData and noSAS are part of the key, as they
+        // change the translated task
+        SASTaskCache(const char* directory,
+                     const char* domainFileName,
+                     const char* problemFileName,
+                     bool keepStaticData,
+                     bool noSAS);
+
+        inline bool isEnabled() const
+        {
+            return !fileName.empty();
+        }
+
+        // Returns nullptr if there is no valid snapshot for the input files
+        SASTask* load();
+
+        // Writes the snapshot to a temporary file that is renamed once complete, so concurrent readers never see
+        // a partial snapshot
+        bool save(SASTask* task);
+    };
+}  // namespace grstaps
+
+#endif  // GRSTAPS_SAS_TASK_CACHE_HPP
@@ -1,6 +1,9 @@
 #ifndef GRSTAPS_SELECTOR_HPP
 #define GRSTAPS_SELECTOR_HPP
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include "grstaps/task_planning/plan.hpp"
@@ -20,6 +23,8 @@ namespace grstaps
 
         void heapify(unsigned int gap);
 
+        void siftUp(unsigned int gap, Plan* p);
+
        public:
         float best_h;  // For queue alternating
         bool improved_h;
@@ -28,10 +33,17 @@ namespace grstaps
 
         void add(Plan* p);
 
+        unsigned int add(const std::vector<Plan*>& plans);
+
         Plan* poll();
 
         void remove(Plan* p);
 
+        inline bool contains(Plan* p) const
+        {
+            return plan_position.find(p->id) != plan_position.end();
+        }
+
         inline Plan* peek()
         {
             return pq[1];
@@ -55,6 +67,62 @@ namespace grstaps
         }
     };
 
+    // Relaxed priority queue shared by several threads (MultiQueue). Plans are spread among independently locked
+    // search queues; poll takes the better top of two randomly chosen queues, so it returns one of the best plans
+    // but not necessarily the best one
+    class ConcurrentSearchQueue
+    {
+       private:
+        struct alignas(64) Shard
+        {
+            std::mutex lock;
+            SearchQueue queue;
+            std::atomic<Plan*> top;  // Best plan of the queue, readable without the lock
+
+            Shard(int index)
+                : queue(index)
+                , top(nullptr)
+            {}
+        };
+
+        int index;
+        std::vector<std::unique_ptr<Shard>> shards;
+        std::atomic<int> numPlans;
+
+        unsigned int randomShard();
+
+        Shard* lockShard(unsigned int i);
+
+        inline void updateTop(Shard* s)
+        {
+            s->top.store(s->queue.size() > 0 ? s->queue.peek() : nullptr, std::memory_order_release);
+        }
+
+       public:
+        ConcurrentSearchQueue(int index, unsigned int numShards);
+
+        void add(Plan* p);
+
+        unsigned int add(const std::vector<Plan*>& plans);
+
+        // Returns nullptr if all the queues are empty
+        Plan* poll();
+
+        void remove(Plan* p);
+
+        inline int size() const
+        {
+            return numPlans.load(std::memory_order_acquire);
+        }
+
+        inline int getIndex() const
+        {
+            return index;
+        }
+
+        void clear();
+    };
+
     class Selector
     {
        private:
@@ -83,6 +151,8 @@ namespace grstaps
 
         bool add(Plan* p);
 
+        unsigned int add(const std::vector<Plan*>& plans);
+
         void exportTo(Selector* s);
 
         inline bool inPlateau(int plateauStart)
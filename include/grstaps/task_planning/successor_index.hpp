@@ -0,0 +1,82 @@
+#ifndef GRSTAPS_SUCCESSOR_INDEX_HPP
+#define GRSTAPS_SUCCESSOR_INDEX_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "grstaps/task_planning/sas_task.hpp"
+#include "grstaps/task_planning/utils.hpp"
+
+namespace grstaps
+{
+    // Bitset over the grounded actions that only stores its non-zero words
+    class SparseActionBitset
+    {
+    public:
+        std::vector<uint32_t> index;  // Position of the non-zero words
+        std::vector<uint64_t> bits;   // Non-zero words
+
+        void set(unsigned int action);
+    };
+
+    // Precomputed requirer index used to obtain the actions that can be supported by a base plan with
+    // word-parallel operations instead of checking every grounded action
+    class SuccessorIndex
+    {
+    private:
+        unsigned int numActions;
+        unsigned int numWords;                        // Words in a dense action bitset
+        unsigned int numFluents;                      // Number of (var, value) pairs required by some action
+        std::vector<TValue> minValue;                 // var -> lowest required value
+        std::vector<uint32_t> valueRange;             // var -> highest - lowest required value + 1
+        std::vector<uint32_t> fluentOffset;           // var -> position of the variable in fluentId
+        std::vector<uint32_t> fluentId;               // fluentOffset[var] + value - minValue[var] -> fluent
+        std::vector<std::vector<uint32_t>> varFluents; // var -> required fluents of the variable
+        std::vector<SparseActionBitset> requirers;    // fluent -> actions that require it
+        std::vector<SparseActionBitset> varRequirers; // var -> actions with a condition on the variable
+        std::vector<uint64_t> supportedFluents;       // Fluents produced by the root plan
+        std::vector<uint64_t> supportedRequirers;     // For internal calculations
+        std::vector<uint64_t> blocked;                // For internal calculations
+
+    public:
+        static constexpr uint32_t NO_FLUENT = MAX_UNSIGNED_INT;
+
+        SuccessorIndex();
+
+        void initialize(SASTask* task, bool forceAtEndConditions);
+
+        inline uint32_t getFluent(TVariable var, TValue value) const
+        {
+            uint32_t index = (uint32_t)value - minValue[var];
+            return index < valueRange[var] ? fluentId[fluentOffset[var] + index] : NO_FLUENT;
+        }
+
+        // Resets the supported fluents for a new root plan
+        void clearSupportedFluents();
+
+        inline void setSupportedFluent(TVariable var, TValue value)
+        {
+            uint32_t f = getFluent(var, value);
+            if(f != NO_FLUENT)
+            {
+                supportedFluents[f >> 6] |= 1ULL << (f & 63);
+            }
+        }
+
+        inline bool isSupportedFluent(uint32_t f) const
+        {
+            return (supportedFluents[f >> 6] >> (f & 63)) & 1;
+        }
+
+        // Fills candidates with a dense bitset of the actions whose conditions can all be supported by the
+        // fluents set through setSupportedFluent. Returns the number of candidates
+        unsigned int computeCandidates(std::vector<uint64_t>* candidates);
+
+        inline unsigned int getNumWords() const
+        {
+            return numWords;
+        }
+    };
+}  // namespace grstaps
+
+#endif  // GRSTAPS_SUCCESSOR_INDEX_HPP
@@ -1,12 +1,15 @@
 #ifndef GRSTAPS_SUCCESSORS_HPP
 #define GRSTAPS_SUCCESSORS_HPP
 
+#include <atomic>
+#include <mutex>
 #include <vector>
 
 #include "grstaps/task_planning/causal_link.hpp"
 #include "grstaps/task_planning/evaluator.hpp"
 #include "grstaps/task_planning/memoization.hpp"
 #include "grstaps/task_planning/sas_task.hpp"
+#include "grstaps/task_planning/successor_index.hpp"
 #include "grstaps/task_planning/utils.hpp"
 
 namespace grstaps
@@ -101,11 +104,21 @@ namespace grstaps
         Evaluator evaluator;
         // TState* basePlanState;
         Memoization memoization;
+        ConcurrentMemoization* sharedMemoization;  // Used instead of memoization if not nullptr
+        std::atomic<uint32_t>* sharedIdPlan;       // Used instead of idPlan if not nullptr
+        std::mutex* sharedPlansMutex;              // Guards the child plans of the shared search space if not nullptr
         bool filterRepeatedStates;
+        SuccessorIndex successorIndex;            // Requirers index to find the actions supported by the base plan
+        std::vector<uint64_t> candidateActions;   // Bitset of actions that can be supported by the base plan
         std::vector<unsigned int> checkedAction;
         unsigned int currentIteration;
         bool helpfulActions;
 
+        inline uint32_t nextPlanId()
+        {
+            return sharedIdPlan != nullptr ? ++(*sharedIdPlan) : ++idPlan;
+        }
+
         inline bool visitedAction(SASAction* a)
         {
             return checkedAction[a->index] == currentIteration;
@@ -244,6 +257,8 @@ namespace grstaps
 
         ~Successors();
 
+        void share(ConcurrentMemoization* memo, std::atomic<uint32_t>* planCounter, std::mutex* plansMutex);
+
         void computeSuccessors(Plan* base, std::vector<Plan*>* suc);
 
         void computeSuccessorsConcurrent(Plan* base, std::vector<Plan*>* suc);
@@ -1,9 +1,11 @@
 #ifndef GRSTAPS_SYNTAX_ANALYZER_HPP
 #define GRSTAPS_SYNTAX_ANALYZER_HPP
+#include <deque>
 #include <string>
+#include <string_view>
 #include <vector>
 
-#include <unordered_map>
+#include <../lib/unordered_map/robin_hood.h>
 
 namespace grstaps
 {
@@ -236,7 +238,7 @@ namespace grstaps
     {
        public:
         Symbol symbol;
-        std::string description;
+        const std::string& description;  // Interned in the syntax analyzer (empty for symbols without text)
         float value;
         Token(Symbol s);
         Token(float v);
@@ -244,19 +246,52 @@ namespace grstaps
         std::string toString();
     };
 
+    // Identifier found in a file. Each different identifier is stored only once
+    class SymbolEntry
+    {
+       public:
+        Symbol symbol;
+        std::string name;
+        SymbolEntry(Symbol s, std::string_view n);
+    };
+
+    class SymbolNameHash
+    {
+       public:
+        inline size_t operator()(std::string_view name) const
+        {
+            return robin_hood::hash_bytes(name.data(), name.size());
+        }
+    };
+
+    // Splits a file into tokens. The file is memory-mapped and scanned in place: the identifiers are interned
+    // (each different one is lowercased and copied once) and the tokens only reference the interned names
     class SyntaxAnalyzer
     {
        private:
         const char* fileName;
-        char* buffer;
+        const char* buffer;
+        void* mappedBuffer;        // nullptr if the file could not be mapped
+        size_t mappedLength;
+        std::string fileContents;  // Used if the file could not be mapped
         int lineNumber;
         int position;
         int bufferLength;
         std::vector<Token*> tokens;
-        std::unordered_map<std::string, Symbol> symbols;
+        std::deque<Token> tokenPool;
+        std::deque<SymbolEntry> symbolEntries;
+        robin_hood::unordered_flat_map<std::string_view, SymbolEntry*, SymbolNameHash> symbols;
+        std::string loweredName;  // Buffer to lowercase the identifiers with capital letters
+        void loadFile();
+        SymbolEntry* intern(std::string_view name);
         void skipSpaces();
         Token* matchToken();
         bool matchNumber(float* value);
+        inline char charAt(int pos)
+        {
+            char c = buffer[pos];
+            return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+        }
 
        public:
         int tokenIndex;
@@ -25,10 +25,11 @@ namespace grstaps
         , Noncopyable
     {
        public:
-        TaskPlanner(SASTask* m_task, float m_timeout = -1.0f, bool trace = false);
+        TaskPlanner(SASTask* m_task, float m_timeout = -1.0f, bool trace = false, unsigned int numThreads = 1);
         Plan* poll();
         std::vector<Plan*> getNextSuccessors(Plan* base);
-        void update(Plan* base, std::vector<Plan*>& successors);
+        // Adds a batch of successors of the base plan to the open list. Returns the number of plans added
+        unsigned int update(Plan* base, std::vector<Plan*>& successors);
         bool emptySearchSpace();
         void writeTrace(std::ostream& f, Plan* p);
         std::string planToPDDL(Plan* p);
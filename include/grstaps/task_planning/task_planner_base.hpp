@@ -3,6 +3,7 @@
 
 #include <time.h>
 
+#include "grstaps/trace_sink.hpp"
 #include "grstaps/task_planning/plan.hpp"
 #include "grstaps/task_planning/plateau.hpp"
 #include "grstaps/task_planning/sas_task.hpp"
@@ -40,6 +41,7 @@ namespace grstaps
         bool generateTrace;
         TaskPlannerBase* parentPlanner;
         unsigned int expandedNodes;
+        unsigned int visitedNodes;  // Successor plans generated by the expansions
         Successors* successors;
         std::vector<SASAction*>* tilActions;
         float initialH;
@@ -50,7 +52,8 @@ namespace grstaps
         float timeout;
         clock_t startTime;
 
-        void writeTrace(std::ofstream& f, Plan* p);
+        void writeTrace(std::ostream& f, Plan* p);
+        void writeTrace(TraceSink& sink, Plan* p);
         Plan* createInitialPlan(TState* s);
         void addFrontierNodes(Plan* p);
         void calculateDeadlines();
@@ -72,13 +75,17 @@ namespace grstaps
         std::string planToPDDL(Plan* p);
         virtual Plan* searchStep()                                      = 0;
         virtual std::vector<Plan*> getNextSuccessors(Plan* base)        = 0;
-        virtual void update(Plan* base, std::vector<Plan*>& successors) = 0;
+        virtual unsigned int update(Plan* base, std::vector<Plan*>& successors) = 0;
         virtual bool emptySearchSpace()                                 = 0;
         virtual Plan* poll()                                            = 0;
         unsigned int getExpandedNodes()
         {
             return expandedNodes;
         }
+        unsigned int getVisitedNodes()
+        {
+            return visitedNodes;
+        }
         Plan* improveSolution(uint16_t bestG, float bestGC, bool first);
     };
 }  // namespace grstaps
@@ -32,7 +32,7 @@ namespace grstaps
         Plan* searchStep() override;
         bool emptySearchSpace() override;
         Plan* poll() override;
-        void update(Plan* base, std::vector<Plan*>& successors) override;
+        unsigned int update(Plan* base, std::vector<Plan*>& successors) override;
         std::vector<Plan*> getNextSuccessors(Plan* base) override;
     };
 }  // namespace grstaps
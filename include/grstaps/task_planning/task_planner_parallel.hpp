@@ -0,0 +1,59 @@
+#ifndef TASK_PLANNER_PARALLEL_HPP
+#define TASK_PLANNER_PARALLEL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "grstaps/task_planning/task_planner_base.hpp"
+
+namespace grstaps
+{
+    // k-parallel best-first search: several worker threads poll plans from a shared selector and expand
+    // them concurrently, each one with its own successor generator. Repeated states are filtered through
+    // a shared memoization table and the plan ids are taken from a shared counter
+    class TaskPlannerParallel : public TaskPlannerBase
+    {
+       private:
+        Plan* initialPlan;
+        Selector* sel;
+        unsigned int numThreads;
+        std::vector<Successors*> workers;  // workers[0] is the successor generator of the base planner
+        ConcurrentMemoization memoization;
+        std::atomic<uint32_t> planCounter;
+        std::mutex selectorMutex;  // Protects sel, solution, the node counters and the children of the plans
+        std::condition_variable selectorChanged;
+        unsigned int activeWorkers;
+        bool finished;
+        std::chrono::steady_clock::time_point wallStartTime;
+
+        void addInitialPlansToSelector();
+        void work(unsigned int worker);
+        bool wallTimeExceed();
+
+       public:
+        TaskPlannerParallel(SASTask* task,
+                            Plan* initialPlan,
+                            TState* initialState,
+                            bool forceAtEndConditions,
+                            bool filterRepeatedStates,
+                            bool generateTrace,
+                            std::vector<SASAction*>* tilActions,
+                            TaskPlannerBase* parentPlanner,
+                            float timeout,
+                            unsigned int numThreads);
+        ~TaskPlannerParallel() override;
+        // Expansions that are in flight when a solution is found still finish, and the solution with the lowest
+        // cost among them is kept. Which solutions are reached first depends on the timing of the threads, so
+        // the returned plan can differ from run to run and from the one a sequential search returns
+        Plan* plan() override;
+        Plan* searchStep() override;
+        bool emptySearchSpace() override;
+        unsigned int update(Plan* base, std::vector<Plan*>& successors) override;
+        std::vector<Plan*> getNextSuccessors(Plan* base) override;
+        Plan* poll() override;
+    };
+}  // namespace grstaps
+
+#endif  // TASK_PLANNER_PARALLEL_HPP
@@ -33,7 +33,7 @@ namespace grstaps
         Plan* plan() override;
         Plan* searchStep() override;
         virtual bool emptySearchSpace() override;
-        virtual void update(Plan* base, std::vector<Plan*>& successors) override;
+        virtual unsigned int update(Plan* base, std::vector<Plan*>& successors) override;
         virtual std::vector<Plan*> getNextSuccessors(Plan* base) override;
         virtual Plan* poll() override;
     };
@@ -21,6 +21,7 @@ namespace grstaps
         std::vector<SASAction*> m_til_actions;
         TaskPlannerBase* m_planner;
         float m_timeout;
+        unsigned int m_num_threads;  // More than one selects the parallel best-first search
         clock_t m_initial_time;
 
         void createInitialPlan();
@@ -37,10 +38,11 @@ namespace grstaps
         void checkPlannerType();
 
        public:
-        TaskPlannerSetting(SASTask* sTask, bool m_generate_trace, float m_timeout);
+        TaskPlannerSetting(SASTask* sTask, bool m_generate_trace, float m_timeout, unsigned int m_num_threads = 1);
         Plan* plan();
         Plan* improveSolution(uint16_t bestG, float bestGC, bool first);
         unsigned int getExpandedNodes();
+        unsigned int getVisitedNodes();
         std::string planToPDDL(Plan* p);
     };
 }  // namespace grstaps
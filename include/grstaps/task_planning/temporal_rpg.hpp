@@ -19,8 +19,10 @@
 #ifndef GRSTAPS_TEMPORAL_RPG_HPP
 #define GRSTAPS_TEMPORAL_RPG_HPP
 
+// global
+#include <cstring>
+
 // local
-#include "grstaps/task_planning/priority_queue.hpp"
 #include "grstaps/task_planning/sas_task.hpp"
 #include "grstaps/task_planning/utils.hpp"
 
@@ -28,13 +30,16 @@ namespace grstaps
 {
     class TState;
 
-    class FluentLevel : public PriorityQueueItem
+    class FluentLevel
     {        // Level of a(sub)goal
     public:
         TVariable variable;
         TValue value;
         float level;
 
+        FluentLevel()
+        {}
+
         FluentLevel(TVariable var, TValue val, float lev)
         {
             variable = var;
@@ -42,17 +47,6 @@ namespace grstaps
             level = lev;
         }
 
-        virtual inline int compare(PriorityQueueItem* other)
-        {
-            float otherLevel = ((FluentLevel*)other)->level;
-            if(level < otherLevel)
-            { return -1; }
-            else if(level > otherLevel)
-            { return 1; }
-            else
-            { return 0; }
-        }
-
         std::string toString(SASTask* task)
         {
             return "(" + task->variables[variable].name + "," + task->values[value].name + ") -> " +
@@ -60,6 +54,50 @@ namespace grstaps
         }
     };
 
+    // Monotone radix heap of fluent levels. The extracted levels never decrease, so the items are distributed in
+    // buckets according to the highest bit in which their (non-negative float) level differs from the last extracted
+    // one. Items are stored by value and the buckets keep their capacity between uses
+    class FluentLevelQueue
+    {
+    private:
+        static const unsigned int NUM_BUCKETS = 33;
+        std::vector<FluentLevel> buckets[NUM_BUCKETS];
+        uint32_t last;
+        unsigned int count;
+
+        static inline uint32_t key(float level)
+        {
+            uint32_t k;
+            std::memcpy(&k, &level, sizeof(k));
+            return k;
+        }
+
+        inline unsigned int bucketIndex(uint32_t k) const
+        {
+            return k == last ? 0 : 32 - __builtin_clz(k ^ last);
+        }
+
+    public:
+        FluentLevelQueue()
+        {
+            last = 0;
+            count = 0;
+        }
+
+        inline unsigned int size() const
+        { return count; }
+
+        inline void push(TVariable var, TValue value, float level)
+        {
+            buckets[bucketIndex(key(level))].emplace_back(var, value, level);
+            count++;
+        }
+
+        FluentLevel poll();
+
+        void clear();
+    };
+
     class LMFluent
     {    // Landmark literal
     public:
@@ -98,57 +136,84 @@ namespace grstaps
         }
     };
 
+    // The generation time of the fluents and the visited actions are stored in flat arrays indexed by fluent id and
+    // action index. Each build starts a new epoch, so the entries written by previous builds are ignored without
+    // clearing the arrays and the same object can be rebuilt from different states
     class TemporalRPG
     {
     private:
         SASTask* task;
         int numActions;
-        std::unordered_map<TVarValue, float> firstGenerationTime;
-        PriorityQueue qPNormal;
+        uint32_t epoch;
+        std::vector<float> generationTime;                        // Fluent id -> first generation time
+        std::vector<uint32_t> generationEpoch;                    // Fluent id -> epoch of generationTime
+        std::vector<TVarValue> reachedFluents;                    // Fluents reached in the current epoch
+        FluentLevelQueue qPNormal;
         bool untilGoals;
-        std::vector <TVarValue> goalsToAchieve;
+        std::vector<uint32_t> goals;                            // Fluent ids of the goals
+        std::vector<uint32_t> goalsToAchieve;
         bool verifyFluent;
         LMFluent fluentToVerify;
-        char* visitedAction;
+        std::vector<uint32_t> visitedAction;                    // Action index -> epoch in which it was visited
         std::vector <LMFluent> fluentList;                        // List of fluents (ComputeLiterals)
-        std::unordered_map<TVarValue, int> fluentIndex;            // [variable,value] -> fluent index
+        std::vector<int> fluentIndex;                            // Fluent id -> fluent index
         std::vector <std::vector<TVarValue>> fluentLevels;        // List of fluents at each level
         std::unordered_map<float, int> fluentLevelIndex;        // Time -> level
-        float* actionLevels;                                    // Starting time of each action
+        std::vector<float> actionLevels;                        // Starting time of each action
         std::vector<SASAction*>* tilActions;
 
         void addGoalToAchieve(SASCondition& c);
 
         void init(TState* state);
 
+        void nextEpoch();
+
         inline float getFirstGenerationTime(TVariable v, TValue value)
         {
-            return getFirstGenerationTime(SASTask::getVariableValueCode(v, value));
+            uint32_t id = task->getFluentId(v, value);
+            if(id == SASTask::NO_FLUENT || generationEpoch[id] != epoch)
+            { return -1; }
+            else
+            { return generationTime[id]; }
         }
 
         inline float getFirstGenerationTime(TVarValue vv)
         {
-            std::unordered_map<TVarValue, float>::const_iterator got = firstGenerationTime.find(vv);
-            if(got == firstGenerationTime.end())
-            { return -1; }
-            else
-            { return got->second; }
+            return getFirstGenerationTime(SASTask::getVariableIndex(vv), SASTask::getValueIndex(vv));
         }
 
+        inline bool setFirstGenerationTime(TVariable v, TValue value, float time)
+        {
+            uint32_t id = task->getFluentId(v, value);
+            if(id == SASTask::NO_FLUENT)
+            { return false; }
+            if(generationEpoch[id] != epoch)
+            {
+                generationEpoch[id] = epoch;
+                reachedFluents.push_back(SASTask::getVariableValueCode(v, value));
+            }
+            generationTime[id] = time;
+            return true;
+        }
+
+        inline bool isVisited(SASAction* a) const
+        { return visitedAction[a->index] == epoch; }
+
+        inline void setVisited(SASAction* a)
+        { visitedAction[a->index] = epoch; }
+
         bool checkAcheivedGoals();
 
         bool actionProducesFluent(SASAction* a);
 
-        void clearPriorityQueue();
-
         float getActionLevel(SASAction* a, TState* state);
 
         void programAction(SASAction* a, TState* state);
 
     public:
-        void initialize(bool untilGoals, SASTask* task, std::vector<SASAction*>* tilActions);
+        TemporalRPG();
 
-        ~TemporalRPG();
+        void initialize(bool untilGoals, SASTask* task, std::vector<SASAction*>* tilActions);
 
         void build(TState* state);
 
@@ -164,12 +229,8 @@ namespace grstaps
 
         inline int getFluentIndex(TVariable v, TValue value)
         {
-            std::unordered_map<TVarValue, int>::const_iterator got = fluentIndex.find(SASTask::getVariableValueCode(v,
-                                                                                                                    value));
-            if(got == fluentIndex.end())
-            { return -1; }
-            else
-            { return got->second; }
+            uint32_t id = task->getFluentId(v, value);
+            return id == SASTask::NO_FLUENT ? -1 : fluentIndex[id];
         }
 
         inline LMFluent* getFluentByIndex(int index)
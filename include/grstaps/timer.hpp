@@ -34,7 +34,7 @@ namespace grstaps
 
        private:
         bool m_running;
-        std::chrono::time_point<std::chrono::system_clock> m_start_time;
+        std::chrono::time_point<std::chrono::steady_clock> m_start_time;
         float m_time; //!< seconds
     };
 }
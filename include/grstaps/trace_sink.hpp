@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2020 Andrew Messing
+ *
+ * grstaps is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 3 of the License,
+ * or any later version.
+ *
+ * grstaps is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with grstaps; if not, write to the Free Software Foundation,
+ * Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#ifndef GRSTAPS_TRACE_SINK_HPP
+#define GRSTAPS_TRACE_SINK_HPP
+
+// global
+#include <atomic>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+// local
+#include "grstaps/noncopyable.hpp"
+
+namespace grstaps
+{
+    /**
+     * \brief Writes trace records to a file from a background thread
+     *
+     * The records are passed through a single-producer/single-consumer lock-free ring buffer, so write() never
+     * waits for the file. If the ring is full, the records are kept in a backlog owned by the producer and moved
+     * to the ring on the next write() or close(). Only one thread may call write()
+     */
+    class TraceSink : Noncopyable
+    {
+       public:
+        /**
+         * Constructor
+         *
+         * \param filepath The file to write to (truncated)
+         * \param capacity Number of records in the ring buffer (rounded up to a power of two)
+         */
+        explicit TraceSink(const std::string& filepath, unsigned int capacity = 4096);
+
+        /**
+         * Flushes the remaining records and closes the file
+         */
+        ~TraceSink();
+
+        /**
+         * Queues a record to be written
+         */
+        void write(std::string&& record);
+
+        /**
+         * Waits until all the records are written and closes the file
+         */
+        void close();
+
+       private:
+        std::ofstream m_file;
+        std::unique_ptr<std::string[]> m_ring;
+        unsigned int m_mask;
+        alignas(64) std::atomic<unsigned int> m_head;  //!< Next record to write to file (consumer)
+        alignas(64) std::atomic<unsigned int> m_tail;  //!< Next free slot (producer)
+        std::deque<std::string> m_backlog;             //!< Records that did not fit in the ring (producer)
+        std::atomic<bool> m_closing;
+        std::thread m_writer;
+
+        bool push(std::string& record);
+        void flushBacklog();
+        void run();
+    };
+}  // namespace grstaps
+
+#endif  // GRSTAPS_TRACE_SINK_HPP
@@ -27,6 +27,7 @@
 
 // Local
 #include <boost/make_shared.hpp>
+#include <grstaps/compiled_map.hpp>
 #include <grstaps/json_conversions.hpp>
 
 namespace grstaps
@@ -36,6 +37,7 @@ namespace grstaps
         IrosProblem::IrosProblem()
             : speedIndex(-1)
             , mpIndex(-1)
+            , m_longest_perimeter(0)
         {}
 
         void IrosProblem::init(const char* parameters_file, const char* map_file)
@@ -44,38 +46,12 @@ namespace grstaps
             nlohmann::json config;
             ifs >> config;
 
-            std::ifstream ifs2(map_file);
-            nlohmann::json map;
-            ifs2 >> map;
-
-            // groundfolder
-            m_map.push_back(convertBuildingsAndStreetsToPolygons2(map["buildings"], map["roads"]));
-
-            mp_min = std::numeric_limits<float>::max();
-            mp_max = std::numeric_limits<float>::min();
-            {
-                for(const ClipperLib2::Path& poly: m_map[0])
-                {
-                    for(const ClipperLib2::IntPoint& point: poly)
-                    {
-                        mp_min = std::min<float>(static_cast<float>(std::min(point.X, point.Y)), mp_min);
-                        mp_max = std::max<float>(static_cast<float>(std::max(point.X, point.Y)), mp_max);
-                    }
-                }
-                mp_max += 10;
-                mp_min -= 10;
-            }
-
-            // Aerial
-            ClipperLib2::Path boundary = {ClipperLib2::IntPoint(mp_min, mp_min),
-                                          ClipperLib2::IntPoint(mp_min, mp_max),
-                                          ClipperLib2::IntPoint(mp_max, mp_max),
-                                          ClipperLib2::IntPoint(mp_max, mp_min)};
-            if(ClipperLib2::Area(boundary) < 0)
-            {
-                std::reverse(boundary.begin(), boundary.end());
-            }
-            m_map.push_back({boundary});
+            // Accepts either a json map or one that has already been compiled
+            const CompiledMap compiled_map = CompiledMap::load(map_file);
+            m_map                          = compiled_map.maps;
+            m_longest_perimeter            = compiled_map.longestPerimeter;
+            mp_min                         = compiled_map.boundaryMin;
+            mp_max                         = compiled_map.boundaryMax;
 
             for(const nlohmann::json& j: config["streets"])
             {
@@ -140,36 +116,8 @@ namespace grstaps
 
         void IrosProblem::setWorstMP()
         {
-            longestPath = 0;
-            for(int i = 0; i < m_map.size(); i++)
-            {
-                float currentPath = 0;
-                for(int j = 0; j < m_map[i].size(); j++)
-                {
-                    // std::cout << "New" << std::endl;
-                    for(int k = 0; k < m_map[i][j].size(); k++)
-                    {
-                        if(k == ((m_map[i][j]).size() - 1))
-                        {
-                            float x_squared = pow(m_map[i][j][k].X - m_map[i][j][0].X, 2);
-                            float y_squared = pow(m_map[i][j][k].Y - m_map[i][j][0].Y, 2);
-                            currentPath += sqrt(x_squared + y_squared);
-                        }
-                        else
-                        {
-                            float x_squared =
-                                pow(m_map[i][j][k].X - m_map[i][j][k + 1].X, 2);
-                            float y_squared =
-                                pow(m_map[i][j][k].Y - m_map[i][j][k + 1].Y, 2);
-                            currentPath += sqrt(x_squared + y_squared);
-                        }
-                    }
-                }
-                if(currentPath > longestPath)
-                {
-                    longestPath = currentPath;
-                }
-            }
+            // The perimeters are summed when the map is compiled
+            longestPath = m_longest_perimeter;
             if(speedIndex > 0)
             {
                 float slowest = std::numeric_limits<float>::max();
@@ -276,50 +224,6 @@ namespace grstaps
             return (q.y - p.y) * (r.x - q.x) - (q.x - p.x) * (r.y - q.y);
         }
 
-        void convertToPaths(ClipperLib2::Paths& rv, const std::vector<std::vector<b2Vec2>>& shapes)
-        {
-            for(const std::vector<b2Vec2>& shape: shapes)
-            {
-                ClipperLib2::Path polygon;
-                for(const b2Vec2& point: shape)
-                {
-                    polygon.push_back(ClipperLib2::IntPoint(point.x * 1E6, point.y * 1E6));
-                }
-
-                // If "hole" flip it
-                const float area = ClipperLib2::Area(polygon);
-                if(area < 0.0)
-                {
-                    std::reverse(polygon.begin(), polygon.end());
-                }
-                rv.push_back(polygon);
-            }
-        }
-
-        ClipperLib2::Paths IrosProblem::convertBuildingsAndStreetsToPolygons2(const nlohmann::json& buildings,
-                                                                          const nlohmann::json& streets)
-        {
-            ClipperLib2::Paths rv;
-            convertToPaths(rv, buildings.get<std::vector<std::vector<b2Vec2>>>());
-            convertToPaths(rv, streets.get<std::vector<std::vector<b2Vec2>>>());
-
-            // union/smooth out
-            {
-                ClipperLib2::Clipper clipper;
-                clipper.AddPaths(rv, ClipperLib2::ptSubject, true);
-                clipper.Execute(ClipperLib2::ctUnion, rv, ClipperLib2::pftNonZero, ClipperLib2::pftNonZero);
-
-                ClipperLib2::ClipperOffset clipper_offset;
-                clipper_offset.AddPaths(rv, ClipperLib2::jtMiter, ClipperLib2::etClosedPolygon);
-                clipper_offset.Execute(rv, 1E5);
-                clipper_offset.Clear();
-                clipper_offset.AddPaths(rv, ClipperLib2::jtMiter, ClipperLib2::etClosedPolygon);
-                clipper_offset.Execute(rv, -1E5);
-            }
-
-            return rv;
-        }
-
         void IrosProblem::writeMap(const std::string& folder)
         {
             nlohmann::json j;
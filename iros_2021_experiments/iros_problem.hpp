@@ -72,7 +72,6 @@ namespace grstaps
 
            protected:
             std::vector<b2PolygonShape> convertBuildingsAndStreetsToPolygons1(const nlohmann::json& buildings, const nlohmann::json& streets);
-            ClipperLib2::Paths convertBuildingsAndStreetsToPolygons2(const nlohmann::json& buildings, const nlohmann::json& streets);
 
             std::vector<Location> m_locations;  //!< coordinates and name of location
             std::map<std::string, std::pair<unsigned int, unsigned int>>
@@ -85,6 +84,7 @@ namespace grstaps
             boost::shared_ptr<std::vector<std::vector<float>>> m_goal_distribution;
             boost::shared_ptr<std::vector<std::pair<unsigned int, unsigned int>>> m_task_locations;
             std::vector<ClipperLib2::Paths> m_map;
+            float m_longest_perimeter;  //!< Largest total perimeter of the polygons of a species map
             nlohmann::json m_config;
         };
     }
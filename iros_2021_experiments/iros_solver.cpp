@@ -25,6 +25,7 @@ namespace grstaps
 
             // Task Allocation
             taskAllocationToScheduling taToSched(motion_planners, &problem.startingLocations(), problem.longestPath);
+            taToSched.configure(config);
             bool usingSpecies = false;
             unsigned int talloc_nodes_expanded = 0;
             unsigned int talloc_nodes_visited  = 0;
@@ -68,7 +69,8 @@ namespace grstaps
             float mp_time = (*motion_planners)[0]->getTotalTime() + (*motion_planners)[1]->getTotalTime();
 
             nlohmann::json metrics = {{"solved", package->foundGoal},
-                                      {"makespan", package->foundGoal ? package->finalNode->getData().getScheduleTime() : -1},
+                                      {"makespan", package->foundGoal ? package->finalNode->getData().getExactScheduleTime() : -1},
+                                      {"schedule_optimal", package->foundGoal && package->finalNode->getData().taToScheduling.sched.isOptimal()},
                                       {"nodes_expanded", search->nodesExpanded},
                                       {"nodes_visited", search->nodesSearched},
                                       {"timer", timer.get()},
@@ -99,6 +101,9 @@ namespace grstaps
                 motion_planner->setLocations(problem.locations());
                 motion_planner->setQueryTime(query_time);
                 motion_planner->setConnectionRange(connection_range);
+                motion_planner->setVisibilityGraph(config.value("mp_visibility_graph", false),
+                                                   config.value("mp_robot_radius", 0.0f));
+                motion_planner->setRoadmapSize(config.value("mp_roadmap_size", 0u));
                 motion_planners->push_back(motion_planner);
             }
             return motion_planners;
@@ -7,6 +7,7 @@
 // External
 #include <args.hxx>
 #include <fmt/format.h>
+#include <grstaps/compiled_map.hpp>
 
 #include "iros_problem.hpp"
 #include "iros_solver.hpp"
@@ -21,6 +22,8 @@ namespace grstaps
             args::HelpFlag help(parser, "help", "Display this help menu", {'h', "help"});
             args::ValueFlag<int> problem_nr(parser, "problem_nr", "Problem Number", {'p'});
             args::ValueFlag<std::string> map_file(parser, "map_file", "Map File", {'m'});
+            args::ValueFlag<std::string> compile_map(
+                parser, "compiled_map", "Write the compiled map file to this path and exit", {'c', "compile"});
 
             try
             {
@@ -44,6 +47,12 @@ namespace grstaps
                 return 1;
             }
 
+            if(compile_map)
+            {
+                CompiledMap::load(fmt::format("maps/{0}", map_file.Get())).write(compile_map.Get());
+                return 0;
+            }
+
             std::cout << "ITAGS: problem " << problem_nr.Get() << std::endl;
             std::string folder = fmt::format("problems/{0}", problem_nr.Get());
             std::string config_filepath = fmt::format("{0}/config.json", folder);
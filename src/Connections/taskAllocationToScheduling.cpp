@@ -21,7 +21,11 @@
 #include "grstaps/Task_Allocation/TaskAllocation.h"
 #include "grstaps/logger.hpp"
 #include "grstaps/motion_planning/motion_planner.hpp"
+#include "grstaps/profiler.hpp"
 #include <math.h>       /* pow */
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace grstaps
 {
@@ -33,11 +37,9 @@ namespace grstaps
         , longestMP(longestMotion)
     {}
 
-    float taskAllocationToScheduling::getNonSpeciesSchedule(TaskAllocation* allocObject)
+    float taskAllocationToScheduling::getNonSpeciesSchedule(TaskAllocation* allocObject, bool lowerBound)
     {
-
-        Timer schedTime;
-        schedTime.start();
+        GRSTAPS_PROFILE_ZONE(Schedule);
         std::vector<std::vector<int>> disjunctiveConstraints;
         int numAction = allocObject->allocation.size() / (*allocObject->getNumSpecies()).size();
 
@@ -68,13 +70,9 @@ namespace grstaps
         {
             adjustScheduleNonSpeciesSchedule(allocObject);
 
-            float rv = addMotionPlanningNonSpeciesSchedule(allocObject);
-            //schedTime.recordSplit(Timer::SplitType::e_s);
-            schedTime.stop();
+            float rv = addMotionPlanningNonSpeciesSchedule(allocObject, lowerBound);
             return rv;
         }
-        //schedTime.recordSplit(Timer::SplitType::e_s);
-        schedTime.stop();
         return -1;
     }
 
@@ -217,7 +215,7 @@ namespace grstaps
         // return sched.getMakeSpan();
     }
 
-    float taskAllocationToScheduling::addMotionPlanningNonSpeciesSchedule(TaskAllocation* TaskAlloc)
+    float taskAllocationToScheduling::addMotionPlanningNonSpeciesSchedule(TaskAllocation* TaskAlloc, bool lowerBound)
     {
         if(m_motion_planners == nullptr)
         {
@@ -252,7 +250,7 @@ namespace grstaps
                         }
                         if(currentLocations[j] != (*m_action_locations)[actionOrder[i]].first)
                         {
-                            std::pair<bool, float> travelTime = (*m_motion_planners)[(*TaskAlloc->speciesTraitDistribution)[j][TaskAlloc->mp_Index]]->query(currentLocations[j], (*m_action_locations)[actionOrder[i]].first);
+                            std::pair<bool, float> travelTime = travelLength(TaskAlloc, j, currentLocations[j], (*m_action_locations)[actionOrder[i]].first, lowerBound);
 
 
                             if(travelTime.first)
@@ -299,19 +297,18 @@ namespace grstaps
                     if(slowestAgentIndex != -1)
                     {
 
-                        action_travel_length =
-                            (*m_motion_planners)[(*TaskAlloc->speciesTraitDistribution)[slowestAgentIndex][TaskAlloc->mp_Index]]->query(
-                                (*m_action_locations)[actionOrder[i]].first,
-                                (*m_action_locations)[actionOrder[i]].second);
+                        action_travel_length = travelLength(TaskAlloc,
+                                                            slowestAgentIndex,
+                                                            (*m_action_locations)[actionOrder[i]].first,
+                                                            (*m_action_locations)[actionOrder[i]].second,
+                                                            lowerBound);
                     }
                     else{
-                        Location& first = (*m_motion_planners)[0]->m_locations[(*m_action_locations)[actionOrder[i]].first];
-                        Location& second= (*m_motion_planners)[0]->m_locations[(*m_action_locations)[actionOrder[i]].second];
-
-                        float x_dist = first.x() - second.x();
-                        float y_dist = first.y() - second.y();
-
-                        action_travel_length = {true, sqrt( pow(x_dist,2) + pow(y_dist,2))};
+                        action_travel_length = travelLength(TaskAlloc,
+                                                            -1,
+                                                            (*m_action_locations)[actionOrder[i]].first,
+                                                            (*m_action_locations)[actionOrder[i]].second,
+                                                            true);
                     }
 
                     if(action_travel_length.first)
@@ -448,9 +445,199 @@ namespace grstaps
         return std::make_pair(true, motionPlans);
     }
 
+    float taskAllocationToScheduling::planLowerBound(const std::vector<float>& durations,
+                                                     const std::vector<std::vector<int>>& orderingConstraints,
+                                                     const std::vector<std::vector<float>>& goalDistribution,
+                                                     const std::vector<std::vector<float>>& nonCumTraitCutoff,
+                                                     const std::vector<std::vector<float>>& speciesDistribution,
+                                                     const std::vector<int>& numSpec,
+                                                     int speedIndex,
+                                                     int mpIndex)
+    {
+        const unsigned int numActions = durations.size();
+        const bool travel =
+            m_motion_planners != nullptr && m_action_locations != nullptr && m_starting_locations != nullptr;
+
+        // No robot moves faster than the fastest species
+        float fastest = 1;
+        if(speedIndex != -1)
+        {
+            fastest = 0;
+            for(unsigned int s = 0; s < speciesDistribution.size(); ++s)
+            {
+                if(numSpec[s] > 0)
+                {
+                    fastest = std::max(fastest, speciesDistribution[s][speedIndex]);
+                }
+            }
+        }
+
+        std::vector<float> work(durations);
+        std::vector<float> release(numActions, 0);
+        if(travel && fastest > 0)
+        {
+            const std::vector<Location>& locations = (*m_motion_planners)[0]->m_locations;
+            auto straightLine = [&locations](unsigned int from, unsigned int to) {
+                return std::hypot(locations[from].x() - locations[to].x(), locations[from].y() - locations[to].y());
+            };
+
+            for(unsigned int i = 0; i < numActions; ++i)
+            {
+                const std::pair<unsigned int, unsigned int>& location = (*m_action_locations)[i];
+                if(location.first != location.second)
+                {
+                    // A move that no species can make fails every allocation
+                    if(!lazyMotionPlanning())
+                    {
+                        bool reachable = false;
+                        for(unsigned int s = 0; s < speciesDistribution.size() && !reachable; ++s)
+                        {
+                            reachable = numSpec[s] > 0 &&
+                                        (*m_motion_planners)[speciesDistribution[s][mpIndex]]
+                                            ->query(location.first, location.second)
+                                            .first;
+                        }
+                        if(!reachable)
+                        {
+                            GRSTAPS_PROFILE_COUNT(PlanPrescreenRejected);
+                            return -1;
+                        }
+                    }
+                    work[i] += straightLine(location.first, location.second) / fastest;
+                }
+
+                // Actions without requirements are not allocated robots so nobody has to travel to them
+                bool required = false;
+                for(unsigned int t = 0; t < goalDistribution[i].size(); ++t)
+                {
+                    required = required || goalDistribution[i][t] > 0 || nonCumTraitCutoff[i][t] > 0;
+                }
+                if(required)
+                {
+                    release[i] = std::numeric_limits<float>::max();
+                    for(unsigned int start: *m_starting_locations)
+                    {
+                        release[i] = std::min(release[i], straightLine(start, location.first) / fastest);
+                    }
+                }
+            }
+        }
+
+        // Longest path through the ordering constraints in topological order
+        std::vector<std::vector<int>> successors(numActions);
+        std::vector<int> numPredecessors(numActions, 0);
+        for(const std::vector<int>& constraint: orderingConstraints)
+        {
+            successors[constraint[0]].push_back(constraint[1]);
+            ++numPredecessors[constraint[1]];
+        }
+        std::vector<float> start(release);
+        std::vector<int> ready;
+        for(unsigned int i = 0; i < numActions; ++i)
+        {
+            if(numPredecessors[i] == 0)
+            {
+                ready.push_back(i);
+            }
+        }
+        float bound          = 0;
+        unsigned int visited = 0;
+        while(!ready.empty())
+        {
+            const int action = ready.back();
+            ready.pop_back();
+            ++visited;
+
+            const float end = start[action] + work[action];
+            bound           = std::max(bound, end);
+            for(int next: successors[action])
+            {
+                start[next] = std::max(start[next], end);
+                if(--numPredecessors[next] == 0)
+                {
+                    ready.push_back(next);
+                }
+            }
+        }
+        // The ordering constraints contain a cycle
+        if(visited < numActions)
+        {
+            GRSTAPS_PROFILE_COUNT(PlanPrescreenRejected);
+            return -1;
+        }
+
+        // A robot works on one action at a time, so the fleet supplies at most its total of a cumulative trait at once
+        const unsigned int numTraits = speciesDistribution.empty() ? 0 : speciesDistribution[0].size();
+        for(unsigned int t = 0; t < numTraits; ++t)
+        {
+            float capacity = 0;
+            for(unsigned int s = 0; s < speciesDistribution.size(); ++s)
+            {
+                capacity += speciesDistribution[s][t] * numSpec[s];
+            }
+
+            float energy = 0;
+            for(unsigned int i = 0; i < numActions; ++i)
+            {
+                if(nonCumTraitCutoff[i][t] == 0)
+                {
+                    energy += goalDistribution[i][t] * work[i];
+                }
+            }
+            if(capacity > 0)
+            {
+                bound = std::max(bound, energy / capacity);
+            }
+        }
+        return bound;
+    }
+
     void taskAllocationToScheduling::setActionLocations(
         boost::shared_ptr<const std::vector<std::pair<unsigned int, unsigned int>>> action_locations)
     {
         m_action_locations = std::move(action_locations);
     }
+
+    void taskAllocationToScheduling::configure(const nlohmann::json& config)
+    {
+        setSeed(config.value("schedule_seed", 0u));
+        setExactSearch(config.value("schedule_exact_budget", 0.0f), config.value("schedule_exact_max_disjuncts", 64));
+        setLazyMotionPlanning(config.value("lazy_motion_planning", false));
+    }
+
+    void taskAllocationToScheduling::setSeed(unsigned int seed)
+    {
+        sched.setSeed(seed);
+    }
+
+    void taskAllocationToScheduling::setExactSearch(float budget, int maxDisjuncts)
+    {
+        sched.setExactSearch(budget, maxDisjuncts);
+    }
+
+    void taskAllocationToScheduling::setLazyMotionPlanning(bool lazy)
+    {
+        m_lazy_motion_planning = lazy;
+    }
+
+    bool taskAllocationToScheduling::lazyMotionPlanning() const
+    {
+        return m_lazy_motion_planning && m_motion_planners != nullptr;
+    }
+
+    std::pair<bool, float> taskAllocationToScheduling::travelLength(TaskAllocation* TaskAlloc, int species, unsigned int from, unsigned int to, bool lowerBound)
+    {
+        if(lowerBound || species < 0)
+        {
+            // No path is shorter than the straight line
+            const Location& first  = (*m_motion_planners)[0]->m_locations[from];
+            const Location& second = (*m_motion_planners)[0]->m_locations[to];
+
+            float x_dist = first.x() - second.x();
+            float y_dist = first.y() - second.y();
+
+            return {true, sqrt(pow(x_dist, 2) + pow(y_dist, 2))};
+        }
+        return (*m_motion_planners)[(*TaskAlloc->speciesTraitDistribution)[species][TaskAlloc->mp_Index]]->query(from, to);
+    }
 }  // namespace grstaps
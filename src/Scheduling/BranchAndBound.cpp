@@ -0,0 +1,190 @@
+/*
+ * Copyright (C)2020 Glen Neville
+ *
+ * GRSTAPS is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 3 of the License,
+ * or any later version.
+ *
+ * GRSTAPS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GRSTAPS; if not, write to the Free Software Foundation,
+ * Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include <grstaps/Scheduling/BranchAndBound.h>
+#include <grstaps/profiler.hpp>
+
+namespace grstaps
+{
+    BranchAndBound::BranchAndBound(float budget)
+        : budget(budget)
+        , timedOut(false)
+        , nodes(0)
+        , bestMakespan(std::numeric_limits<float>::max())
+    {}
+
+    bool BranchAndBound::solve(const Scheduler& initialSched)
+    {
+        GRSTAPS_PROFILE_ZONE(BranchAndBound);
+        deadline = std::chrono::steady_clock::now() +
+                   std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(budget));
+        timedOut     = false;
+        nodes        = 0;
+        bestMakespan = std::numeric_limits<float>::max();
+
+        Scheduler root = initialSched;
+        root.clearDisjuctiveOrderings();
+        branch(root);
+        return hasSolution() && !timedOut;
+    }
+
+    bool BranchAndBound::hasSolution() const
+    {
+        return bestMakespan < std::numeric_limits<float>::max();
+    }
+
+    const Scheduler& BranchAndBound::solution() const
+    {
+        return bestSolution;
+    }
+
+    float BranchAndBound::makespan() const
+    {
+        return bestMakespan;
+    }
+
+    unsigned int BranchAndBound::nodesExpanded() const
+    {
+        return nodes;
+    }
+
+    void BranchAndBound::branch(Scheduler& node)
+    {
+        ++nodes;
+        if(std::chrono::steady_clock::now() > deadline)
+        {
+            timedOut = true;
+            return;
+        }
+
+        const int i = propagate(node);
+        if(i == -2)
+        {
+            return;
+        }
+        if(i == -1)
+        {
+            // Pairs that are ordered through a path of other constraints still need their ordering recorded
+            node.clearDisjuctiveOrderings();
+            for(unsigned int j = 0; j < node.disjuctiveConstraints.size(); ++j)
+            {
+                orient(node, j, node.checkOC(node.disjuctiveConstraints[j][1], node.disjuctiveConstraints[j][0]));
+            }
+            bestMakespan = node.getMakeSpan();
+            bestSolution = node;
+            return;
+        }
+
+        // Try the orientation with the smaller bound first so the incumbent improves quickly
+        const int first  = node.disjuctiveConstraints[i][0];
+        const int second = node.disjuctiveConstraints[i][1];
+        const bool ordering = orientedBound(node, second, first) < orientedBound(node, first, second);
+
+        Scheduler child = node;
+        orient(child, i, ordering);
+        branch(child);
+        if(timedOut)
+        {
+            return;
+        }
+        orient(node, i, !ordering);
+        branch(node);
+    }
+
+    int BranchAndBound::propagate(Scheduler& node)
+    {
+        bool changed = true;
+        int branchOn = -1;
+        while(changed)
+        {
+            changed = false;
+            branchOn = -1;
+            float branchBound = -1;
+            if(node.getMakeSpan() >= bestMakespan)
+            {
+                return -2;
+            }
+
+            // Fixing a pair only lengthens the tails, so the ones computed at the start of the pass stay lower bounds
+            computeTails(node);
+            for(unsigned int i = 0; i < node.disjuctiveConstraints.size(); ++i)
+            {
+                const int first  = node.disjuctiveConstraints[i][0];
+                const int second = node.disjuctiveConstraints[i][1];
+                const bool allowedFirst  = node.checkOC(first, second);
+                const bool allowedSecond = node.checkOC(second, first);
+                if(!allowedFirst && !allowedSecond)
+                {
+                    return -2;
+                }
+                if(!allowedFirst || !allowedSecond)
+                {
+                    continue;
+                }
+
+                const float boundFirst  = orientedBound(node, first, second);
+                const float boundSecond = orientedBound(node, second, first);
+                if(boundFirst >= bestMakespan && boundSecond >= bestMakespan)
+                {
+                    return -2;
+                }
+                if(boundFirst >= bestMakespan || boundSecond >= bestMakespan)
+                {
+                    orient(node, i, boundFirst >= bestMakespan);
+                    changed = true;
+                }
+                else if(std::min(boundFirst, boundSecond) > branchBound)
+                {
+                    // Branch on the most critical pair
+                    branchBound = std::min(boundFirst, boundSecond);
+                    branchOn    = i;
+                }
+            }
+        }
+        return branchOn;
+    }
+
+    void BranchAndBound::computeTails(Scheduler& node)
+    {
+        tails.assign(node.stn.size(), 0);
+        for(auto it = node.topologicalOrder.rbegin(); it != node.topologicalOrder.rend(); ++it)
+        {
+            for(int next: node.beforeConstraints[*it])
+            {
+                tails[*it] = std::max(tails[*it], node.stn[next][1] - node.stn[next][0] + tails[next]);
+            }
+        }
+    }
+
+    float BranchAndBound::orientedBound(const Scheduler& node, int first, int second) const
+    {
+        const float start = std::max(node.stn[second][0], node.stn[first][1]);
+        return start + node.stn[second][1] - node.stn[second][0] + tails[second];
+    }
+
+    bool BranchAndBound::orient(Scheduler& node, int i, bool ordering)
+    {
+        const int first  = node.disjuctiveConstraints[i][0];
+        const int second = node.disjuctiveConstraints[i][1];
+        node.setDisjuctiveOrdering(i, ordering);
+        return ordering ? node.addOC(second, first) : node.addOC(first, second);
+    }
+}  // namespace grstaps
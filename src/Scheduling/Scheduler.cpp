@@ -21,19 +21,19 @@
 #include <utility>
 #include <vector>
 
+#include <grstaps/Scheduling/BranchAndBound.h>
 #include <grstaps/Scheduling/Scheduler.h>
 #include <grstaps/Scheduling/tabu.h>
 #include <vector>
 
 namespace grstaps
 {
-    tabu tabuSearch;
-
     Scheduler::Scheduler()
     {
         scheduleValid = true;
         makeSpan      = -1;
         lastAction    = -1;
+        disID         = 0;
         bestSchedule  = 0;
         constraintsToUpdate.reserve(1000);
         bestSchedule  = 0;
@@ -43,6 +43,15 @@ namespace grstaps
 
     Scheduler::Scheduler(const Scheduler& toCopy)
     {
+        *this = toCopy;
+    }
+
+    Scheduler& Scheduler::operator=(const Scheduler& toCopy)
+    {
+        if(this == &toCopy)
+        {
+            return *this;
+        }
         stn                   = toCopy.stn;
         beforeConstraints     = toCopy.beforeConstraints;
         afterConstraints      = toCopy.afterConstraints;
@@ -52,11 +61,18 @@ namespace grstaps
         makeSpan              = toCopy.makeSpan;
         lastAction            = toCopy.lastAction;
         disID                 = toCopy.disID;
+        topologicalOrder      = toCopy.topologicalOrder;
+        topologicalIndex      = toCopy.topologicalIndex;
         copySTN               = toCopy.stn;
         bestSchedule          = toCopy.bestSchedule;
         worstSchedule         = toCopy.worstSchedule;
         longestMotion         = toCopy.longestMotion;
-
+        seed                  = toCopy.seed;
+        rng                   = toCopy.rng;
+        exactBudget           = toCopy.exactBudget;
+        exactMaxDisjuncts     = toCopy.exactMaxDisjuncts;
+        optimal               = toCopy.optimal;
+        return *this;
     }
 
     bool Scheduler::schedule(const std::vector<float>& durations, std::vector<std::vector<int>>& orderingConstraints, float longestMP)
@@ -105,8 +121,8 @@ namespace grstaps
             }
         }
         disjuctiveConstraints = disConstraints;
-        disjuctiveOrderings.resize(disjuctiveConstraints.size());
-        std::fill(disjuctiveOrderings.begin(), disjuctiveOrderings.end(), 0);
+        clearDisjuctiveOrderings();
+        optimal = true;
         if(disConstraints.size() > 0)
         {
             setDisjuctive();
@@ -117,6 +133,7 @@ namespace grstaps
     float Scheduler::initSTN(const std::vector<float>& durations)
     {
         stn           = std::vector<std::vector<float>>(durations.size(), std::vector<float>(2, 0));
+        initOrder();
         worstSchedule = 0;
         for(int i = 0; i < durations.size(); ++i)
         {
@@ -181,45 +198,17 @@ namespace grstaps
             return true;
         }
         makeSpan = -1;
-        int originalFirst = first;
-        constraintsToUpdate.clear();
+        if(!insertOrder(first, second))
+        {
+            scheduleValid = false;
+            return scheduleValid;
+        }
         beforeConstraints[first].emplace_back(second);
         afterConstraints[second].emplace_back(first);
-        constraintsToUpdate.emplace_back(first);
-        constraintsToUpdate.emplace_back(second);
-        int constrainToAdjust = 0;
-        while(constrainToAdjust < constraintsToUpdate.size())
+        if(stn[second][0] < stn[first][1])
         {
-            if(stn[second][0] < stn[first][1])
-            {
-                float duration = stn[second][1] - stn[second][0];
-                stn[second][0] = stn[first][1];
-                stn[second][1] = stn[second][0] + duration;
-                if(makeSpan != -1 && stn[second][1] > makeSpan)
-                {
-                    makeSpan   = stn[second][1];
-                    lastAction = second;
-                }
-                for(int i = 0; i < beforeConstraints[second].size(); ++i)
-                {
-                    constraintsToUpdate.emplace_back(second);
-                    constraintsToUpdate.emplace_back(beforeConstraints[second][i]);
-                }
-            }
-            constrainToAdjust += 2;
-            if(constrainToAdjust < constraintsToUpdate.size())
-            {
-                first  = constraintsToUpdate[constrainToAdjust];
-                second = constraintsToUpdate[constrainToAdjust + 1];
-                if(second == originalFirst)
-                {
-                    scheduleValid = false;
-                    makeSpan = -1;
-                    return scheduleValid;
-                }
-            }
+            propagate(second);
         }
-
         return scheduleValid;
     }
 
@@ -313,7 +302,6 @@ namespace grstaps
     void Scheduler::removeOC(int first, int second)
     {
         makeSpan = -1;
-        constraintsToUpdate.clear();
         beforeConstraints[first].erase(
             std::remove(beforeConstraints[first].begin(), beforeConstraints[first].end(), second),
             beforeConstraints[first].end());
@@ -321,66 +309,10 @@ namespace grstaps
             std::remove(afterConstraints[second].begin(), afterConstraints[second].end(), first),
             afterConstraints[second].end());
 
+        // Only the constraint that determined the start of second can move it
         if(stn[first][1] == stn[second][0])
         {
-            float maxDelay = 0;
-            for(int i: afterConstraints[second])
-            {
-                if(stn[i][1] > maxDelay)
-                {
-                    maxDelay = stn[i][1];
-                }
-            }
-            float duration = stn[second][1] - stn[second][0];
-            stn[second][0] = maxDelay;
-            stn[second][1] = duration + stn[second][0];
-
-            // constraintsToUpdate.reserve(beforeConstraints[second].size());
-            for(int i = 0; i < beforeConstraints[second].size(); ++i)
-            {
-                constraintsToUpdate.emplace_back(second);
-                constraintsToUpdate.emplace_back(beforeConstraints[second][i]);
-            }
-
-            if(!constraintsToUpdate.empty())
-            {
-                first  = constraintsToUpdate[0];
-                second = constraintsToUpdate[1];
-            }
-            int constrainToAdjust = 0;
-            while(constrainToAdjust < constraintsToUpdate.size())
-            {
-                maxDelay = 0;
-                for(int i: afterConstraints[second])
-                {
-                    if(stn[i][1] > maxDelay)
-                    {
-                        maxDelay = stn[i][1];
-                    }
-                }
-                if(stn[second][0] != maxDelay)
-                {
-                    float newduration = stn[second][1] - stn[second][0];
-                    stn[second][0]    = maxDelay;
-                    if(stn[second][1] == makeSpan)
-                    {
-                        makeSpan = -1;
-                    }
-                    stn[second][1] = stn[second][0] + newduration;
-                    for(int i = 0; i < beforeConstraints[second].size(); ++i)
-                    {
-                        constraintsToUpdate.emplace_back(second);
-                        constraintsToUpdate.emplace_back(beforeConstraints[second][i]);
-                    }
-                }
-                // constraintsToUpdate.erase(constraintsToUpdate.begin());
-                constrainToAdjust += 2;
-                if(constrainToAdjust < constraintsToUpdate.size())
-                {
-                    first  = constraintsToUpdate[constrainToAdjust];
-                    second = constraintsToUpdate[constrainToAdjust + 1];
-                }
-            }
+            propagate(second);
         }
     }
 
@@ -451,48 +383,7 @@ namespace grstaps
             bestSchedule += duration;
         }
         stn[actionIndex][1] += duration;
-        std::vector<std::vector<int>> constraintsToUpdate;
-        std::vector<std::vector<bool>> checkedAlready(int(stn.size()), std::vector<bool>(stn.size(), false));
-        int second = actionIndex;
-        int first  = actionIndex;
-
-        constraintsToUpdate.reserve(beforeConstraints[second].size());
-        for(int i = 0; i < beforeConstraints[second].size(); ++i)
-        {
-            constraintsToUpdate.emplace_back(std::vector<int>{second, beforeConstraints[second][i]});
-        }
-        if(!constraintsToUpdate.empty())
-        {
-            first  = constraintsToUpdate[0][0];
-            second = constraintsToUpdate[0][1];
-        }
-
-        while(!constraintsToUpdate.empty())
-        {
-            if(stn[second][0] < stn[first][1])
-            {
-                float newDuration = stn[second][1] - stn[second][0];
-                stn[second][0]    = stn[first][1];
-                stn[second][1]    = stn[second][0] + newDuration;
-                for(int i = 0; i < beforeConstraints[second].size(); ++i)
-                {
-                    constraintsToUpdate.emplace_back(std::vector<int>{second, beforeConstraints[second][i]});
-                }
-            }
-            checkedAlready[first][second] = true;
-            constraintsToUpdate.erase(constraintsToUpdate.begin());
-            if(!constraintsToUpdate.empty())
-            {
-                first  = constraintsToUpdate[0][0];
-                second = constraintsToUpdate[0][1];
-                if(checkedAlready[first][second] == 1)
-                {
-                    // std::string errorString = "Schedule invalid loop found";
-                    // std::cout << errorString << std::endl;
-                    return false;
-                }
-            }
-        }
+        propagate(actionIndex, true);
         makeSpan = -1;
         return true;
     }
@@ -500,64 +391,8 @@ namespace grstaps
     bool Scheduler::decreaseActionTime(int actionIndex, float duration)
     {
         worstSchedule -= duration;
-        bool updateBestSched = true;
-        if((stn[actionIndex][1] - stn[actionIndex][1]) == bestSchedule){
-            updateBestSched = true;
-        }
         stn[actionIndex][1] -= duration;
-
-        std::vector<std::vector<int>> constraintsToUpdate;
-        std::vector<std::vector<bool>> checkedAlready(int(stn.size()), std::vector<bool>(stn.size(), false));
-        constraintsToUpdate.reserve(beforeConstraints[actionIndex].size());
-        for(int i = 0; i < beforeConstraints[actionIndex].size(); ++i)
-        {
-            constraintsToUpdate.emplace_back(std::vector<int>{actionIndex, beforeConstraints[actionIndex][i]});
-        }
-
-        int first  = 0;
-        int second = 0;
-        if(!constraintsToUpdate.empty())
-        {
-            first  = constraintsToUpdate[0][0];
-            second = constraintsToUpdate[0][1];
-        }
-
-        while(!constraintsToUpdate.empty())
-        {
-            float maxDelay = 0;
-            for(int i: afterConstraints[second])
-            {
-                if(stn[i][1] > maxDelay)
-                {
-                    maxDelay = stn[i][1];
-                }
-            }
-            if(stn[second][0] != maxDelay)
-            {
-                float newduration = stn[second][1] - stn[second][0];
-                stn[second][0]    = maxDelay;
-                stn[second][1]    = newduration;
-                for(int i = 0; i < beforeConstraints[second].size(); ++i)
-                {
-                    constraintsToUpdate.emplace_back(std::vector<int>{second, beforeConstraints[second][i]});
-                }
-            }
-
-            checkedAlready[first][second] = true;
-
-            constraintsToUpdate.erase(constraintsToUpdate.begin());
-            if(!constraintsToUpdate.empty())
-            {
-                first  = constraintsToUpdate[0][0];
-                second = constraintsToUpdate[0][1];
-                if(checkedAlready[first][second])
-                {
-                    // std::string errorString = "Schedule invalid loop found";
-                    // std::cout << errorString << std::endl;
-                    return false;
-                }
-            }
-        }
+        propagate(actionIndex, true);
         makeSpan = -1;
         return true;
     }
@@ -569,18 +404,33 @@ namespace grstaps
         {
             Scheduler::removeOC(actionID, beforeConstraints[actionID][0]);
         }
-        for(int i = 0; i < afterConstraints[actionID].size(); ++i)
+        while(!afterConstraints[actionID].empty())
         {
-            beforeConstraints[afterConstraints[actionID][i]].erase(
-                std::remove(beforeConstraints[afterConstraints[actionID][i]].begin(),
-                            beforeConstraints[afterConstraints[actionID][i]].end(),
-                            actionID),
-                beforeConstraints[afterConstraints[actionID][i]].end());
+            Scheduler::removeOC(afterConstraints[actionID][0], actionID);
         }
-        for(int i = 0; i < disjuctiveConstraints.size(); ++i)
+        stn.erase(stn.begin() + actionID);
+        beforeConstraints.erase(beforeConstraints.begin() + actionID);
+        afterConstraints.erase(afterConstraints.begin() + actionID);
+
+        // Shift the indices of the later actions and keep the rest of the topological order
+        auto shift = [actionID](int& i) {
+            if(i > actionID)
+            {
+                --i;
+            }
+        };
+        for(int i = 0; i < stn.size(); ++i)
         {
+            std::for_each(beforeConstraints[i].begin(), beforeConstraints[i].end(), shift);
+            std::for_each(afterConstraints[i].begin(), afterConstraints[i].end(), shift);
+        }
+        topologicalOrder.erase(topologicalOrder.begin() + topologicalIndex[actionID]);
+        std::for_each(topologicalOrder.begin(), topologicalOrder.end(), shift);
+        topologicalIndex.resize(stn.size());
+        for(int p = 0; p < topologicalOrder.size(); ++p)
+        {
+            topologicalIndex[topologicalOrder[p]] = p;
         }
-        stn.erase(stn.begin() + actionID);
         setDisjuctive();
 
         bestSchedule = 0;
@@ -596,6 +446,10 @@ namespace grstaps
     {
         makeSpan = -1;
         stn.emplace_back(std::vector<float>{0, duration});
+        beforeConstraints.emplace_back();
+        afterConstraints.emplace_back();
+        topologicalIndex.push_back(topologicalOrder.size());
+        topologicalOrder.push_back(stn.size() - 1);
         for(auto& orderingConstraint: orderingConstraints)
         {
             addOC(int(stn.size() - 1), orderingConstraint);
@@ -613,6 +467,10 @@ namespace grstaps
     {
         makeSpan = -1;
         stn.emplace_back(std::vector<float>{0, duration});
+        beforeConstraints.emplace_back();
+        afterConstraints.emplace_back();
+        topologicalIndex.push_back(topologicalOrder.size());
+        topologicalOrder.push_back(stn.size() - 1);
         for(auto& orderingConstraint: orderingConstraints)
         {
             addOC(int(stn.size() - 1), orderingConstraint);
@@ -630,40 +488,7 @@ namespace grstaps
 
     bool Scheduler::checkOC(int first, int second)
     {
-        constraintsToUpdate.clear();
-        constraintsToUpdate.push_back(first);
-        constraintsToUpdate.push_back(second);
-
-        int originalFirst     = first;
-        int originalSecond    = second;
-        int constrainToAdjust = 0;
-
-        while(constrainToAdjust < constraintsToUpdate.size())
-        {
-            if(stn[second][0] < stn[first][1])
-            {
-                for(int i = 0; i < beforeConstraints[second].size(); ++i)
-                {
-                    if(second != originalSecond || beforeConstraints[second][i] != originalFirst)
-                    {
-                        constraintsToUpdate.emplace_back(second);
-                        constraintsToUpdate.emplace_back(beforeConstraints[second][i]);
-                    }
-                }
-            }
-            // constraintsToUpdate.erase(constraintsToUpdate.begin());
-            constrainToAdjust += 2;
-            if(constrainToAdjust < constraintsToUpdate.size())
-            {
-                first  = constraintsToUpdate[constrainToAdjust];
-                second = constraintsToUpdate[constrainToAdjust + 1];
-                if(second == originalFirst)
-                {
-                    return false;
-                }
-            }
-        }
-        return true;
+        return first != second && !reachable(second, first);
     }
 
     void Scheduler::printSchedule()
@@ -680,22 +505,55 @@ namespace grstaps
         return disjuctiveConstraints.size();
     }
 
-    std::string Scheduler::getDisjuctiveID()
+    uint64_t Scheduler::getDisjuctiveID() const
     {
         return disID;
     }
 
+    uint64_t Scheduler::getDisjuctiveSwitchID(int i) const
+    {
+        return disID ^ zobristKey(i);
+    }
+
+    bool Scheduler::getDisjuctiveOrdering(int i) const
+    {
+        return (disjuctiveOrderings[i >> 6] >> (i & 63)) & 1;
+    }
+
+    void Scheduler::setDisjuctiveOrdering(int i, bool ordering)
+    {
+        if(getDisjuctiveOrdering(i) != ordering)
+        {
+            disjuctiveOrderings[i >> 6] ^= uint64_t(1) << (i & 63);
+            disID ^= zobristKey(i);
+        }
+    }
+
+    void Scheduler::clearDisjuctiveOrderings()
+    {
+        disjuctiveOrderings.assign((disjuctiveConstraints.size() + 63) >> 6, 0);
+        disID = 0;
+    }
+
+    // splitmix64 of the index, so the keys need no table and are the same in every run
+    uint64_t Scheduler::zobristKey(int i)
+    {
+        uint64_t z = (static_cast<uint64_t>(i) + 1) * 0x9E3779B97F4A7C15ULL;
+        z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z          = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
     bool Scheduler::getShedSwitch(int i)
     {
         bool valid;
-        if(disjuctiveOrderings[i] == 0)
+        if(!getDisjuctiveOrdering(i))
         {
             this->removeOC(disjuctiveConstraints[i][0], disjuctiveConstraints[i][1]);
             valid = this->addOC(disjuctiveConstraints[i][1], disjuctiveConstraints[i][0]);
             if(valid)
             {
-                this->disjuctiveOrderings[i] = 1;
-                this->disID[i]               = 1;
+                setDisjuctiveOrdering(i, true);
             }
             else
             {
@@ -709,8 +567,7 @@ namespace grstaps
             valid = this->addOC(disjuctiveConstraints[i][0], disjuctiveConstraints[i][1]);
             if(valid)
             {
-                this->disjuctiveOrderings[i] = 0;
-                this->disID[i]               = 0;
+                setDisjuctiveOrdering(i, false);
             }
             else
             {
@@ -723,71 +580,74 @@ namespace grstaps
 
     double Scheduler::getShedSwitchTime(int disIndex)
     {
-        float newMakespan;
-        // copySTN = stn;
-        if(disjuctiveOrderings[disIndex] == 0)
-        {
-            float newMakespan = removeOCTime2(disjuctiveConstraints[disIndex][0], disjuctiveConstraints[disIndex][1]);
-            // removeOCTime(disjuctiveConstraints[disIndex][0], disjuctiveConstraints[disIndex][1], copySTN);
-            newMakespan =
-                addOCTime2(disjuctiveConstraints[disIndex][1], disjuctiveConstraints[disIndex][0], newMakespan);
-            // valid = addOCTime(disjuctiveConstraints[disIndex][1], disjuctiveConstraints[disIndex][0],copySTN,
-            // beforeConstraints, afterConstraints);
-            return newMakespan;
-        }
-        else
+        const int first  = disjuctiveConstraints[disIndex][getDisjuctiveOrdering(disIndex) ? 1 : 0];
+        const int second = disjuctiveConstraints[disIndex][getDisjuctiveOrdering(disIndex) ? 0 : 1];
+
+        // The ordering is held by another constraint (e.g. a duplicate pair), so it cannot be switched on its own
+        if(find(beforeConstraints[first].begin(), beforeConstraints[first].end(), second) == beforeConstraints[first].end())
         {
-            float newMakespan = removeOCTime2(disjuctiveConstraints[disIndex][1], disjuctiveConstraints[disIndex][0]);
-            // removeOCTime(disjuctiveConstraints[disIndex][1], disjuctiveConstraints[disIndex][0], copySTN);
-            newMakespan = addOCTime2(disjuctiveConstraints[disIndex][0], disjuctiveConstraints[disIndex][1], makeSpan);
-            // valid = addOCTime(disjuctiveConstraints[disIndex][0],disjuctiveConstraints[disIndex][1], copySTN,
-            // beforeConstraints, afterConstraints);
-            return newMakespan;
+            return -1;
         }
+
+        // Switch the ordering, read the makespan and switch it back. Propagating back can round the times
+        // differently, so the times that were changed are restored from the log
+        const bool valid         = scheduleValid;
+        const double oldMakespan = makeSpan;
+        stnLog.clear();
+        logSTN = true;
+        removeOC(first, second);
+        const double newMakespan = addOC(second, first) ? getMakeSpan() : -1;
+        removeOC(second, first);
+        addOC(first, second);
+        logSTN = false;
+        for(auto change = stnLog.rbegin(); change != stnLog.rend(); ++change)
+        {
+            stn[std::get<0>(*change)][0] = std::get<1>(*change);
+            stn[std::get<0>(*change)][1] = std::get<2>(*change);
+        }
+        scheduleValid = valid;
+        makeSpan      = oldMakespan;
+        return newMakespan;
     }
 
     // todo edit
     void Scheduler::getRandomDisjunct(Scheduler& copySched)
     {
         bool complete = false;
-        copySched     = (*this);
-        std::fill(disjuctiveOrderings.begin(), disjuctiveOrderings.end(), 0);
-        disID = std::string(disjuctiveConstraints.size(), ' ');
         while(!complete)
         {
             copySched = *this;
-            int i     = 0;
-            for(i; i < disjuctiveConstraints.size(); ++i)
+            copySched.clearDisjuctiveOrderings();
+            int i = 0;
+            for(; i < disjuctiveConstraints.size(); ++i)
             {
-                if(copySched.stn[disjuctiveConstraints[i][0]][0] >= copySched.stn[disjuctiveConstraints[i][1]][1])
+                const int first  = disjuctiveConstraints[i][0];
+                const int second = disjuctiveConstraints[i][1];
+                if(copySched.stn[first][0] >= copySched.stn[second][1])
                 {
-                    copySched.addOC(disjuctiveConstraints[i][1], disjuctiveConstraints[i][0]);
-                    disjuctiveOrderings[i] = 0;
-                    disID[i]               = 0;
+                    copySched.addOC(second, first);
+                    copySched.setDisjuctiveOrdering(i, true);
                 }
-                else if(copySched.stn[disjuctiveConstraints[i][0]][1] <= copySched.stn[disjuctiveConstraints[i][1]][0])
+                else if(copySched.stn[first][1] <= copySched.stn[second][0])
                 {
-                    copySched.addOC(disjuctiveConstraints[i][0], disjuctiveConstraints[i][1]);
-                    disjuctiveOrderings[i] = 1;
-                    disID[i]               = 1;
+                    copySched.addOC(first, second);
+                    copySched.setDisjuctiveOrdering(i, false);
                 }
                 else
                 {
-                    int order          = rand() % 2;
-                    bool allowedFirst  = copySched.checkOC(disjuctiveConstraints[i][0], disjuctiveConstraints[i][1]);
-                    bool allowedSecond = copySched.checkOC(disjuctiveConstraints[i][1], disjuctiveConstraints[i][0]);
+                    int order          = rng() % 2;
+                    bool allowedFirst  = copySched.checkOC(first, second);
+                    bool allowedSecond = copySched.checkOC(second, first);
 
                     if(allowedFirst && (order == 0 || (!allowedSecond)))
                     {
-                        copySched.addOC(disjuctiveConstraints[i][1], disjuctiveConstraints[i][0]);
-                        disjuctiveOrderings[i] = 0;
-                        disID[i]               = 0;
+                        copySched.addOC(first, second);
+                        copySched.setDisjuctiveOrdering(i, false);
                     }
                     else if(allowedSecond)
                     {
-                        copySched.addOC(disjuctiveConstraints[i][0], disjuctiveConstraints[i][1]);
-                        disjuctiveOrderings[i] = 1;
-                        disID[i]               = 1;
+                        copySched.addOC(second, first);
+                        copySched.setDisjuctiveOrdering(i, true);
                     }
                     else
                     {
@@ -802,211 +662,212 @@ namespace grstaps
                 copySched.scheduleValid = true;
             }
         }
-        // return copySched;
     }
 
     void Scheduler::setDisjuctive()
     {
-        *this = tabuSearch.solve(1, *this);
-    }
-
-    float Scheduler::addOCTime2(int first, int second, float newMakespan)
-    {
-        constraintsToUpdate.clear();
-
-        int originalFirst  = first;
-        int originalSecond = second;
-        constraintsToUpdate.push_back(first);
-        constraintsToUpdate.push_back(second);
-        int constrainToAdjust = 0;
-
-        while(constrainToAdjust < constraintsToUpdate.size())
+        // Restart the stream so the result only depends on the stn and the seed
+        rng.seed(seed);
+        if(exactBudget > 0 && disjuctiveConstraints.size() <= exactMaxDisjuncts)
         {
-            auto editedSecond = editedActionTimes.find(second);
-            auto editedFirst  = editedActionTimes.find(first);
-
-            float secondStart;
-            float secondEnd;
-            float firstStart;
-            float firstEnd;
-
-            if(editedSecond != editedActionTimes.end())
+            BranchAndBound exact(exactBudget);
+            if(exact.solve(*this))
             {
-                secondStart = editedSecond->second[0];
-                secondEnd   = editedSecond->second[1];
-            }
-            else
-            {
-                secondStart = stn[second][0];
-                secondEnd   = stn[second][1];
+                *this   = exact.solution();
+                optimal = true;
+                return;
             }
 
-            if(editedFirst != editedActionTimes.end())
+            tabu search;
+            Scheduler heuristic = search.solve(1, *this);
+            if(exact.hasSolution() && exact.makespan() < heuristic.getMakeSpan())
             {
-                firstStart = editedFirst->second[0];
-                firstEnd   = editedFirst->second[1];
+                *this = exact.solution();
             }
             else
             {
-                firstStart = stn[first][0];
-                firstEnd   = stn[first][1];
+                *this = heuristic;
             }
+            optimal = false;
+            return;
+        }
+        tabu search;
+        *this   = search.solve(1, *this);
+        optimal = false;
+    }
 
-            if(secondStart < firstEnd)
-            {
-                float duration            = secondEnd - secondStart;
-                editedActionTimes[second] = {firstEnd, firstEnd + duration};
+    void Scheduler::setExactSearch(float budget, int maxDisjuncts)
+    {
+        exactBudget       = budget;
+        exactMaxDisjuncts = maxDisjuncts;
+    }
+
+    bool Scheduler::isOptimal() const
+    {
+        return optimal;
+    }
+
+    void Scheduler::setSeed(unsigned int s)
+    {
+        seed = s;
+        rng.seed(seed);
+    }
+
+
+    void Scheduler::initOrder()
+    {
+        topologicalOrder.resize(stn.size());
+        std::iota(topologicalOrder.begin(), topologicalOrder.end(), 0);
+        topologicalIndex = topologicalOrder;
+        marks.assign(stn.size(), 0);
+        mark = 0;
+    }
+
+    uint32_t Scheduler::nextMark()
+    {
+        if(marks.size() < stn.size())
+        {
+            marks.resize(stn.size(), 0);
+        }
+        if(++mark == 0)
+        {
+            std::fill(marks.begin(), marks.end(), 0);
+            mark = 1;
+        }
+        return mark;
+    }
 
-                if(newMakespan != -1 && secondEnd > newMakespan)
+    bool Scheduler::reachable(int from, int to)
+    {
+        const int upper = topologicalIndex[to];
+        if(topologicalIndex[from] > upper)
+        {
+            return false;
+        }
+        const uint32_t m = nextMark();
+        forwardSet.clear();
+        forwardSet.push_back(from);
+        marks[from] = m;
+        for(int k = 0; k < forwardSet.size(); ++k)
+        {
+            for(int next: beforeConstraints[forwardSet[k]])
+            {
+                if(next == to)
                 {
-                    newMakespan = secondEnd;
+                    return true;
                 }
-                for(int i = 0; i < beforeConstraints[second].size(); ++i)
+                if(marks[next] != m && topologicalIndex[next] < upper)
                 {
-                    if(second != originalSecond || beforeConstraints[second][i] != originalFirst)
-                    {
-                        constraintsToUpdate.emplace_back(second);
-                        constraintsToUpdate.emplace_back(beforeConstraints[second][i]);
-                    }
-                }
-            }
-            // constraintsToUpdate.erase(constraintsToUpdate.begin());
-            constrainToAdjust += 2;
-            if(constrainToAdjust < constraintsToUpdate.size())
-            {
-                first  = constraintsToUpdate[constrainToAdjust];
-                second = constraintsToUpdate[constrainToAdjust + 1];
-                if(second == originalFirst)
-                {
-                    return -1;
+                    marks[next] = m;
+                    forwardSet.push_back(next);
                 }
             }
         }
-
-        return newMakespan;
+        return false;
     }
 
-    float Scheduler::removeOCTime2(int first, int second)
+    bool Scheduler::insertOrder(int first, int second)
     {
-        constraintsToUpdate.clear();
-        float currentDelay = 0;
-        robin_hood::unordered_map<int, std::vector<float>> editedActionTimes;
+        const int lower = topologicalIndex[second];
+        const int upper = topologicalIndex[first];
+        if(upper < lower)
+        {
+            return true;
+        }
 
-        float maxDelay = std::numeric_limits<float>::max();
-        if(stn[first][1] == stn[second][0])
+        // Actions after second that must move behind first; reaching first means a cycle
+        if(reachable(second, first) || first == second)
         {
-            for(int i: afterConstraints[second])
+            return false;
+        }
+
+        // Actions before first that must move ahead of second
+        const uint32_t m = nextMark();
+        backwardSet.clear();
+        backwardSet.push_back(first);
+        marks[first] = m;
+        for(int k = 0; k < backwardSet.size(); ++k)
+        {
+            for(int previous: afterConstraints[backwardSet[k]])
             {
-                if(i != first && stn[i][1] > maxDelay)
+                if(marks[previous] != m && topologicalIndex[previous] > lower)
                 {
-                    maxDelay = stn[i][1];
+                    marks[previous] = m;
+                    backwardSet.push_back(previous);
                 }
             }
-            float duration            = stn[second][1] - stn[second][0];
-            editedActionTimes[second] = {maxDelay, maxDelay + duration};
+        }
 
-            for(int i = 0; i < beforeConstraints[second].size(); ++i)
+        // Reuse the positions of both sets, placing the backward set first and keeping the order within each set
+        auto byIndex = [this](int a, int b) {
+            return topologicalIndex[a] < topologicalIndex[b];
+        };
+        std::sort(forwardSet.begin(), forwardSet.end(), byIndex);
+        std::sort(backwardSet.begin(), backwardSet.end(), byIndex);
+        positions.clear();
+        for(int action: backwardSet)
+        {
+            positions.push_back(topologicalIndex[action]);
+        }
+        for(int action: forwardSet)
+        {
+            positions.push_back(topologicalIndex[action]);
+        }
+        std::sort(positions.begin(), positions.end());
+        int k = 0;
+        for(int action: backwardSet)
+        {
+            topologicalOrder[positions[k++]] = action;
+        }
+        for(int action: forwardSet)
+        {
+            topologicalOrder[positions[k++]] = action;
+        }
+        for(int p: positions)
+        {
+            topologicalIndex[topologicalOrder[p]] = p;
+        }
+        return true;
+    }
+
+    void Scheduler::propagate(int actionIndex, bool changed)
+    {
+        const uint32_t m    = nextMark();
+        marks[actionIndex] = m;
+        int pending         = 1;
+        for(int p = topologicalIndex[actionIndex]; pending > 0 && p < topologicalOrder.size(); ++p)
+        {
+            const int action = topologicalOrder[p];
+            if(marks[action] != m)
             {
-                constraintsToUpdate.emplace_back(second);
-                constraintsToUpdate.emplace_back(beforeConstraints[second][i]);
+                continue;
             }
-            if(!constraintsToUpdate.empty())
+            --pending;
+
+            float start = 0;
+            for(int previous: afterConstraints[action])
             {
-                first  = constraintsToUpdate[0];
-                second = constraintsToUpdate[1];
+                start = std::max(start, stn[previous][1]);
             }
-            int constrainToAdjust = 0;
-
-            float secondStart;
-            float secondEnd;
-            float firstStart;
-            float firstEnd;
-
-            while(constrainToAdjust < constraintsToUpdate.size())
+            if(start != stn[action][0] || (action == actionIndex && changed))
             {
-                float duration    = stn[second][1] - stn[second][0];
-                auto editedSecond = editedActionTimes.find(second);
-                auto editedFirst  = editedActionTimes.find(first);
-
-                if(editedSecond != editedActionTimes.end())
+                if(logSTN)
                 {
-                    secondStart = editedSecond->second[0];
-                    secondEnd   = editedSecond->second[1];
+                    stnLog.emplace_back(action, stn[action][0], stn[action][1]);
                 }
-                else
+                const float duration = stn[action][1] - stn[action][0];
+                stn[action][0]       = start;
+                stn[action][1]       = start + duration;
+                for(int next: beforeConstraints[action])
                 {
-                    secondStart = stn[second][0];
-                    secondEnd   = stn[second][1];
-                }
-
-                if(editedFirst != editedActionTimes.end())
-                {
-                    firstStart = editedFirst->second[0];
-                    firstEnd   = editedFirst->second[1];
-                }
-                else
-                {
-                    firstStart = stn[first][0];
-                    firstEnd   = stn[first][1];
-                }
-
-                maxDelay     = 0;
-                currentDelay = 0;
-                for(int i: afterConstraints[second])
-                {
-                    auto aftConTime = editedActionTimes.find(i);
-                    if(aftConTime != editedActionTimes.end())
-                    {
-                        currentDelay = aftConTime->second[1];
-                    }
-                    else
-                    {
-                        currentDelay = stn[i][1];
-                    }
-                    if(currentDelay > maxDelay)
-                    {
-                        maxDelay = currentDelay;
-                    }
-                }
-                if(secondStart != maxDelay)
-                {
-                    float newduration         = secondEnd - secondStart;
-                    editedActionTimes[second] = {maxDelay, maxDelay + newduration};
-                    for(int i = 0; i < beforeConstraints[second].size(); ++i)
+                    if(marks[next] != m)
                     {
-                        constraintsToUpdate.emplace_back(second);
-                        constraintsToUpdate.emplace_back(beforeConstraints[second][i]);
+                        marks[next] = m;
+                        ++pending;
                     }
                 }
-
-                constrainToAdjust += 2;
-                if(constrainToAdjust < constraintsToUpdate.size())
-                {
-                    first  = constraintsToUpdate[constrainToAdjust];
-                    second = constraintsToUpdate[constrainToAdjust + 1];
-                }
-            }
-
-            maxDelay         = 0;
-            float actionTime = 0;
-            for(int i = 0; i < stn.size(); ++i)
-            {
-                auto actTime = editedActionTimes.find(i);
-                if(actTime != editedActionTimes.end())
-                {
-                    actionTime = actTime->second[1];
-                }
-                else
-                {
-                    actionTime = stn[i][1];
-                }
-                if(actionTime > maxDelay)
-                {
-                    maxDelay = actionTime;
-                }
             }
         }
-        return maxDelay;
     }
 
 }  // namespace grstaps
@@ -2,11 +2,77 @@
 #define TABU_CPP
 
 #include <grstaps/Scheduling/tabu.h>
+#include <grstaps/profiler.hpp>
 
 namespace grstaps
 {
+    TabuMemory::TabuMemory()
+        : entries(64, Entry{0, 0, 0, 0})
+        , mask(63)
+        , count(0)
+        , generation(1)
+    {}
+
+    // The keys are already zobrist hashes, so their low bits are uniform
+    size_t TabuMemory::slot(uint64_t key) const
+    {
+        size_t i = key & mask;
+        while(entries[i].generation == generation && entries[i].key != key)
+        {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    const TabuMemory::Entry* TabuMemory::find(uint64_t key) const
+    {
+        const Entry& e = entries[slot(key)];
+        return e.generation == generation ? &e : nullptr;
+    }
+
+    void TabuMemory::set(uint64_t key, int tabuUntil, float makespan)
+    {
+        Entry* e = &entries[slot(key)];
+        if(e->generation != generation)
+        {
+            if(2 * (count + 1) > entries.size())
+            {
+                grow();
+                e = &entries[slot(key)];
+            }
+            ++count;
+        }
+        *e = Entry{key, generation, tabuUntil, makespan};
+    }
+
+    void TabuMemory::clear()
+    {
+        count = 0;
+        if(++generation == 0)
+        {
+            // The counter wrapped, so stale entries could look current
+            std::fill(entries.begin(), entries.end(), Entry{0, 0, 0, 0});
+            generation = 1;
+        }
+    }
+
+    void TabuMemory::grow()
+    {
+        std::vector<Entry> old(2 * entries.size(), Entry{0, 0, 0, 0});
+        old.swap(entries);
+        mask = entries.size() - 1;
+        for(const Entry& e: old)
+        {
+            if(e.generation == generation)
+            {
+                entries[slot(e.key)] = e;
+            }
+        }
+    }
+
     Scheduler tabu::solve(int numCandidate, Scheduler& initialSched)
     {
+        GRSTAPS_PROFILE_ZONE(Tabu);
         optimal           = ( initialSched.worstSchedule - initialSched.getMakeSpan()) * 0.3 + initialSched.getMakeSpan();
         bestSolutionScore = std::numeric_limits<double>::max();
         for(int loopCount = 0; loopCount < numCandidate; loopCount++)
@@ -54,42 +120,29 @@ namespace grstaps
 
     void tabu::getBestNearbySolution(int it)
     {
-        float bestScore          = std::numeric_limits<float>::max();
-        int bestDisSwitch        = -1;
-        std::string currentDisID = currentSched.getDisjuctiveID();
-        std::string id;
+        float bestScore   = std::numeric_limits<float>::max();
+        int bestDisSwitch = -1;
 
         for(int i = 0; i < currentSched.getDisjuctiveSize(); i++)
         {
-            if(currentDisID[i])
-            {
-                id    = currentDisID;
-                id[i] = 0;
-            }
-            else
-            {
-                id    = currentDisID;
-                id[i] = 1;
-            }
+            // Switching ordering i only xors its key into the hash
+            const uint64_t id     = currentSched.getDisjuctiveSwitchID(i);
             float currentMakespan = -1;
-            auto found            = tabu_list.find(id);
-            if(found == tabu_list.end())
+            const TabuMemory::Entry* found = tabu_list.find(id);
+            if(found == nullptr)
             {
                 currentMakespan = currentSched.getShedSwitchTime(i);
             }
-            else if(found->second <= it)
+            else if(found->tabuUntil <= it)
             {
-                // currentMakespan = foundMakespans.find(id)->second;
-                // currentMakespan = found->second;
-                currentMakespan = foundMakespans.at(id);
+                currentMakespan = found->makespan;
             }
 
             if(currentMakespan > 0 && (bestScore > currentMakespan))
             {
-                bestDisSwitch      = i;
-                bestScore          = currentMakespan;
-                tabu_list[id]      = (it + TABU_LENGTH);
-                foundMakespans[id] = currentMakespan;
+                bestDisSwitch = i;
+                bestScore     = currentMakespan;
+                tabu_list.set(id, it + TABU_LENGTH, currentMakespan);
             }
         }
         if(bestDisSwitch < 0)
@@ -39,6 +39,12 @@ namespace grstaps
         : heuristicFunc(heur)
         , costFunc(cost)
     {}
+
+    template <class Data>
+    bool NodeExpander<Data>::reevaluate(Graph<Data>&, nodePtr<Data>) const
+    {
+        return false;
+    }
 }  // namespace grstaps
 
 #endif  // GRSTAPS_NODEEXPANDERCPP
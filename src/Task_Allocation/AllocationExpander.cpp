@@ -21,6 +21,8 @@
 
 #include "grstaps/Task_Allocation/AllocationExpander.h"
 
+#include "grstaps/profiler.hpp"
+
 namespace grstaps
 {
     template <typename Data>
@@ -33,6 +35,7 @@ namespace grstaps
     // check to prevent duplicate
     bool AllocationExpander::operator()(Graph<TaskAllocation>& graph, nodePtr<TaskAllocation> expandNode) const
     {
+        GRSTAPS_PROFILE_ZONE(AllocationExpand);
         TaskAllocation data       = expandNode->getData();
         vector<short> allocation  = data.getAllocation();
         std::string nodeID        = expandNode->getNodeID();
@@ -72,6 +75,22 @@ namespace grstaps
         return true;
     }
 
+    bool AllocationExpander::reevaluate(Graph<TaskAllocation>& graph, nodePtr<TaskAllocation> node) const
+    {
+        TaskAllocation& data = node->getData();
+        if(!data.isScheduleLowerBound())
+        {
+            return false;
+        }
+
+        const float bound = node->getHeuristic();
+        data.getExactScheduleTime();
+        const float heur = (*this->heuristicFunc)(graph, data, data);
+        node->setHeuristic(heur);
+        node->setPathCost(heur);
+        return heur > bound;
+    }
+
     std::string AllocationExpander::editID(const vector<short>& allocation, const std::string& parentNodeID, int indexExp) const
     {
         int idSize       = parentNodeID.length() / (allocation.size());
@@ -17,6 +17,7 @@
  */
 
 #include "grstaps/Task_Allocation/TaskAllocation.h"
+#include <algorithm>
 #include <utility>
 
 #include <boost/shared_ptr.hpp>
@@ -148,6 +149,7 @@ namespace grstaps
         goalTraitDistribution         = copyAllocation.goalTraitDistribution;
 
         scheduleTime                = copyAllocation.scheduleTime;
+        scheduleLowerBound          = copyAllocation.scheduleLowerBound;
         goalDistance                = copyAllocation.goalDistance;
         isGoal                      = copyAllocation.isGoal;
         allocation                  = copyAllocation.allocation;
@@ -434,7 +436,8 @@ namespace grstaps
 
     float TaskAllocation::getScheduleTime()
     {
-        if(scheduleTime > 0)
+        // 0 marks an allocation whose motion plans were found to be infeasible by getExactScheduleTime
+        if(scheduleTime >= 0)
         {
             return scheduleTime;
         }
@@ -442,7 +445,8 @@ namespace grstaps
         {
             if(!usingSpecies)
             {
-                scheduleTime = taToScheduling.getNonSpeciesSchedule(this);
+                scheduleLowerBound = taToScheduling.lazyMotionPlanning();
+                scheduleTime       = taToScheduling.getNonSpeciesSchedule(this, scheduleLowerBound);
             }
             else
             {
@@ -452,6 +456,23 @@ namespace grstaps
         }
     }
 
+    float TaskAllocation::getExactScheduleTime()
+    {
+        getScheduleTime();
+        if(!isScheduleLowerBound())
+        {
+            return scheduleTime;
+        }
+        scheduleLowerBound = false;
+        scheduleTime       = std::max(taToScheduling.getNonSpeciesSchedule(this, false), 0.0f);
+        return scheduleTime;
+    }
+
+    bool TaskAllocation::isScheduleLowerBound() const
+    {
+        return scheduleLowerBound && scheduleTime > 0;
+    }
+
     void TaskAllocation::addAction(const vector<float>& actionRequirements,
                                    const vector<float>& noncumTraitCutoff,
                                    const float newActionDuration,
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C)2020 Andrew Messing
+ *
+ * GRSTAPS is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 3 of the License,
+ * or any later version.
+ *
+ * GRSTAPS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GRSTAPS; if not, write to the Free Software Foundation,
+ * Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "grstaps/compiled_map.hpp"
+
+// global
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+// external
+#include <box2d/b2_polygon_shape.h>
+
+// local
+#include "grstaps/json_conversions.hpp"
+
+namespace grstaps
+{
+    namespace
+    {
+        constexpr char s_magic[8]    = {'G', 'R', 'S', 'T', 'A', 'P', 'S', 'M'};
+        constexpr uint32_t s_version = 1;
+
+        void convertToPaths(ClipperLib2::Paths& rv, const std::vector<std::vector<b2Vec2>>& shapes)
+        {
+            for(const std::vector<b2Vec2>& shape: shapes)
+            {
+                ClipperLib2::Path polygon;
+                for(const b2Vec2& point: shape)
+                {
+                    polygon.push_back(ClipperLib2::IntPoint(point.x * 1E6, point.y * 1E6));
+                }
+
+                // If "hole" flip it
+                const float area = ClipperLib2::Area(polygon);
+                if(area < 0.0)
+                {
+                    std::reverse(polygon.begin(), polygon.end());
+                }
+                rv.push_back(polygon);
+            }
+        }
+
+        template <typename T>
+        void writeValue(std::ofstream& output, const T& value)
+        {
+            output.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        T readValue(std::ifstream& input)
+        {
+            T value;
+            if(!input.read(reinterpret_cast<char*>(&value), sizeof(T)))
+            {
+                throw std::runtime_error("Compiled map is truncated");
+            }
+            return value;
+        }
+    }  // namespace
+
+    CompiledMap CompiledMap::compile(const nlohmann::json& map)
+    {
+        CompiledMap rv;
+
+        // Ground
+        ClipperLib2::Paths ground;
+        convertToPaths(ground, map["buildings"].get<std::vector<std::vector<b2Vec2>>>());
+        convertToPaths(ground, map["roads"].get<std::vector<std::vector<b2Vec2>>>());
+
+        // union/smooth out
+        {
+            ClipperLib2::Clipper clipper;
+            clipper.AddPaths(ground, ClipperLib2::ptSubject, true);
+            clipper.Execute(ClipperLib2::ctUnion, ground, ClipperLib2::pftNonZero, ClipperLib2::pftNonZero);
+
+            ClipperLib2::ClipperOffset clipper_offset;
+            clipper_offset.AddPaths(ground, ClipperLib2::jtMiter, ClipperLib2::etClosedPolygon);
+            clipper_offset.Execute(ground, 1E5);
+            clipper_offset.Clear();
+            clipper_offset.AddPaths(ground, ClipperLib2::jtMiter, ClipperLib2::etClosedPolygon);
+            clipper_offset.Execute(ground, -1E5);
+        }
+
+        // Drop the duplicate and collinear vertices that the offsets leave behind
+        ClipperLib2::CleanPolygons(ground);
+        rv.maps.push_back(ground);
+
+        rv.boundaryMin = std::numeric_limits<float>::max();
+        rv.boundaryMax = std::numeric_limits<float>::min();
+        for(const ClipperLib2::Path& poly: ground)
+        {
+            for(const ClipperLib2::IntPoint& point: poly)
+            {
+                rv.boundaryMin = std::min<float>(static_cast<float>(std::min(point.X, point.Y)), rv.boundaryMin);
+                rv.boundaryMax = std::max<float>(static_cast<float>(std::max(point.X, point.Y)), rv.boundaryMax);
+            }
+        }
+        rv.boundaryMax += 10;
+        rv.boundaryMin -= 10;
+
+        // Aerial
+        ClipperLib2::Path boundary = {ClipperLib2::IntPoint(rv.boundaryMin, rv.boundaryMin),
+                                      ClipperLib2::IntPoint(rv.boundaryMin, rv.boundaryMax),
+                                      ClipperLib2::IntPoint(rv.boundaryMax, rv.boundaryMax),
+                                      ClipperLib2::IntPoint(rv.boundaryMax, rv.boundaryMin)};
+        if(ClipperLib2::Area(boundary) < 0)
+        {
+            std::reverse(boundary.begin(), boundary.end());
+        }
+        rv.maps.push_back({boundary});
+
+        rv.longestPerimeter = 0;
+        for(const ClipperLib2::Paths& species_map: rv.maps)
+        {
+            double perimeter = 0;
+            for(const ClipperLib2::Path& poly: species_map)
+            {
+                for(unsigned int i = 0; i < poly.size(); ++i)
+                {
+                    const ClipperLib2::IntPoint& next = poly[(i + 1) % poly.size()];
+                    perimeter += std::hypot(double(poly[i].X - next.X), double(poly[i].Y - next.Y));
+                }
+            }
+            rv.longestPerimeter = std::max<float>(rv.longestPerimeter, perimeter);
+        }
+        return rv;
+    }
+
+    CompiledMap CompiledMap::load(const std::string& filepath)
+    {
+        if(!isCompiled(filepath))
+        {
+            std::ifstream ifs(filepath);
+            nlohmann::json map;
+            ifs >> map;
+            return compile(map);
+        }
+
+        std::ifstream input(filepath, std::ios::binary);
+        input.seekg(sizeof(s_magic));
+        if(readValue<uint32_t>(input) != s_version)
+        {
+            throw std::runtime_error("Compiled map is from another version, recompile it");
+        }
+
+        CompiledMap rv;
+        rv.boundaryMin      = readValue<float>(input);
+        rv.boundaryMax      = readValue<float>(input);
+        rv.longestPerimeter = readValue<float>(input);
+        rv.maps.resize(readValue<uint32_t>(input));
+        for(ClipperLib2::Paths& species_map: rv.maps)
+        {
+            species_map.resize(readValue<uint32_t>(input));
+            for(ClipperLib2::Path& poly: species_map)
+            {
+                poly.resize(readValue<uint32_t>(input));
+                for(ClipperLib2::IntPoint& point: poly)
+                {
+                    point.X = readValue<int64_t>(input);
+                    point.Y = readValue<int64_t>(input);
+                }
+            }
+        }
+        return rv;
+    }
+
+    bool CompiledMap::isCompiled(const std::string& filepath)
+    {
+        std::ifstream input(filepath, std::ios::binary);
+        char magic[sizeof(s_magic)];
+        return input.read(magic, sizeof(magic)) && std::memcmp(magic, s_magic, sizeof(magic)) == 0;
+    }
+
+    void CompiledMap::write(const std::string& filepath) const
+    {
+        std::ofstream output(filepath, std::ios::binary);
+        output.write(s_magic, sizeof(s_magic));
+        writeValue<uint32_t>(output, s_version);
+        writeValue<float>(output, boundaryMin);
+        writeValue<float>(output, boundaryMax);
+        writeValue<float>(output, longestPerimeter);
+        writeValue<uint32_t>(output, maps.size());
+        for(const ClipperLib2::Paths& species_map: maps)
+        {
+            writeValue<uint32_t>(output, species_map.size());
+            for(const ClipperLib2::Path& poly: species_map)
+            {
+                writeValue<uint32_t>(output, poly.size());
+                for(const ClipperLib2::IntPoint& point: poly)
+                {
+                    writeValue<int64_t>(output, point.X);
+                    writeValue<int64_t>(output, point.Y);
+                }
+            }
+        }
+    }
+}  // namespace grstaps
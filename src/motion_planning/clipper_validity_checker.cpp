@@ -17,6 +17,10 @@
  */
 #include "grstaps/motion_planning/clipper_validity_checker.hpp"
 
+// global
+#include <algorithm>
+#include <limits>
+
 // external
 #include <ompl/base/spaces/RealVectorStateSpace.h>
 
@@ -28,7 +32,25 @@ namespace grstaps
                                      const ob::SpaceInformationPtr& space_information)
         : ob::StateValidityChecker(space_information)
         , m_internals(internals)
-    {}
+    {
+        // Bounding boxes let most polygons be skipped without the point in polygon test
+        m_bounds.reserve(m_internals.size());
+        for(const ClipperLib2::Path& poly: m_internals)
+        {
+            std::array<ClipperLib2::cInt, 4> bounds = {std::numeric_limits<ClipperLib2::cInt>::max(),
+                                                       std::numeric_limits<ClipperLib2::cInt>::max(),
+                                                       std::numeric_limits<ClipperLib2::cInt>::min(),
+                                                       std::numeric_limits<ClipperLib2::cInt>::min()};
+            for(const ClipperLib2::IntPoint& point: poly)
+            {
+                bounds[0] = std::min(bounds[0], point.X);
+                bounds[1] = std::min(bounds[1], point.Y);
+                bounds[2] = std::max(bounds[2], point.X);
+                bounds[3] = std::max(bounds[3], point.Y);
+            }
+            m_bounds.push_back(bounds);
+        }
+    }
 
     bool ClipperValidityChecker::isValid(const ob::State* state) const
     {
@@ -36,10 +58,15 @@ namespace grstaps
         ClipperLib2::IntPoint point(state_2d->values[0] * 1E6, state_2d->values[1] * 1E6);
 
         int poly_count_inside = 0;
-        for (ClipperLib2::Path poly : m_internals)
+        for (unsigned int i = 0; i < m_internals.size(); ++i)
         {
+            const std::array<ClipperLib2::cInt, 4>& bounds = m_bounds[i];
+            if (point.X < bounds[0] || point.Y < bounds[1] || point.X > bounds[2] || point.Y > bounds[3])
+            {
+                continue;
+            }
             const int is_inside_this_poly =
-                ClipperLib2::PointInPolygon(point, poly);
+                ClipperLib2::PointInPolygon(point, m_internals[i]);
             if (is_inside_this_poly == -1)
             {
                 return true;
@@ -17,6 +17,9 @@
  */
 #include "grstaps/motion_planning/motion_planner.hpp"
 
+// global
+#include <algorithm>
+
 // external
 #include <ompl/base/ProblemDefinition.h>
 #include <ompl/base/objectives/PathLengthOptimizationObjective.h>
@@ -26,6 +29,7 @@
 // local
 #include "grstaps/motion_planning/clipper_validity_checker.hpp"
 #include "grstaps/motion_planning/validity_checker.hpp"
+#include "grstaps/profiler.hpp"
 #include "grstaps/timer.hpp"
 
 namespace grstaps
@@ -33,9 +37,19 @@ namespace grstaps
     namespace ob = ompl::base;
     namespace og = ompl::geometric;
 
+    namespace
+    {
+        //! Distance of a pair of locations that has not been planned yet
+        constexpr float s_unknown = -2;
+    }
+
     MotionPlanner::MotionPlanner()
         : m_map_set(false)
         , m_query_time(1.0)
+        , m_connection_range(0)
+        , m_roadmap_size(0)
+        , m_use_visibility_graph(false)
+        , m_robot_radius(0)
     {
         ompl::msg::noOutputHandler();
     }
@@ -58,6 +72,10 @@ namespace grstaps
         m_planner = std::make_shared<og::LazyPRM>(m_space_information);
         m_planner->setup();
 
+        m_roadmap.reset();
+        m_clipper_map.clear();
+        m_visibility_graph.reset();
+        resetMemory();
         m_map_set = true;
     }
 
@@ -76,21 +94,59 @@ namespace grstaps
         }
         std::lock_guard<std::mutex> lock(m_mutex);
         std::dynamic_pointer_cast<og::LazyPRMstar>(m_planner)->setRange(range);
+        m_connection_range = range;
+        m_roadmap.reset();
     }
 
     void MotionPlanner::setLocations(const std::vector<Location>& locations)
     {
         std::lock_guard<std::mutex> lock(m_mutex);
         m_locations = locations;
+        m_roadmap.reset();
+        if(m_visibility_graph)
+        {
+            m_visibility_graph->setLocations(m_locations);
+        }
+        resetMemory();
+    }
+
+    void MotionPlanner::setRoadmapSize(unsigned int num_milestones)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_roadmap_size = num_milestones;
+        m_roadmap.reset();
+    }
+
+    void MotionPlanner::setVisibilityGraph(bool enabled, float robot_radius)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_use_visibility_graph = enabled;
+        m_robot_radius         = robot_radius;
+        buildVisibilityGraph();
+        resetMemory();
     }
 
     std::pair<bool, float> MotionPlanner::query(unsigned int from, unsigned int to)
     {
         assert(from < m_locations.size() && to < m_locations.size());
-        m_timer.start();
-        auto rv = getWaypoints(from, to);
-        m_timer.stop();
-        return std::make_pair(std::get<0>(rv), std::get<1>(rv));
+        GRSTAPS_PROFILE_ZONE(MotionPlanningQuery);
+        if(from == to)
+        {
+            return std::make_pair(false, -1);
+        }
+
+        // Answered paths are only ever written once, so a known distance can be read without the lock
+        float distance = m_distances[from * m_locations.size() + to].load(std::memory_order_acquire);
+        if(distance == s_unknown)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            distance = plan(from, to);
+        }
+        else
+        {
+            GRSTAPS_PROFILE_COUNT(MotionPlanningCacheHit);
+        }
+        return std::make_pair(distance >= 0, distance);
     }
 
     bool floatEqual(const float a, const float b, const float epsilon=1e-6)
@@ -106,10 +162,47 @@ namespace grstaps
         {
             return std::make_tuple(false, -1, std::vector<std::pair<float, float>>());
         }
-        auto id = std::make_pair(from, to);
-        if(m_memory.find(id) != m_memory.end())
+
+        const float distance   = plan(from, to);
+        const PathRange& range = m_paths[from * m_locations.size() + to];
+        std::vector<std::pair<float, float>> waypoints(m_waypoints.begin() + range.offset,
+                                                       m_waypoints.begin() + range.offset + range.count);
+        if(range.reversed)
+        {
+            std::reverse(waypoints.begin(), waypoints.end());
+        }
+        return std::make_tuple(distance >= 0, distance, waypoints);
+    }
+
+    float MotionPlanner::plan(unsigned int from, unsigned int to)
+    {
+        const unsigned int id = from * m_locations.size() + to;
+        float distance        = m_distances[id].load(std::memory_order_relaxed);
+        if(distance != s_unknown)
+        {
+            GRSTAPS_PROFILE_COUNT(MotionPlanningCacheHit);
+            return distance;
+        }
+        GRSTAPS_PROFILE_COUNT(MotionPlanningCacheMiss);
+        m_timer.start();
+
+        if(m_visibility_graph)
+        {
+            VisibilityGraph::Path path = m_visibility_graph->query(from, to);
+            remember(from, to, std::get<0>(path), std::get<1>(path), std::get<2>(path));
+            m_timer.stop();
+            return m_distances[id].load(std::memory_order_relaxed);
+        }
+
+        if(m_roadmap_size > 0)
         {
-            return m_memory[id];
+            roadmapQuery(from);
+            distance = m_distances[id].load(std::memory_order_relaxed);
+            if(distance != s_unknown)
+            {
+                m_timer.stop();
+                return distance;
+            }
         }
 
         auto problem = std::make_shared<ob::ProblemDefinition>(m_space_information);
@@ -118,9 +211,9 @@ namespace grstaps
         ob::PathPtr path               = problem->getSolutionPath();
         if(!path)
         {
-            auto val = std::make_tuple(false, -1, std::vector<std::pair<float, float>>());
-            m_memory[id] = val;
-            return val;
+            remember(from, to, false, -1, std::vector<std::pair<float, float>>());
+            m_timer.stop();
+            return -1;
         }
         auto path_geometric            = path->as<og::PathGeometric>();
         std::vector<ob::State*> states = path_geometric->getStates();
@@ -137,9 +230,68 @@ namespace grstaps
             }
             waypoints.push_back(std::make_pair(x, y));
         }
-        auto val = std::make_tuple(true, problem->getSolutionPath()->length(), waypoints);
-        m_memory[id] = val;
-        return val;
+        remember(from, to, true, path->length(), waypoints);
+        m_timer.stop();
+        return m_distances[id].load(std::memory_order_relaxed);
+    }
+
+    void MotionPlanner::remember(unsigned int from,
+                                 unsigned int to,
+                                 bool found,
+                                 float length,
+                                 const std::vector<std::pair<float, float>>& waypoints)
+    {
+        const unsigned int n = m_locations.size();
+        if(m_distances[from * n + to].load(std::memory_order_relaxed) != s_unknown)
+        {
+            return;
+        }
+
+        // Paths are symmetric, so the reverse direction shares the waypoints
+        const unsigned int offset = m_waypoints.size();
+        const unsigned int count  = found ? waypoints.size() : 0;
+        m_waypoints.insert(m_waypoints.end(), waypoints.begin(), waypoints.begin() + count);
+        m_paths[from * n + to] = PathRange{offset, count, false};
+        m_paths[to * n + from] = PathRange{offset, count, true};
+
+        // Published last so a lock free reader never sees a distance before its path
+        m_distances[to * n + from].store(found ? length : -1, std::memory_order_release);
+        m_distances[from * n + to].store(found ? length : -1, std::memory_order_release);
+    }
+
+    void MotionPlanner::resetMemory()
+    {
+        const unsigned int n = m_locations.size();
+        m_distances          = std::make_unique<std::atomic<float>[]>(n * n);
+        for(unsigned int i = 0; i < n * n; ++i)
+        {
+            m_distances[i].store(s_unknown, std::memory_order_relaxed);
+        }
+        m_paths.assign(n * n, PathRange{0, 0, false});
+        m_waypoints.clear();
+    }
+
+    void MotionPlanner::roadmapQuery(unsigned int from)
+    {
+        if(!m_roadmap)
+        {
+            m_roadmap = std::make_unique<Roadmap>(m_space_information, m_locations, m_roadmap_size, m_connection_range);
+            m_roadmap_sources.assign(m_locations.size(), false);
+        }
+        if(m_roadmap_sources[from])
+        {
+            return;
+        }
+        m_roadmap_sources[from] = true;
+
+        std::vector<Roadmap::Path> paths = m_roadmap->query(from);
+        for(unsigned int to = 0; to < paths.size(); ++to)
+        {
+            if(std::get<0>(paths[to]))
+            {
+                remember(from, to, true, std::get<1>(paths[to]), std::get<2>(paths[to]));
+            }
+        }
     }
 
     bool MotionPlanner::waypointQuery(unsigned int from, unsigned int to, ompl::base::ProblemDefinitionPtr problem_def)
@@ -188,8 +340,24 @@ namespace grstaps
         m_planner = std::make_shared<og::LazyPRMstar>(m_space_information);
         m_planner->setup();
 
+        m_roadmap.reset();
+        m_clipper_map = map;
+        buildVisibilityGraph();
+        resetMemory();
         m_map_set = true;
     }
+
+    void MotionPlanner::buildVisibilityGraph()
+    {
+        m_visibility_graph.reset();
+        if(m_use_visibility_graph && !m_clipper_map.empty())
+        {
+            m_timer.start();
+            m_visibility_graph = std::make_unique<VisibilityGraph>(m_clipper_map, m_locations, m_robot_radius);
+            m_timer.stop();
+        }
+    }
+
     float MotionPlanner::getTotalTime() const
     {
         return m_timer.get();
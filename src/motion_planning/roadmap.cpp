@@ -0,0 +1,194 @@
+/*
+ * Copyright (C)2020 Andrew Messing
+ *
+ * GRSTAPS is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 3 of the License,
+ * or any later version.
+ *
+ * GRSTAPS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GRSTAPS; if not, write to the Free Software Foundation,
+ * Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "grstaps/motion_planning/roadmap.hpp"
+
+// global
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+// external
+#include <ompl/base/ScopedState.h>
+#include <ompl/base/spaces/RealVectorStateSpace.h>
+
+namespace grstaps
+{
+    namespace ob = ompl::base;
+
+    namespace
+    {
+        constexpr unsigned int s_no_edge = std::numeric_limits<unsigned int>::max();
+    }
+
+    Roadmap::Roadmap(const ob::SpaceInformationPtr& space_information,
+                     const std::vector<Location>& locations,
+                     unsigned int num_milestones,
+                     float connection_range)
+        : m_space_information(space_information)
+        , m_num_locations(locations.size())
+    {
+        ob::ScopedState<> state(m_space_information);
+        for(const Location& location: locations)
+        {
+            state->as<ob::RealVectorStateSpace::StateType>()->values[0] = location.x();
+            state->as<ob::RealVectorStateSpace::StateType>()->values[1] = location.y();
+            m_vertices.emplace_back(location.x(), location.y());
+            m_vertex_valid.push_back(m_space_information->isValid(state.get()));
+        }
+
+        ob::StateSamplerPtr sampler = m_space_information->allocStateSampler();
+        for(unsigned int attempt = 0; attempt < 100 * num_milestones && m_vertices.size() < m_num_locations + num_milestones;
+            ++attempt)
+        {
+            sampler->sampleUniform(state.get());
+            if(m_space_information->isValid(state.get()))
+            {
+                m_vertices.emplace_back(state->as<ob::RealVectorStateSpace::StateType>()->values[0],
+                                        state->as<ob::RealVectorStateSpace::StateType>()->values[1]);
+                m_vertex_valid.push_back(true);
+            }
+        }
+
+        // PRM* connection rule for a two dimensional space: k = e (1 + 1/d) log(n)
+        m_adjacency.resize(m_vertices.size());
+        const unsigned int k = std::ceil(std::exp(1.0) * 1.5 * std::log(double(m_vertices.size())));
+        for(unsigned int vertex = 0; vertex < m_vertices.size(); ++vertex)
+        {
+            if(m_vertex_valid[vertex])
+            {
+                connect(vertex, k, connection_range);
+            }
+        }
+    }
+
+    void Roadmap::connect(unsigned int vertex, unsigned int k, float connection_range)
+    {
+        std::vector<std::pair<float, unsigned int>> neighbors;
+        neighbors.reserve(m_vertices.size());
+        for(unsigned int other = 0; other < m_vertices.size(); ++other)
+        {
+            if(other == vertex || !m_vertex_valid[other])
+            {
+                continue;
+            }
+            const float distance = std::hypot(m_vertices[vertex].first - m_vertices[other].first,
+                                              m_vertices[vertex].second - m_vertices[other].second);
+            if(connection_range <= 0 || distance <= connection_range)
+            {
+                neighbors.emplace_back(distance, other);
+            }
+        }
+
+        k = std::min<unsigned int>(k, neighbors.size());
+        std::partial_sort(neighbors.begin(), neighbors.begin() + k, neighbors.end());
+        for(unsigned int i = 0; i < k; ++i)
+        {
+            const unsigned int other = neighbors[i].second;
+            const auto& adjacent     = m_adjacency[vertex];
+            if(std::find_if(adjacent.begin(), adjacent.end(), [other](const std::pair<unsigned int, unsigned int>& a) {
+                   return a.first == other;
+               }) != adjacent.end())
+            {
+                continue;
+            }
+            m_adjacency[vertex].emplace_back(other, m_edges.size());
+            m_adjacency[other].emplace_back(vertex, m_edges.size());
+            m_edges.push_back(Edge{vertex, other, neighbors[i].first, 0});
+        }
+    }
+
+    bool Roadmap::edgeValid(unsigned int edge)
+    {
+        Edge& e = m_edges[edge];
+        if(e.state == 0)
+        {
+            ob::ScopedState<> from(m_space_information);
+            ob::ScopedState<> to(m_space_information);
+            from->as<ob::RealVectorStateSpace::StateType>()->values[0] = m_vertices[e.from].first;
+            from->as<ob::RealVectorStateSpace::StateType>()->values[1] = m_vertices[e.from].second;
+            to->as<ob::RealVectorStateSpace::StateType>()->values[0]   = m_vertices[e.to].first;
+            to->as<ob::RealVectorStateSpace::StateType>()->values[1]   = m_vertices[e.to].second;
+            e.state = m_space_information->checkMotion(from.get(), to.get()) ? 1 : 2;
+        }
+        return e.state == 1;
+    }
+
+    std::vector<Roadmap::Path> Roadmap::query(unsigned int from)
+    {
+        std::vector<Path> paths(m_num_locations, Path(false, -1, std::vector<std::pair<float, float>>()));
+        if(!m_vertex_valid[from])
+        {
+            return paths;
+        }
+
+        // Dijkstra where the edge that reaches a vertex is checked when the vertex is settled. Every relaxation is
+        // queued, so a vertex whose best edge is in collision is still reached through the next best one
+        using Entry = std::tuple<float, unsigned int, unsigned int>;  // distance, vertex, edge
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+        std::vector<float> distance(m_vertices.size(), -1);
+        std::vector<unsigned int> parent(m_vertices.size(), s_no_edge);
+        unsigned int unsettled = m_num_locations;
+
+        queue.emplace(0.0f, from, s_no_edge);
+        while(!queue.empty() && unsettled > 0)
+        {
+            const auto [d, vertex, edge] = queue.top();
+            queue.pop();
+            if(distance[vertex] >= 0 || (edge != s_no_edge && !edgeValid(edge)))
+            {
+                continue;
+            }
+            distance[vertex] = d;
+            parent[vertex]   = edge;
+            if(vertex < m_num_locations)
+            {
+                --unsettled;
+            }
+            for(const auto& [next, next_edge]: m_adjacency[vertex])
+            {
+                if(distance[next] < 0 && m_edges[next_edge].state != 2)
+                {
+                    queue.emplace(d + m_edges[next_edge].length, next, next_edge);
+                }
+            }
+        }
+
+        for(unsigned int to = 0; to < m_num_locations; ++to)
+        {
+            if(to == from || distance[to] < 0)
+            {
+                continue;
+            }
+            std::vector<std::pair<float, float>> waypoints;
+            for(unsigned int vertex = to;; )
+            {
+                waypoints.emplace_back(m_vertices[vertex].first, m_vertices[vertex].second);
+                if(parent[vertex] == s_no_edge)
+                {
+                    break;
+                }
+                const Edge& e = m_edges[parent[vertex]];
+                vertex        = e.from == vertex ? e.to : e.from;
+            }
+            std::reverse(waypoints.begin(), waypoints.end());
+            paths[to] = Path(true, distance[to], std::move(waypoints));
+        }
+        return paths;
+    }
+}  // namespace grstaps
@@ -0,0 +1,447 @@
+/*
+ * Copyright (C)2020 Andrew Messing
+ *
+ * GRSTAPS is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 3 of the License,
+ * or any later version.
+ *
+ * GRSTAPS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GRSTAPS; if not, write to the Free Software Foundation,
+ * Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+#include "grstaps/motion_planning/visibility_graph.hpp"
+
+// global
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+namespace grstaps
+{
+    namespace
+    {
+        //! Scale of the clipper coordinates, matches the ClipperValidityChecker
+        constexpr double s_scale = 1E6;
+
+        constexpr unsigned int s_no_parent = std::numeric_limits<unsigned int>::max();
+
+        //! Slack around a segment when looking up its grid cells, so points on a cell border are found from both sides
+        constexpr double s_grid_margin = 1;
+
+        /**
+         * \returns The side of the line from o through u that v is on: 1 left, -1 right and 0 on the line
+         */
+        int orientation(const std::pair<double, double>& o,
+                        const std::pair<double, double>& u,
+                        const std::pair<double, double>& v)
+        {
+            const double ux    = u.first - o.first;
+            const double uy    = u.second - o.second;
+            const double vx    = v.first - o.first;
+            const double vy    = v.second - o.second;
+            const double cross = ux * vy - uy * vx;
+            const double eps   = 1E-12 * std::hypot(ux, uy) * std::hypot(vx, vy);
+            if(cross > eps)
+            {
+                return 1;
+            }
+            if(cross < -eps)
+            {
+                return -1;
+            }
+            return 0;
+        }
+
+        double distance(const std::pair<double, double>& a, const std::pair<double, double>& b)
+        {
+            return std::hypot(a.first - b.first, a.second - b.second);
+        }
+    }  // namespace
+
+    template <typename Visit>
+    void VisibilityGraph::forEachCell(const Point& a, const Point& b, Visit visit) const
+    {
+        // Cells outside the grid are clamped to its border, which has no edges beyond it
+        auto column = [this](double x) {
+            return static_cast<unsigned int>(
+                std::clamp((x - m_grid_min.first) / m_cell_size, 0.0, static_cast<double>(m_num_columns - 1)));
+        };
+        auto row = [this](double y) {
+            return static_cast<unsigned int>(
+                std::clamp((y - m_grid_min.second) / m_cell_size, 0.0, static_cast<double>(m_num_rows - 1)));
+        };
+
+        // Walk the columns the segment spans and the rows it spans inside each of them
+        const double x_min      = std::min(a.first, b.first);
+        const double x_max      = std::max(a.first, b.first);
+        const unsigned int last = column(x_max + s_grid_margin);
+        for(unsigned int c = column(x_min - s_grid_margin); c <= last; ++c)
+        {
+            const double y_min = std::min(a.second, b.second);
+            const double y_max = std::max(a.second, b.second);
+            double y_low       = y_min;
+            double y_high      = y_max;
+            if(a.first != b.first)
+            {
+                const double column_min = m_grid_min.first + c * m_cell_size;
+                const double low        = c == 0 ? x_min : std::max(x_min, column_min - s_grid_margin);
+                const double high =
+                    c + 1 == m_num_columns ? x_max : std::min(x_max, column_min + m_cell_size + s_grid_margin);
+                const double slope = (b.second - a.second) / (b.first - a.first);
+                const double y_1   = a.second + (low - a.first) * slope;
+                const double y_2   = a.second + (high - a.first) * slope;
+                y_low              = std::clamp(std::min(y_1, y_2), y_min, y_max);
+                y_high             = std::clamp(std::max(y_1, y_2), y_min, y_max);
+            }
+            const unsigned int last_row = row(y_high + s_grid_margin);
+            for(unsigned int r = row(y_low - s_grid_margin); r <= last_row; ++r)
+            {
+                visit(r * m_num_columns + c);
+            }
+        }
+    }
+
+    VisibilityGraph::VisibilityGraph(const ClipperLib2::Paths& map,
+                                     const std::vector<Location>& locations,
+                                     float robot_radius)
+    {
+        // Normalize the orientations so the free space is on the left of every path
+        {
+            ClipperLib2::Clipper clipper;
+            clipper.AddPaths(map, ClipperLib2::ptSubject, true);
+            clipper.Execute(ClipperLib2::ctUnion, m_map, ClipperLib2::pftEvenOdd, ClipperLib2::pftEvenOdd);
+        }
+        if(robot_radius > 0)
+        {
+            ClipperLib2::ClipperOffset clipper_offset;
+            clipper_offset.AddPaths(m_map, ClipperLib2::jtMiter, ClipperLib2::etClosedPolygon);
+            clipper_offset.Execute(m_map, -robot_radius * s_scale);
+        }
+
+        for(const ClipperLib2::Path& path: m_map)
+        {
+            const unsigned int size = path.size();
+            if(size < 3)
+            {
+                continue;
+            }
+            for(unsigned int i = 0; i < size; ++i)
+            {
+                const Point previous(path[(i + size - 1) % size].X, path[(i + size - 1) % size].Y);
+                const Point current(path[i].X, path[i].Y);
+                const Point next(path[(i + 1) % size].X, path[(i + 1) % size].Y);
+                m_boundary.emplace_back(current, next);
+
+                // A right turn is a corner of an obstacle that shortest paths wrap around
+                if(orientation(previous, current, next) < 0)
+                {
+                    m_nodes.push_back(current);
+                    m_node_neighbors.emplace_back(previous, next);
+                }
+            }
+        }
+
+        // About one cell per boundary edge
+        m_grid_min = Point(std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+        m_grid_max = Point(std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest());
+        for(const auto& [p, q]: m_boundary)
+        {
+            m_grid_min = Point(std::min({m_grid_min.first, p.first, q.first}),
+                               std::min({m_grid_min.second, p.second, q.second}));
+            m_grid_max = Point(std::max({m_grid_max.first, p.first, q.first}),
+                               std::max({m_grid_max.second, p.second, q.second}));
+        }
+        if(m_boundary.empty())
+        {
+            m_grid_min = m_grid_max = Point(0, 0);
+        }
+        const double side = std::max({m_grid_max.first - m_grid_min.first, m_grid_max.second - m_grid_min.second, 1.0});
+        m_cell_size       = side / std::ceil(std::sqrt(std::max<double>(m_boundary.size(), 1)));
+        m_num_columns     = static_cast<unsigned int>((m_grid_max.first - m_grid_min.first) / m_cell_size) + 1;
+        m_num_rows        = static_cast<unsigned int>((m_grid_max.second - m_grid_min.second) / m_cell_size) + 1;
+        m_cells.resize(m_num_columns * m_num_rows);
+        for(unsigned int i = 0; i < m_boundary.size(); ++i)
+        {
+            forEachCell(m_boundary[i].first, m_boundary[i].second, [this, i](unsigned int cell) {
+                m_cells[cell].push_back(i);
+            });
+        }
+
+        m_edges.resize(m_nodes.size());
+        for(unsigned int i = 0; i < m_nodes.size(); ++i)
+        {
+            for(unsigned int j = i + 1; j < m_nodes.size(); ++j)
+            {
+                if(isTangent(i, m_nodes[j]) && isTangent(j, m_nodes[i]) && isVisible(m_nodes[i], m_nodes[j]))
+                {
+                    const double length = distance(m_nodes[i], m_nodes[j]);
+                    m_edges[i].emplace_back(j, length);
+                    m_edges[j].emplace_back(i, length);
+                }
+            }
+        }
+
+        setLocations(locations);
+    }
+
+    void VisibilityGraph::setLocations(const std::vector<Location>& locations)
+    {
+        m_locations.clear();
+        m_location_free.clear();
+        for(const Location& location: locations)
+        {
+            m_locations.emplace_back(location.x() * s_scale, location.y() * s_scale);
+            m_location_free.push_back(isFree(m_locations.back()));
+        }
+        m_location_connected.assign(m_locations.size(), false);
+        m_location_edges.assign(m_locations.size(), {});
+    }
+
+    VisibilityGraph::Path VisibilityGraph::query(unsigned int from, unsigned int to)
+    {
+        Path rv(false, -1, std::vector<std::pair<float, float>>());
+        if(!m_location_free[from] || !m_location_free[to])
+        {
+            return rv;
+        }
+
+        const Point& start = m_locations[from];
+        const Point& goal  = m_locations[to];
+        std::vector<Point> points;
+        if(isVisible(start, goal))
+        {
+            points = {start, goal};
+        }
+        else
+        {
+            std::vector<double> goal_edges(m_nodes.size(), -1);
+            for(const auto& [node, length]: locationEdges(to))
+            {
+                goal_edges[node] = length;
+            }
+
+            // A* over the corners, the goal is the extra node after them
+            const unsigned int goal_node = m_nodes.size();
+            using Entry                  = std::tuple<double, double, unsigned int, unsigned int>;  // f, g, node, parent
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+            std::vector<double> best(m_nodes.size() + 1, std::numeric_limits<double>::max());
+            std::vector<unsigned int> parent(m_nodes.size() + 1, s_no_parent);
+            std::vector<bool> closed(m_nodes.size() + 1, false);
+
+            auto push = [&](unsigned int node, double g, unsigned int from_node) {
+                if(g < best[node])
+                {
+                    best[node] = g;
+                    open.emplace(g + (node == goal_node ? 0.0 : distance(m_nodes[node], goal)), g, node, from_node);
+                }
+            };
+            for(const auto& [node, length]: locationEdges(from))
+            {
+                push(node, length, s_no_parent);
+            }
+            while(!open.empty())
+            {
+                const auto [f, g, node, from_node] = open.top();
+                open.pop();
+                if(closed[node] || g > best[node])
+                {
+                    continue;
+                }
+                closed[node] = true;
+                parent[node] = from_node;
+                if(node == goal_node)
+                {
+                    break;
+                }
+                for(const auto& [next, length]: m_edges[node])
+                {
+                    if(!closed[next])
+                    {
+                        push(next, g + length, node);
+                    }
+                }
+                if(goal_edges[node] >= 0)
+                {
+                    push(goal_node, g + goal_edges[node], node);
+                }
+            }
+            if(!closed[goal_node])
+            {
+                return rv;
+            }
+
+            points.push_back(goal);
+            for(unsigned int node = parent[goal_node]; node != s_no_parent; node = parent[node])
+            {
+                points.push_back(m_nodes[node]);
+            }
+            points.push_back(start);
+            std::reverse(points.begin(), points.end());
+        }
+
+        double length = 0;
+        std::vector<std::pair<float, float>> waypoints;
+        for(unsigned int i = 0; i < points.size(); ++i)
+        {
+            if(i > 0)
+            {
+                length += distance(points[i - 1], points[i]);
+            }
+            waypoints.emplace_back(points[i].first / s_scale, points[i].second / s_scale);
+        }
+        return Path(true, length / s_scale, std::move(waypoints));
+    }
+
+    unsigned int VisibilityGraph::numNodes() const
+    {
+        return m_nodes.size();
+    }
+
+    bool VisibilityGraph::isFree(const Point& point) const
+    {
+        if(point.first < m_grid_min.first || point.first > m_grid_max.first || point.second < m_grid_min.second ||
+           point.second > m_grid_max.second)
+        {
+            return false;
+        }
+
+        // Even-odd crossings of the ray to the right of the point, counted like ClipperLib2::PointInPolygon on
+        // every polygon at once
+        const ClipperLib2::IntPoint pt(static_cast<ClipperLib2::cInt>(point.first),
+                                       static_cast<ClipperLib2::cInt>(point.second));
+        std::vector<unsigned int> cells;
+        forEachCell(point, Point(m_grid_max.first, point.second), [&cells](unsigned int cell) {
+            cells.push_back(cell);
+        });
+        bool inside = false;
+        for(unsigned int edge: boundaryEdges(cells))
+        {
+            const ClipperLib2::IntPoint ip(static_cast<ClipperLib2::cInt>(m_boundary[edge].first.first),
+                                           static_cast<ClipperLib2::cInt>(m_boundary[edge].first.second));
+            const ClipperLib2::IntPoint ip_next(static_cast<ClipperLib2::cInt>(m_boundary[edge].second.first),
+                                                static_cast<ClipperLib2::cInt>(m_boundary[edge].second.second));
+            if(ip_next.Y == pt.Y && (ip_next.X == pt.X || (ip.Y == pt.Y && ((ip_next.X > pt.X) == (ip.X < pt.X)))))
+            {
+                return true;
+            }
+            if((ip.Y < pt.Y) == (ip_next.Y < pt.Y) || (ip.X < pt.X && ip_next.X <= pt.X))
+            {
+                continue;
+            }
+            if(ip.X >= pt.X && ip_next.X > pt.X)
+            {
+                inside = !inside;
+                continue;
+            }
+            const double d = static_cast<double>(ip.X - pt.X) * (ip_next.Y - pt.Y) -
+                             static_cast<double>(ip_next.X - pt.X) * (ip.Y - pt.Y);
+            if(d == 0)
+            {
+                return true;
+            }
+            if((d > 0) == (ip_next.Y > ip.Y))
+            {
+                inside = !inside;
+            }
+        }
+        return inside;
+    }
+
+    bool VisibilityGraph::isVisible(const Point& a, const Point& b) const
+    {
+        const double length = distance(a, b);
+        if(length == 0)
+        {
+            return isFree(a);
+        }
+
+        // Split the segment where it touches the boundary, each piece is then entirely inside or outside
+        std::vector<unsigned int> cells;
+        forEachCell(a, b, [&cells](unsigned int cell) {
+            cells.push_back(cell);
+        });
+        std::vector<double> splits = {0.0, 1.0};
+        for(unsigned int edge: boundaryEdges(cells))
+        {
+            const auto& [p, q] = m_boundary[edge];
+            const int side_p   = orientation(a, b, p);
+            const int side_q   = orientation(a, b, q);
+            if(side_p * side_q < 0 && orientation(p, q, a) * orientation(p, q, b) < 0)
+            {
+                return false;
+            }
+            for(const Point& vertex: {p, q})
+            {
+                if(orientation(a, b, vertex) == 0)
+                {
+                    const double t =
+                        ((vertex.first - a.first) * (b.first - a.first) + (vertex.second - a.second) * (b.second - a.second)) /
+                        (length * length);
+                    if(t > 0 && t < 1)
+                    {
+                        splits.push_back(t);
+                    }
+                }
+            }
+        }
+
+        std::sort(splits.begin(), splits.end());
+        for(unsigned int i = 1; i < splits.size(); ++i)
+        {
+            if((splits[i] - splits[i - 1]) * length < 1)
+            {
+                continue;
+            }
+            const double t = (splits[i - 1] + splits[i]) / 2;
+            if(!isFree(Point(a.first + t * (b.first - a.first), a.second + t * (b.second - a.second))))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<unsigned int> VisibilityGraph::boundaryEdges(const std::vector<unsigned int>& cells) const
+    {
+        std::vector<unsigned int> edges;
+        for(unsigned int cell: cells)
+        {
+            edges.insert(edges.end(), m_cells[cell].begin(), m_cells[cell].end());
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+        return edges;
+    }
+
+    bool VisibilityGraph::isTangent(unsigned int node, const Point& point) const
+    {
+        const Point& corner = m_nodes[node];
+        return orientation(corner, point, m_node_neighbors[node].first) *
+                   orientation(corner, point, m_node_neighbors[node].second) >=
+               0;
+    }
+
+    const std::vector<std::pair<unsigned int, double>>& VisibilityGraph::locationEdges(unsigned int location)
+    {
+        if(!m_location_connected[location])
+        {
+            m_location_connected[location] = true;
+            const Point& point             = m_locations[location];
+            for(unsigned int node = 0; node < m_nodes.size(); ++node)
+            {
+                if(isTangent(node, point) && isVisible(point, m_nodes[node]))
+                {
+                    m_location_edges[location].emplace_back(node, distance(point, m_nodes[node]));
+                }
+            }
+        }
+        return m_location_edges[location];
+    }
+}  // namespace grstaps
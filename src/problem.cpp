@@ -26,6 +26,7 @@
 #include <fmt/format.h>
 
 // Local
+#include "grstaps/compiled_map.hpp"
 #include "grstaps/json_conversions.hpp"
 #include "grstaps/task_planning/planner_parameters.hpp"
 #include "grstaps/task_planning/setup.hpp"
@@ -54,42 +55,11 @@ namespace grstaps
         nlohmann::json config;
         ifs >> config;
 
-        std::ifstream ifs2(map_file);
-        nlohmann::json map;
-        ifs2 >> map;
-
-        // ground
-        m_map2.push_back(convertBuildingsAndStreetsToPolygons2(map["buildings"], map["roads"]));
-
-
-        mp_min = std::numeric_limits<float>::max();
-        mp_max = std::numeric_limits<float>::min();
-        {
-
-            for(const ClipperLib2::Path& poly: m_map2[0])
-            {
-                for(const ClipperLib2::IntPoint& point: poly)
-                {
-                    mp_min = std::min<float>(static_cast<float>(std::min(point.X, point.Y)), mp_min);
-                    mp_max = std::max<float>(static_cast<float>(std::max(point.X, point.Y)), mp_max);
-                }
-            }
-            mp_max += 10;
-            mp_min -= 10;
-        }
-
-        // Aerial
-        ClipperLib2::Path boundary = {
-            ClipperLib2::IntPoint(mp_min, mp_min),
-            ClipperLib2::IntPoint(mp_min, mp_max),
-            ClipperLib2::IntPoint(mp_max, mp_max),
-            ClipperLib2::IntPoint(mp_max, mp_min)
-        };
-        if(ClipperLib2::Area(boundary) < 0)
-        {
-            std::reverse(boundary.begin(), boundary.end());
-        }
-        m_map2.push_back({boundary});
+        // Accepts either a json map or one that has already been compiled
+        const CompiledMap compiled_map = CompiledMap::load(map_file);
+        m_map2 = compiled_map.maps;
+        mp_min = compiled_map.boundaryMin;
+        mp_max = compiled_map.boundaryMax;
 
         // TODO: parse locations
         for(const nlohmann::json& j: config["streets"])
@@ -292,51 +262,6 @@ namespace grstaps
         return (q.y - p.y) * (r.x - q.x) - (q.x - p.x) * (r.y - q.y);
     }
 
-    void convertToPaths(ClipperLib2::Paths& rv, const std::vector<std::vector<b2Vec2>>& shapes)
-    {
-        for(const std::vector<b2Vec2>& shape: shapes)
-        {
-            ClipperLib2::Path polygon;
-            for(const b2Vec2& point: shape)
-            {
-                polygon.push_back(ClipperLib2::IntPoint(point.x * 1E6, point.y * 1E6));
-            }
-
-            // If "hole" flip it
-            const float area = ClipperLib2::Area(polygon);
-            if(area < 0.0)
-            {
-                std::reverse(polygon.begin(), polygon.end());
-            }
-            rv.push_back(polygon);
-        }
-    }
-
-    ClipperLib2::Paths Problem::convertBuildingsAndStreetsToPolygons2(const nlohmann::json& buildings, const nlohmann::json& streets)
-    {
-        ClipperLib2::Paths rv;
-        convertToPaths(rv, buildings.get<std::vector<std::vector<b2Vec2>>>());
-        convertToPaths(rv, streets.get<std::vector<std::vector<b2Vec2>>>());
-
-        // union/smooth out
-        {
-            ClipperLib2::Clipper clipper;
-            clipper.AddPaths(rv, ClipperLib2::ptSubject, true);
-            clipper.Execute(ClipperLib2::ctUnion,
-                            rv,
-                            ClipperLib2::pftNonZero,
-                            ClipperLib2::pftNonZero);
-
-            ClipperLib2::ClipperOffset clipper_offset;
-            clipper_offset.AddPaths(rv, ClipperLib2::jtMiter, ClipperLib2::etClosedPolygon);
-            clipper_offset.Execute(rv, 1E5);
-            clipper_offset.Clear();
-            clipper_offset.AddPaths(rv, ClipperLib2::jtMiter, ClipperLib2::etClosedPolygon);
-            clipper_offset.Execute(rv, -1E5);
-        }
-
-        return rv;
-    }
     std::vector<b2PolygonShape> Problem::convertBuildingsAndStreetsToPolygons1(const nlohmann::json& buildings, const nlohmann::json& streets)
     {
 
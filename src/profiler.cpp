@@ -0,0 +1,167 @@
+#include "grstaps/profiler.hpp"
+
+// global
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace grstaps
+{
+    namespace
+    {
+        const unsigned int s_num_zones    = static_cast<unsigned int>(ProfileZone::NumZones);
+        const unsigned int s_num_counters = static_cast<unsigned int>(ProfileCounter::NumCounters);
+
+        const char* s_zone_names[s_num_zones] = {"tp_expand",
+                                                 "tp_evaluate",
+                                                 "tp_memo_lookup",
+                                                 "ta_expand",
+                                                 "schedule",
+                                                 "schedule_tabu",
+                                                 "schedule_exact",
+                                                 "mp_query"};
+
+        const char* s_counter_names[s_num_counters] = {"tp_memo_repeated_state",
+                                                       "mp_cache_hit",
+                                                       "mp_cache_miss",
+                                                       "ta_prescreen_rejected"};
+    }  // namespace
+
+    // The counters are only written by their own thread. They are atomic so that collect() can read them from
+    // another thread; relaxed accesses compile to plain loads and stores
+    struct Profiler::ThreadData
+    {
+        std::atomic<uint64_t> calls[s_num_zones];
+        std::atomic<uint64_t> nanoseconds[s_num_zones];
+        std::atomic<uint64_t> counters[s_num_counters];
+
+        ThreadData()
+        {
+            clear();
+        }
+
+        void clear()
+        {
+            for(unsigned int i = 0; i < s_num_zones; ++i)
+            {
+                calls[i].store(0, std::memory_order_relaxed);
+                nanoseconds[i].store(0, std::memory_order_relaxed);
+            }
+            for(unsigned int i = 0; i < s_num_counters; ++i)
+            {
+                counters[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        static void add(std::atomic<uint64_t>& counter, uint64_t n)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        void addTo(ThreadData& other) const
+        {
+            for(unsigned int i = 0; i < s_num_zones; ++i)
+            {
+                add(other.calls[i], calls[i].load(std::memory_order_relaxed));
+                add(other.nanoseconds[i], nanoseconds[i].load(std::memory_order_relaxed));
+            }
+            for(unsigned int i = 0; i < s_num_counters; ++i)
+            {
+                add(other.counters[i], counters[i].load(std::memory_order_relaxed));
+            }
+        }
+    };
+
+    namespace
+    {
+        // Counters of the live threads, plus the merged counters of the threads that already finished
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<Profiler::ThreadData*> threads;
+            Profiler::ThreadData retired;
+        };
+
+        Registry& registry()
+        {
+            static Registry* r = new Registry();  // Never destroyed: threads may exit after static destruction
+            return *r;
+        }
+
+        struct ThreadRegistration
+        {
+            Profiler::ThreadData data;
+
+            ThreadRegistration()
+            {
+                Registry& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                r.threads.push_back(&data);
+            }
+
+            ~ThreadRegistration()
+            {
+                Registry& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                data.addTo(r.retired);
+                r.threads.erase(std::find(r.threads.begin(), r.threads.end(), &data));
+            }
+        };
+    }  // namespace
+
+    Profiler::ThreadData& Profiler::local()
+    {
+        thread_local ThreadRegistration registration;
+        return registration.data;
+    }
+
+    void Profiler::record(ProfileZone zone, uint64_t nanoseconds)
+    {
+        ThreadData& data = local();
+        unsigned int i   = static_cast<unsigned int>(zone);
+        ThreadData::add(data.calls[i], 1);
+        ThreadData::add(data.nanoseconds[i], nanoseconds);
+    }
+
+    void Profiler::count(ProfileCounter counter, uint64_t n)
+    {
+        ThreadData::add(local().counters[static_cast<unsigned int>(counter)], n);
+    }
+
+    nlohmann::json Profiler::collect()
+    {
+        ThreadData total;
+        {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.retired.addTo(total);
+            for(ThreadData* data: r.threads)
+            {
+                data->addTo(total);
+            }
+        }
+
+        nlohmann::json j;
+        for(unsigned int i = 0; i < s_num_zones; ++i)
+        {
+            j["zones"][s_zone_names[i]] = {{"calls", total.calls[i].load()},
+                                           {"seconds", total.nanoseconds[i].load() * 1.0E-9}};
+        }
+        for(unsigned int i = 0; i < s_num_counters; ++i)
+        {
+            j["counters"][s_counter_names[i]] = total.counters[i].load();
+        }
+        return j;
+    }
+
+    void Profiler::reset()
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.retired.clear();
+        for(ThreadData* data: r.threads)
+        {
+            data->clear();
+        }
+    }
+}  // namespace grstaps
@@ -60,6 +60,9 @@ namespace grstaps
             motion_planner->setLocations(problem.locations());
             motion_planner->setQueryTime(query_time);
             motion_planner->setConnectionRange(connection_range);
+            motion_planner->setVisibilityGraph(config.value("mp_visibility_graph", false),
+                                               config.value("mp_robot_radius", 0.0f));
+            motion_planner->setRoadmapSize(config.value("mp_roadmap_size", 0u));
             motion_planners->push_back(motion_planner);
         }
         return motion_planners;
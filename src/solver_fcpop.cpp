@@ -5,6 +5,7 @@
 #include "grstaps/task_planning/task_planner.hpp"
 #include "grstaps/task_planning/setup.hpp"
 #include "grstaps/logger.hpp"
+#include "grstaps/profiler.hpp"
 #include "grstaps/problem.hpp"
 #include "grstaps/timer.hpp"
 
@@ -40,9 +41,16 @@ namespace grstaps
         return rv;
     }
 
+    SolverFcpop::SolverFcpop(unsigned int num_threads)
+        : m_num_threads(num_threads)
+        , m_tp_nodes_expanded(0)
+        , m_tp_nodes_visited(0)
+    {}
+
     nlohmann::json SolverFcpop::solve(const std::string& domain_filepath, const std::string& problem_filepath)
     {
         Logger::debug("start");
+        Profiler::reset();
         // Preprocess pddl
         PlannerParameters parameters;
         parameters.domainFileName  = domain_filepath.c_str();
@@ -62,13 +70,43 @@ namespace grstaps
         Logger::debug("Grounded Actions: {}", task->actions.size());
 
         // Task planner
-        TaskPlanner task_planner(task);
+        TaskPlanner task_planner(task, -1.0f, false, m_num_threads);
         m_tp_nodes_expanded = 0;
         m_tp_nodes_visited  = 0;
         float num_branches = 0;
         float num_times_branched = 0;
 
         timer.start();
+        if(m_num_threads > 1)
+        {
+            // The worker threads expand the plans, so only the solution and the counters are seen here
+            Plan* solution = task_planner.plan();
+            timer.stop();
+            if(solution == nullptr)
+            {
+                return nlohmann::json();
+            }
+            m_tp_nodes_expanded = task_planner.getExpandedNodes();
+            m_tp_nodes_visited  = task_planner.getVisitedNodes();
+            nlohmann::json metrics = {
+                {"makespan", task_planner.getMakespan(solution)},
+                {"total_grounded_actions", task->actions.size()},
+                {"num_actions", task_planner.getPlanActions(solution)},
+                {"num_tp_nodes_expanded", m_tp_nodes_expanded},
+                {"num_tp_nodes_visited", m_tp_nodes_visited},
+                {"avg_branching_factor", static_cast<float>(m_tp_nodes_visited) / m_tp_nodes_expanded},
+                {"num_tp_threads", m_num_threads},
+                {"timer", timer.get()},
+                {"preprocess_timer", preprocess_time},
+                {"solution", writeSolution(task_planner, solution, task)}
+            };
+            if(Profiler::enabled)
+            {
+                metrics["profile"] = Profiler::collect();
+            }
+            return metrics;
+        }
+
         Plan* base;
         while(!task_planner.emptySearchSpace())
         {
@@ -87,19 +125,20 @@ namespace grstaps
                     {"preprocess_timer", preprocess_time},
                     {"solution", writeSolution(task_planner, base, task)}
                 };
+                if(Profiler::enabled)
+                {
+                    metrics["profile"] = Profiler::collect();
+                }
                 return metrics;
             }
 
             ++m_tp_nodes_expanded;
-            Logger::debug("Expanding plan: {}", base->id);
+            GRSTAPS_LOG_DEBUG("Expanding plan: {}", base->id);
             std::vector<Plan*> successors = task_planner.getNextSuccessors(base);
             ++num_times_branched;
-            for(Plan* plan : successors)
-            {
-                m_tp_nodes_visited += successors.size();
-                num_branches += successors.size();
-                task_planner.update(base, successors);
-            }
+            m_tp_nodes_visited += successors.size();
+            num_branches += successors.size();
+            task_planner.update(base, successors);
         }
 
         return nlohmann::json();
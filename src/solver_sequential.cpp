@@ -19,6 +19,7 @@
 #include "grstaps/logger.hpp"
 #include "grstaps/motion_planning/motion_planner.hpp"
 #include "grstaps/problem.hpp"
+#include "grstaps/profiler.hpp"
 #include "grstaps/solution.hpp"
 #include "grstaps/task_planning/plan.hpp"
 #include "grstaps/task_planning/task_planner.hpp"
@@ -29,6 +30,7 @@ namespace grstaps
     {
         // Initialize everything
         const nlohmann::json& config = problem.config();
+        Profiler::reset();
 
         Logger::debug("Grounded Actions: {}", problem.task()->actions.size());
 
@@ -42,6 +44,7 @@ namespace grstaps
 
         // Task Allocation
         taskAllocationToScheduling taToSched(motion_planners, &problem.startingLocations(), problem.longestPath);
+        taToSched.configure(problem.config());
         bool usingSpecies = false;
         m_ta_nodes_expanded = 0;
         m_ta_nodes_visited  = 0;
@@ -75,6 +78,10 @@ namespace grstaps
                 {"num_tp_nodes_visited", m_tp_nodes_visited},
                 {"timer", timer.get()}
             };
+            if(Profiler::enabled)
+            {
+                metrics["profile"] = Profiler::collect();
+            }
             auto m_solution = std::make_shared<Solution>(
                 nullptr,
                 nullptr,
@@ -111,7 +118,8 @@ namespace grstaps
 
         auto pta = last_solution.second;
         nlohmann::json metrics = {
-            {"makespan", pta.getScheduleTime()},
+            {"makespan", pta.getExactScheduleTime()},
+            {"schedule_optimal", pta.taToScheduling.sched.isOptimal()},
             {"total_grounded_actions", problem.task()->actions.size()},
             {"num_actions", (*pta.actionDurations).size()},
             {"num_tp_nodes_expanded", m_tp_nodes_expanded},
@@ -121,6 +129,10 @@ namespace grstaps
             {"num_ta_nodes_visited", m_ta_nodes_visited},
             {"timer", timer.get()},
         };
+        if(Profiler::enabled)
+        {
+            metrics["profile"] = Profiler::collect();
+        }
         auto m_solution = std::make_shared<Solution>(
             std::shared_ptr<Plan>(last_solution.first),
             std::make_shared<TaskAllocation>(pta),
@@ -140,13 +152,10 @@ namespace grstaps
             }
 
             ++m_tp_nodes_expanded;
-            Logger::debug("Expanding plan: {}", base->id);
+            GRSTAPS_LOG_DEBUG("Expanding plan: {}", base->id);
             std::vector<Plan*> successors = task_planner.getNextSuccessors(base);
-            for(Plan* plan : successors)
-            {
-                m_tp_nodes_visited += successors.size();
-                task_planner.update(base, successors);
-            }
+            m_tp_nodes_visited += successors.size();
+            task_planner.update(base, successors);
         }
 
         return nullptr;
@@ -194,10 +203,17 @@ namespace grstaps
                 setupTaskAllocationParameters(
                     plan, problem, orderingCon, durations, noncumTraitCutoff, goalDistribution, actionLocations);
 
-                if(isAllocatable(goalDistribution, &robotTraits, noncumTraitCutoff, numSpec))
+                taToSched.setActionLocations(actionLocations);
+                if(isAllocatable(goalDistribution, &robotTraits, noncumTraitCutoff, numSpec) &&
+                   taToSched.planLowerBound(*durations,
+                                            *orderingCon,
+                                            *goalDistribution,
+                                            *noncumTraitCutoff,
+                                            robotTraits,
+                                            *numSpec,
+                                            problem.speedIndex,
+                                            problem.mpIndex) >= 0)
                 {
-                    taToSched.setActionLocations(actionLocations);
-
                     TaskAllocation ta(false,
                                       goalDistribution,
                                       &robotTraits,
@@ -235,8 +251,8 @@ namespace grstaps
 
                         m_ta_nodes_expanded += graphAllocateAndSchedule.nodesExpanded;
                         m_ta_nodes_visited += graphAllocateAndSchedule.nodesSearched;
-                        // solution found
-                        if(package->foundGoal && package->finalNode->getData().getScheduleTime() > 0.0)
+                        // solution found, the goal may only have been scored with straight line travel times
+                        if(package->foundGoal && package->finalNode->getData().getExactScheduleTime() > 0.0)
                         {
                             Logger::debug("Found a solution");
                             return std::pair<Plan*, TaskAllocation>(plan, package->finalNode->getData());
@@ -289,10 +305,28 @@ namespace grstaps
                 setupTaskAllocationParameters(
                     plan, problem, orderingCon, durations, noncumTraitCutoff, goalDistribution, actionLocations);
 
+                taToSched.setActionLocations(actionLocations);
+                // Every allocation of a plan takes at least its lower bound and only a strictly better schedule
+                // replaces the incumbent
+                float lowerBound = -1;
                 if(isAllocatable(goalDistribution, &robotTraits, noncumTraitCutoff, numSpec))
                 {
-                    taToSched.setActionLocations(actionLocations);
-
+                    lowerBound = taToSched.planLowerBound(*durations,
+                                                          *orderingCon,
+                                                          *goalDistribution,
+                                                          *noncumTraitCutoff,
+                                                          robotTraits,
+                                                          *numSpec,
+                                                          problem.speedIndex,
+                                                          problem.mpIndex);
+                    if(last_solution.first != nullptr && lowerBound >= last_solution.second.getScheduleTime())
+                    {
+                        GRSTAPS_PROFILE_COUNT(PlanPrescreenRejected);
+                        lowerBound = -1;
+                    }
+                }
+                if(lowerBound >= 0)
+                {
                     TaskAllocation ta(false,
                                       goalDistribution,
                                       &robotTraits,
@@ -330,11 +364,11 @@ namespace grstaps
 
                         m_ta_nodes_expanded += graphAllocateAndSchedule.nodesExpanded;
                         m_ta_nodes_visited += graphAllocateAndSchedule.nodesSearched;
-                        // solution found
-                        if(package->foundGoal && package->finalNode->getData().getScheduleTime() > 0.0)
+                        // solution found, the goal may only have been scored with straight line travel times
+                        if(package->foundGoal && package->finalNode->getData().getExactScheduleTime() > 0.0)
                         {
                             Logger::debug("Found a solution");
-                            if(package->finalNode->getData().getScheduleTime() < last_solution.second.getScheduleTime())
+                            if(package->finalNode->getData().getExactScheduleTime() < last_solution.second.getScheduleTime())
                             {
                                 last_solution = std::pair<Plan*, TaskAllocation>(plan, package->finalNode->getData());
                             }
@@ -411,11 +445,11 @@ namespace grstaps
 
                 m_ta_nodes_expanded += graphAllocateAndSchedule.nodesExpanded;
                 m_ta_nodes_visited += graphAllocateAndSchedule.nodesSearched;
-                // solution found
-                if(package->foundGoal && package->finalNode->getData().getScheduleTime() > 0.0)
+                // solution found, the goal may only have been scored with straight line travel times
+                if(package->foundGoal && package->finalNode->getData().getExactScheduleTime() > 0.0)
                 {
                     Logger::debug("Found a solution");
-                    if(package->finalNode->getData().getScheduleTime() < last_solution.second.getScheduleTime())
+                    if(package->finalNode->getData().getExactScheduleTime() < last_solution.second.getScheduleTime())
                     {
                         last_solution = std::pair<Plan*, TaskAllocation>(plan, package->finalNode->getData());
                     }
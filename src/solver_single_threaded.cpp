@@ -19,6 +19,7 @@
 #include "grstaps/logger.hpp"
 #include "grstaps/motion_planning/motion_planner.hpp"
 #include "grstaps/problem.hpp"
+#include "grstaps/profiler.hpp"
 #include "grstaps/solution.hpp"
 #include "grstaps/task_planning/plan.hpp"
 #include "grstaps/task_planning/task_planner.hpp"
@@ -29,6 +30,7 @@ namespace grstaps
     {
         // Initialize everything
         const nlohmann::json& config = problem.config();
+        Profiler::reset();
 
         // Task planner
         TaskPlanner task_planner(problem.task());
@@ -44,6 +46,7 @@ namespace grstaps
 
         // Task Allocation
         taskAllocationToScheduling taToSched(motion_planners, &problem.startingLocations(), problem.longestPath);
+        taToSched.configure(problem.config());
         bool usingSpecies = false;
         unsigned int talloc_nodes_expanded = 0;
         unsigned int talloc_nodes_visited  = 0;
@@ -81,7 +84,8 @@ namespace grstaps
                 TaskAllocation& ta = plan_to_ta[base];
 
                 nlohmann::json metrics = {
-                    {"makespan", ta.getScheduleTime()},
+                    {"makespan", ta.getExactScheduleTime()},
+                    {"schedule_optimal", ta.taToScheduling.sched.isOptimal()},
                     {"total_grounded_actions", problem.task()->actions.size()},
                     {"num_actions", (*ta.actionDurations).size()},
                     {"avg_branching_factor", num_branches / num_times_branched},
@@ -94,6 +98,10 @@ namespace grstaps
                     {"ta_timer", ta_timer.get()},
                     {"mp_timer", mp_time}
                 };
+                if(Profiler::enabled)
+                {
+                    metrics["profile"] = Profiler::collect();
+                }
 
                 auto m_solution =
                     std::make_shared<Solution>(std::shared_ptr<Plan>(base),
@@ -122,7 +130,15 @@ namespace grstaps
 
                 taToSched.setActionLocations(actionLocations);
                 ta_timer.start();
-                if(isAllocatable(goalDistribution, robotTraits, noncumTraitCutoff, numSpec))
+                if(isAllocatable(goalDistribution, robotTraits, noncumTraitCutoff, numSpec) &&
+                   taToSched.planLowerBound(*durations,
+                                            *orderingCon,
+                                            *goalDistribution,
+                                            *noncumTraitCutoff,
+                                            *robotTraits,
+                                            *numSpec,
+                                            problem.speedIndex,
+                                            problem.mpIndex) >= 0)
                 {
                     TaskAllocation ta(usingSpecies,
                                       goalDistribution,
@@ -152,7 +168,8 @@ namespace grstaps
                     continue;
                 }
 
-                if(package->foundGoal)
+                // The goal may only have been scored with straight line travel times
+                if(package->foundGoal && package->finalNode->getData().getExactScheduleTime() > 0.0)
                 {
                     //successors[i]->gc = package->finalNode->getData().taToScheduling.sched.getMakeSpan();
                     plan_to_ta[successors[i]] = package->finalNode->getData();
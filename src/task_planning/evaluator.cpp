@@ -1,12 +1,16 @@
 #include "grstaps/task_planning/evaluator.hpp"
 
+#include "grstaps/profiler.hpp"
 #include "grstaps/task_planning/plan.hpp"
 #include "grstaps/task_planning/rpg.hpp"
 
 namespace grstaps
 {
     void Evaluator::evaluate(Plan* p, TState* state, float makespan, bool helpfulActions) {
-        p->hLand = landmarks.countUncheckedNodes();
+        GRSTAPS_PROFILE_ZONE(TaskPlannerEvaluate);
+        delete[] p->achievedLandmarks;
+        p->achievedLandmarks = landmarks.computeAchievedLandmarks(p, state);
+        p->hLand             = landmarks.countUncheckedNodes(p->achievedLandmarks);
         RPG rpg(state, task, forceAtEndConditions, tilActions);
         p->h = rpg.evaluate(task->hasPermanentMutexAction());
         if (priorityGoals != nullptr) {
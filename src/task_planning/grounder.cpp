@@ -8,6 +8,7 @@
 
 #include "grstaps/task_planning/grounder.hpp"
 #include <assert.h>
+#include <algorithm>
 #include <iostream>
 
 #include "grstaps/task_planning/utils.hpp"
@@ -36,6 +37,8 @@ namespace grstaps
     {
         op                         = &o;
         numParams                  = o.parameters.size();
+        currentValue               = 0;
+        nextMatch                  = 0;
         paramValues                = new std::vector<unsigned int>[numParams];
         compatibleObjectsWithParam = new std::vector<unsigned int>[numParams];
         for(unsigned int i = 0; i < o.atStart.prec.size(); i++)
@@ -79,7 +82,10 @@ namespace grstaps
             Operator *op = ops[i].op;
             if(op->atStart.prec.size() == 0 && op->overAllPrec.size() == 0)
             {
+                ops[i].currentValue = 0;
+                ops[i].nextMatch    = 0;
                 groundRemainingParameters(ops[i]);
+                groundMatches(ops[i], 0);
             }
         }
         // Program the facts in the initial state
@@ -92,9 +98,30 @@ namespace grstaps
         auxValues->clear();
         while(newValues->size() > 0)
         {
+            for(std::vector<unsigned int> &positions: newValuesByFunction)
+            {
+                positions.clear();
+            }
             for(unsigned int i = 0; i < newValues->size(); i++)
             {
-                match(newValues->at(i));
+                newValuesByFunction[gTask->variables[newValues->at(i).varIndex].fncIndex].push_back(i);
+            }
+            // The operators are matched in parallel, as the matching only reads the values programmed in the
+            // previous levels. Then the matches are grounded in the same order as in a sequential matching
+            // (by value and by operator), so the result does not depend on the number of threads
+#pragma omp parallel for schedule(dynamic)
+            for(int i = 0; i < (int)numOps; i++)
+            {
+                matchOperator(ops[i]);
+            }
+            for(unsigned int i = 0; i < newValues->size(); i++)
+            {
+                std::vector<GrounderOperator *> &rf =
+                    opRequireFunction[gTask->variables[newValues->at(i).varIndex].fncIndex];
+                for(unsigned int j = 0; j < rf.size(); j++)
+                {
+                    groundMatches(*rf[j], i);
+                }
             }
             startNewValues += newValues->size();
             swapLevels();
@@ -160,10 +187,12 @@ namespace grstaps
         numOps                  = prepTask->operators.size();
         ops                     = new GrounderOperator[numOps];
         unsigned int numObjects = prepTask->task->objects.size();
+        std::unordered_map<std::string, unsigned int> nameId;
         for(unsigned int i = 0; i < numOps; i++)
         {
             GrounderOperator &g = ops[i];
             g.initialize(prepTask->operators[i]);
+            g.nameId = nameId.emplace(g.op->name, nameId.size()).first->second;
             for(unsigned int j = 0; j < g.numParams; j++)
             {
                 for(unsigned int k = 0; k < numObjects; k++)
@@ -177,6 +206,7 @@ namespace grstaps
         }
         unsigned int numFunctions = prepTask->task->functions.size();
         opRequireFunction         = new std::vector<GrounderOperator *>[numFunctions];
+        newValuesByFunction.resize(numFunctions);
         for(unsigned int i = 0; i < numOps; i++)
         {
             std::vector<OpFluent> &atStart = ops[i].op->atStart.prec;
@@ -208,6 +238,7 @@ namespace grstaps
         if(!included)
         {
             v.push_back(op);
+            op->requiredFunctions.push_back(f);
         }
     }
 
@@ -239,8 +270,8 @@ namespace grstaps
     // Creates a new variable
     void Grounder::createVariable(const Fact &f)
     {
-        std::string factName = getVariableName(f.function, f.parameters);
-        if(variableIndex.find(factName) == variableIndex.end())
+        const std::vector<unsigned int> &factKey = getVariableKey(f.function, f.parameters);
+        if(variableIndex.find(factKey) == variableIndex.end())
         {
             // New variable
             GroundedVar v;
@@ -249,7 +280,7 @@ namespace grstaps
             v.isNumeric = f.valueIsNumeric;
             v.params    = f.parameters;
             gTask->variables.push_back(v);
-            variableIndex[factName] = v.index;
+            variableIndex[factKey] = v.index;
             unsigned int notReached = MAX_UNSIGNED_INT;
             if(v.isNumeric)
             {
@@ -264,46 +295,47 @@ namespace grstaps
         }
     }
 
-    // Returns the description of a variable
-    std::string Grounder::getVariableName(unsigned int function, const std::vector<unsigned int> &parameters)
+    // Returns the key of a variable (function and parameters). The key is stored in a buffer that is
+    // overwritten in the next call
+    const std::vector<unsigned int> &Grounder::getVariableKey(unsigned int function,
+                                                              const std::vector<unsigned int> &parameters)
     {
-        std::string name = std::to_string(function);
-        for(unsigned int i = 0; i < parameters.size(); i++)
-        {
-            name += " " + std::to_string(parameters[i]);
-        }
-        return name;
+        key.clear();
+        key.push_back(function);
+        key.insert(key.end(), parameters.begin(), parameters.end());
+        return key;
     }
 
-    // Returns the description of a literal
-    std::string Grounder::getVariableName(const Literal &l, const std::vector<unsigned int> &opParameters)
+    // Returns the key of a literal
+    const std::vector<unsigned int> &Grounder::getVariableKey(const Literal &l,
+                                                              const std::vector<unsigned int> &opParameters)
     {
-        std::string name = std::to_string(l.fncIndex);
+        key.clear();
+        key.push_back(l.fncIndex);
         for(unsigned int i = 0; i < l.params.size(); i++)
         {
             if(l.params[i].isVariable)
             {
-                name += " " + std::to_string(opParameters[l.params[i].index]);
+                key.push_back(opParameters[l.params[i].index]);
             }
             else
             {
-                name += " " + std::to_string(l.params[i].index);
+                key.push_back(l.params[i].index);
             }
         }
-        return name;
+        return key;
     }
 
     // Returns the index of a variable
     unsigned int Grounder::getVariableIndex(const Fact &f)
     {
-        return variableIndex[getVariableName(f.function, f.parameters)];
+        return variableIndex[getVariableKey(f.function, f.parameters)];
     }
 
     // Returns the index of a variable
     unsigned int Grounder::getVariableIndex(const Literal &l, const std::vector<unsigned int> &opParameters)
     {
-        const std::string &name                                          = getVariableName(l, opParameters);
-        std::unordered_map<std::string, unsigned int>::const_iterator it = variableIndex.find(name);
+        GrounderIndex::const_iterator it = variableIndex.find(getVariableKey(l, opParameters));
         if(it == variableIndex.end())
             return MAX_UNSIGNED_INT;
         else
@@ -323,8 +355,12 @@ namespace grstaps
             }
         }
         if(pIndex == MAX_UNSIGNED_INT)
-        {
-            groundAction(op);
+        {  // Match found, it is grounded later
+            op.matchedValue.push_back(op.currentValue);
+            for(unsigned int i = 0; i < op.numParams; i++)
+            {
+                op.matchedParams.push_back(op.paramValues[i].back());
+            }
         }
         else
         {
@@ -338,25 +374,33 @@ namespace grstaps
         }
     }
 
+    // Grounds the matches of an operator originated by the given value
+    void Grounder::groundMatches(GrounderOperator &op, unsigned int value)
+    {
+        while(op.nextMatch < op.matchedValue.size() && op.matchedValue[op.nextMatch] == value)
+        {
+            groundAction(op, op.matchedParams.data() + (size_t)op.nextMatch * op.numParams);
+            op.nextMatch++;
+        }
+    }
+
     // Grounds a new action
-    void Grounder::groundAction(GrounderOperator &op)
+    void Grounder::groundAction(GrounderOperator &op, const unsigned int *parameters)
     {
         GroundedAction a;
         a.index = gTask->actions.size();
         a.name  = op.op->name;
-        for(unsigned int i = 0; i < op.numParams; i++)
-        {
-            // Action parameters grounding
-            a.parameters.push_back(op.paramValues[i].back());
-        }
+        a.parameters.assign(parameters, parameters + op.numParams);  // Action parameters grounding
         if(!op.op->isGoal)
         {
-            std::string name = a.getName(gTask->task);
-            if(groundedActions.find(name) != groundedActions.end())
+            key.clear();
+            key.push_back(op.nameId);
+            key.insert(key.end(), a.parameters.begin(), a.parameters.end());
+            if(groundedActions.find(key) != groundedActions.end())
             {
                 return;  // Repeated action
             }
-            groundedActions[name] = a.index;
+            groundedActions[key] = a.index;
         }
         if(!checkEqualityConditions(op, a))
             return;
@@ -410,14 +454,38 @@ namespace grstaps
         return false;
     }
 
-    // Checks whether a programmed value matches one of the preconditions of the operators
-    void Grounder::match(ProgrammedValue &pv)
+    // Checks whether the values programmed in the current level match the preconditions of the operator.
+    // The matches are stored in the operator. It only modifies the operator, so different operators can be
+    // matched in parallel
+    void Grounder::matchOperator(GrounderOperator &g)
     {
-        std::vector<GrounderOperator *> &rf = opRequireFunction[gTask->variables[pv.varIndex].fncIndex];
-        for(unsigned int i = 0; i < rf.size(); i++)
+        GrounderOperator *op = &g;
+        op->matchedValue.clear();
+        op->matchedParams.clear();
+        op->nextMatch = 0;
+        if(op->requiredFunctions.empty())
+        {
+            return;
+        }
+
+        // Only the values of the functions in the preconditions can match, visited in the order of newValues
+        const std::vector<unsigned int> *positions = &newValuesByFunction[op->requiredFunctions[0]];
+        if(op->requiredFunctions.size() > 1)
+        {
+            op->valuePositions.clear();
+            for(unsigned int f: op->requiredFunctions)
+            {
+                op->valuePositions.insert(
+                    op->valuePositions.end(), newValuesByFunction[f].begin(), newValuesByFunction[f].end());
+            }
+            std::sort(op->valuePositions.begin(), op->valuePositions.end());
+            positions = &op->valuePositions;
+        }
+        for(unsigned int i: *positions)
         {
-            GrounderOperator *op = rf[i];
-            int precIndex        = -1;
+            ProgrammedValue &pv = newValues->at(i);
+            op->currentValue    = i;
+            int precIndex       = -1;
 #ifdef _GROUNDER_TRACE_ON_
             if(op->op->name.compare("inspect") == 0)
                 std::cout << "Grounding " << op->op->name << " with "
@@ -755,8 +823,7 @@ namespace grstaps
             else
                 v.params.push_back(l.params[i].index);
         gTask->variables.push_back(v);
-        const std::string &name = getVariableName(v.fncIndex, v.params);
-        variableIndex[name]     = v.index;
+        variableIndex[getVariableKey(v.fncIndex, v.params)] = v.index;
         unsigned int notReached = MAX_UNSIGNED_INT;
         if(v.isNumeric)
             gTask->reachedValues.emplace_back(0, notReached);
@@ -2475,7 +2542,7 @@ namespace grstaps
                 gm.index = preferenceIndex[m->preferenceName];
                 break;
             case MT_FLUENT:
-                gm.index = variableIndex[getVariableName(m->function, m->parameters)];
+                gm.index = variableIndex[getVariableKey(m->function, m->parameters)];
                 break;
             case MT_TOTAL_TIME:;
         }
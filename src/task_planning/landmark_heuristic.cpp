@@ -2,6 +2,7 @@
 
 // local
 #include "grstaps/task_planning/landmarks.hpp"
+#include "grstaps/task_planning/plan.hpp"
 #include "grstaps/task_planning/state.hpp"
 
 namespace grstaps
@@ -19,7 +20,7 @@ namespace grstaps
             vars.push_back(n->getVariable(i));
             values.push_back(n->getValue(i));
         }
-        checked = false;
+        index = 0;
     }
 
     void LandmarkCheck::addNext(LandmarkCheck* n)
@@ -44,10 +45,6 @@ namespace grstaps
             }
         }
         res += ")";
-        if(checked)
-        {
-            res += " checked";
-        }
         res += " Next: " + std::to_string(next.size());
         if(showNext)
         {
@@ -159,6 +156,25 @@ namespace grstaps
         return false;
     }
 
+    // Checks if the action produces any of the fluents of the landmark
+    bool LandmarkCheck::isAchievedBy(SASAction* a) const
+    {
+        for(const std::vector<SASCondition>* eff : {&a->startEff, &a->endEff})
+        {
+            for(const SASCondition& e : *eff)
+            {
+                for(unsigned int i = 0; i < vars.size(); i++)
+                {
+                    if(e.var == vars[i] && e.value == values[i])
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
     /*******************************************/
     /* LandmarkHeuristic                       */
     /*******************************************/
@@ -166,6 +182,7 @@ namespace grstaps
     LandmarkHeuristic::LandmarkHeuristic()
     {
         this->task = nullptr;
+        numWords   = 0;
     }
 
     LandmarkHeuristic::~LandmarkHeuristic() {}
@@ -248,6 +265,11 @@ namespace grstaps
         for (i = 0; i < rootNodes.size(); i++) {
             cout << "Root node: " << rootNodes[i]->toString(task, false) << endl;
         }*/
+        for(i = 0; i < nodes.size(); i++)
+        {
+            nodes[i]->setIndex(i);
+        }
+        numWords = (nodes.size() + 63) >> 6;
     }
 
     bool LandmarkHeuristic::hasRootPredecessor(LandmarkCheck* n)
@@ -315,32 +337,76 @@ namespace grstaps
         }
     }
 
-    void LandmarkHeuristic::uncheckNodes()
+    // Marks the landmarks that can be progressed with the effects of the action or in the given state. A landmark
+    // can be progressed if it is a root node or if any of its predecessors has already been achieved
+    void LandmarkHeuristic::progress(uint64_t* achieved, SASAction* a, TState* state) const
     {
-        for(unsigned int i = 0; i < nodes.size(); i++)
+        std::vector<LandmarkCheck*> openNodes;
+        for(LandmarkCheck* l : rootNodes)
         {
-            // cout << nodes[i]->toString(task, false) << " unchecked" << endl;
-            nodes[i]->uncheck();
+            if(!l->isChecked(achieved))
+            {
+                openNodes.push_back(l);
+            }
         }
-    }
-
-    uint16_t LandmarkHeuristic::evaluate()
-    {
-        uint16_t h = 0;
-        for(unsigned int i = 0; i < nodes.size(); i++)
+        for(LandmarkCheck* l : nodes)
         {
-            if(!nodes[i]->isChecked())
+            if(l->isChecked(achieved))
             {
-                h++;
+                for(unsigned int i = 0; i < l->numNext(); i++)
+                {
+                    if(!l->getNext(i)->isChecked(achieved))
+                    {
+                        openNodes.push_back(l->getNext(i));
+                    }
+                }
+            }
+        }
+        while(!openNodes.empty())
+        {
+            LandmarkCheck* l = openNodes.back();
+            openNodes.pop_back();
+            if(l->isChecked(achieved) || !((a != nullptr && l->isAchievedBy(a)) || (state != nullptr && l->goOn(state))))
+            {
+                continue;
+            }
+            l->check(achieved);
+            for(unsigned int i = 0; i < l->numNext(); i++)
+            {
+                if(!l->getNext(i)->isChecked(achieved))
+                {
+                    openNodes.push_back(l->getNext(i));
+                }
             }
         }
-        return h;
     }
 
-    void LandmarkHeuristic::copyRootNodes(std::vector<LandmarkCheck*>* v)
+    // The bitset is copied from the closest evaluated ancestor, and then progressed with the actions added since
+    // that ancestor and the frontier state of the plan
+    uint64_t* LandmarkHeuristic::computeAchievedLandmarks(Plan* p, TState* state) const
     {
-        v->clear();
-        v->insert(v->end(), rootNodes.begin(), rootNodes.end());
+        if(numWords == 0)
+        {
+            return nullptr;
+        }
+        std::vector<Plan*> path;
+        Plan* ancestor = p->parentPlan;
+        while(ancestor != nullptr && ancestor->achievedLandmarks == nullptr)
+        {
+            path.push_back(ancestor);
+            ancestor = ancestor->parentPlan;
+        }
+        uint64_t* achieved = new uint64_t[numWords];
+        for(unsigned int i = 0; i < numWords; i++)
+        {
+            achieved[i] = ancestor == nullptr ? 0 : ancestor->achievedLandmarks[i];
+        }
+        for(int i = (int)path.size() - 1; i >= 0; i--)
+        {
+            progress(achieved, path[i]->action, nullptr);
+        }
+        progress(achieved, p->action, state);
+        return achieved;
     }
 
     std::string LandmarkHeuristic::toString(SASTask* task)
@@ -4,7 +4,6 @@
 #include <iomanip>
 #include <sstream>
 
-#include "grstaps/task_planning/landmark_heuristic.hpp"
 #include "grstaps/task_planning/state.hpp"
 
 namespace grstaps
@@ -156,7 +155,7 @@ namespace grstaps
 
     // Returns the frontier state for the current plan given a valid topological order
     // Returns nullptr if there are unsolvable constraints (numerical or temporal)
-    TState* Linearizer::getFrontierState(SASTask* task, LandmarkHeuristic* hLand)
+    TState* Linearizer::getFrontierState(SASTask* task)
     {  //, double* timeNewStep) {
         unsigned int numActions = basePlanComponents.size();
         if(plan != nullptr)
@@ -164,7 +163,7 @@ namespace grstaps
             numActions++;
         }
         unsigned int numTimeSteps = numActions << 1;  // linearOrder->size() + 1;
-        TState* state             = linearize(numActions, numTimeSteps, task, hLand);
+        TState* state             = linearize(numActions, numTimeSteps, task);
         if(state != nullptr)
         {
             // if (timeNewStep != nullptr) *timeNewStep = time[numTimeSteps - 1];
@@ -183,7 +182,7 @@ namespace grstaps
         unsigned int numTimeSteps = numActions << 1;
         double makespan           = 0;
         int numPlanActions        = 0;
-        TState* state             = linearize(numActions, numTimeSteps, task, nullptr);
+        TState* state             = linearize(numActions, numTimeSteps, task);
         bool lastActionIsGoal     = p->action != nullptr && p->action->isGoal;
         unsigned int last         = lastActionIsGoal ? numActions - 1 : numActions;
         std::vector<LinearStep> linearSteps;
@@ -223,10 +222,7 @@ namespace grstaps
     // Linearizes the plan and returns the frontier state. Starting time of the time-points are
     // stores in "time" array and action durations in the "duration" array. If there is no valid
     // action schedule, nullptr is returned
-    TState* Linearizer::linearize(unsigned int numActions,
-                                  unsigned int numTimeSteps,
-                                  SASTask* task,
-                                  LandmarkHeuristic* hLand)
+    TState* Linearizer::linearize(unsigned int numActions, unsigned int numTimeSteps, SASTask* task)
     {
         bool invalidPlan = false;
         std::vector<TTimePoint> linearOrder(numTimeSteps);
@@ -287,10 +283,6 @@ namespace grstaps
                     }
                 }
             }
-            if(hLand != nullptr)
-            {  // Calculate hLand heuristic value
-                computeAchievedLandmarks(numTimeSteps, hLand);
-            }
         }
         else
         {
@@ -300,53 +292,6 @@ namespace grstaps
         return invalidPlan ? nullptr : state;
     }
 
-    void Linearizer::computeAchievedLandmarks(unsigned int numTimeSteps, LandmarkHeuristic* hLand)
-    {
-        initializeOpenNodes(hLand);
-        TState state(initialState);  // Make a copy of the initial state
-        pq.clear();
-        for(unsigned int i = 2; i < numTimeSteps; i++)
-        {
-            Plan* p = getPlan(i >> 1);
-            pq.add(new ScheduledPoint(i, time[i], p));
-        }
-        ScheduledPoint* p;
-        unsigned int j;
-        LandmarkCheck *l, *al;
-        SASAction* a;
-        while(pq.size() > 0)
-        {
-            p = (ScheduledPoint*)pq.poll();
-            a = p->plan->action;
-            // cout << "Executing " << p->a->name << endl;
-            updateState(p->p, a, &state, duration[p->p >> 1]);
-            delete p;
-            j = 0;
-            while(j < openNodes.size())
-            {
-                l = openNodes[j];
-                // cout << "Landmark " << l->toString(task, false) << endl;
-                if(l->goOn(&state))
-                {  // The landmark holds in the state and we can progress
-                    l->check();
-                    openNodes.erase(openNodes.begin() + j);  // Remove node from the open nodes list
-                    for(unsigned int k = 0; k < l->numNext(); k++)
-                    {  // Go to the adjacent nodes
-                        al = l->getNext(k);
-                        if(!al->isChecked() && !findOpenNode(al))
-                        {
-                            openNodes.push_back(al);  // Non-visited node -> append to open nodes
-                        }
-                    }
-                }
-                else
-                {
-                    j++;
-                }
-            }
-        }
-    }
-
     bool Linearizer::checkSolution(unsigned int numTimeSteps)
     {
         // cout << "---------------- SOL -------------" << endl;
@@ -956,12 +901,6 @@ namespace grstaps
         delete[] numState;
     }
 
-    void Linearizer::initializeOpenNodes(LandmarkHeuristic* hLand)
-    {
-        hLand->uncheckNodes();
-        hLand->copyRootNodes(&openNodes);
-    }
-
     bool Linearizer::checkValidInitialSchedule(std::vector<TTimePoint>* linearOrder)
     {
         // if (debug) {
@@ -1312,18 +1251,6 @@ namespace grstaps
         return false;
     }
 
-    bool Linearizer::findOpenNode(LandmarkCheck* l)
-    {
-        for(unsigned int i = 0; i < openNodes.size(); i++)
-        {
-            if(openNodes[i] == l)
-            {
-                return true;
-            }
-        }
-        return false;
-    }
-
     void Linearizer::updateNumState(TTimePoint p, SASAction* a, float* numState, double dur)
     {
         std::vector<SASNumericEffect>* numEff = (p & 1) == 0 ? &(a->startNumEff) : &(a->endNumEff);
@@ -1429,7 +1356,7 @@ namespace grstaps
         setCurrentPlan(nullptr);
         unsigned int numActions   = basePlanComponents.size();
         unsigned int numTimeSteps = numActions << 1;
-        TState* state             = linearize(numActions, numTimeSteps, task, nullptr);
+        TState* state             = linearize(numActions, numTimeSteps, task);
         bool lastActionIsGoal     = p->action != nullptr && p->action->isGoal;
         unsigned int last         = lastActionIsGoal ? numActions - 1 : numActions;
         std::vector<LinearStep> linearSteps;
@@ -1,5 +1,6 @@
 #include "grstaps/task_planning/memoization.hpp"
 
+#include "grstaps/profiler.hpp"
 #include "grstaps/task_planning/plan.hpp"
 #include "grstaps/task_planning/state.hpp"
 
@@ -17,70 +18,99 @@ namespace grstaps
         memo.reserve(INITIAL_MEMO_SIZE);
     }
 
+    Memoization::~Memoization()
+    {
+        clear();
+    }
+
     void Memoization::initialize(SASTask* task)
     {
         this->task   = task;
         initialState = new TState(task);
-        linearizer.setInitialState(initialState, task);
+        pool.initialize(task);
         isRepeatedState(nullptr, initialState);
     }
 
     bool Memoization::isRepeatedState(Plan* p, TState* state)
     {
-        uint64_t code                                                         = state->getCode();
-        std::unordered_map<uint64_t, std::vector<Plan*>*>::const_iterator got = memo.find(code);
+        GRSTAPS_PROFILE_ZONE(MemoLookup);
+        PackedState ps                                                             = pool.pack(state);
+        uint64_t code                                                              = ps.getCode();
+        std::unordered_map<uint64_t, std::vector<MemoEntry>*>::const_iterator got = memo.find(code);
         if(got == memo.end())
         {  // New state
-            memo[code] = new std::vector<Plan*>(1, p);
+            memo[code] = new std::vector<MemoEntry>(1, MemoEntry(p, ps));
             return false;
         }
         else
         {
-            std::vector<Plan*>* collisions = got->second;
+            std::vector<MemoEntry>* collisions = got->second;
             for(unsigned int i = 0; i < collisions->size(); i++)
             {
-                Plan* pc = collisions->at(i);
-                if(pc == nullptr)
-                {
-                    if(state->compareTo(initialState))
-                    {
-                        return true;
-                    }
-                }
-                else if(sameState(state, pc))
+                MemoEntry& entry = (*collisions)[i];
+                if(ps.compareTo(entry.state))
                 {
-                    if(p->gc >= pc->gc)
+                    pool.release(ps);
+                    if(entry.plan == nullptr || p->gc >= entry.plan->gc)
                     {
+                        GRSTAPS_PROFILE_COUNT(MemoRepeatedState);
                         return true;  // Same state and worse g
                     }
                     else
                     {  // Same state but better g
-                        (*collisions)[i] = p;
+                        entry.plan = p;
                         return false;
                     }
                 }
             }
-            collisions->push_back(p);
+            collisions->emplace_back(p, ps);
             return false;
         }
     }
 
-    bool Memoization::sameState(TState* state, Plan* pc)
+    void Memoization::clear()
     {
-        linearizer.setCurrentBasePlan(pc);
-        linearizer.setCurrentPlan(nullptr);
-        TState* sc = linearizer.getFrontierState(task, nullptr);
-        if(sc == nullptr)
+        for(auto it = memo.begin(); it != memo.end(); ++it)
         {
-            return true;
+            delete it->second;
         }
-        bool equal = state->compareTo(sc);
-        delete sc;
-        return equal;
+        memo.clear();
+        pool.clear();
     }
 
-    void Memoization::clear()
+    /********************************************************/
+    /* CLASS: ConcurrentMemoization                         */
+    /********************************************************/
+
+    ConcurrentMemoization::ConcurrentMemoization()
     {
-        memo.clear();
+        numShards = 0;
+    }
+
+    void ConcurrentMemoization::initialize(SASTask* task, unsigned int numShards)
+    {
+        this->numShards = numShards;
+        shards.reset(new Memoization[numShards]);
+        locks.reset(new std::mutex[numShards]);
+        for(unsigned int i = 0; i < numShards; i++)
+        {
+            shards[i].initialize(task);
+        }
+    }
+
+    bool ConcurrentMemoization::isRepeatedState(Plan* p, TState* state)
+    {
+        unsigned int shard = state->getCode() % numShards;
+        std::lock_guard<std::mutex> lock(locks[shard]);
+        return shards[shard].isRepeatedState(p, state);
+    }
+
+    void ConcurrentMemoization::clear()
+    {
+        for(unsigned int i = 0; i < numShards; i++)
+        {
+            std::lock_guard<std::mutex> lock(locks[i]);
+            shards[i].clear();
+        }
     }
-}  // namespace grstaps
\ No newline at end of file
+}  // namespace grstaps
@@ -0,0 +1,71 @@
+#include "grstaps/task_planning/mutex_matrix.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace grstaps
+{
+    MutexMatrix::MutexMatrix()
+    {
+        size     = 0;
+        rowWords = 0;
+        bits     = nullptr;
+    }
+
+    MutexMatrix::~MutexMatrix()
+    {
+        clear();
+    }
+
+    void MutexMatrix::initialize(unsigned int size, size_t expectedPairs)
+    {
+        clear();
+        this->size      = size;
+        rowWords        = (((size + 63) >> 6) + 7) & ~(size_t)7;
+        size_t numBytes = rowWords * size * sizeof(uint64_t);
+        size_t sparse   = expectedPairs * MUTEX_MATRIX_BYTES_PER_PAIR;
+        if(numBytes <= MUTEX_MATRIX_MIN_DENSE_BYTES || (numBytes <= MUTEX_MATRIX_MAX_DENSE_BYTES && numBytes <= sparse))
+        {
+            bits = static_cast<uint64_t*>(std::aligned_alloc(64, numBytes == 0 ? 64 : numBytes));
+            std::memset(bits, 0, numBytes);
+        }
+        else
+        {
+            pairs.reserve(expectedPairs);
+        }
+    }
+
+    void MutexMatrix::clear()
+    {
+        std::free(bits);
+        bits = nullptr;
+        pairs.clear();
+        size     = 0;
+        rowWords = 0;
+    }
+
+    void MutexMatrix::getPairs(std::vector<uint64_t>* codes) const
+    {
+        if(bits == nullptr)
+        {
+            size_t first = codes->size();
+            codes->insert(codes->end(), pairs.begin(), pairs.end());
+            std::sort(codes->begin() + first, codes->end());
+            return;
+        }
+        for(unsigned int i = 0; i < size; i++)
+        {
+            const uint64_t* row = bits + i * rowWords;
+            for(size_t w = 0; w < rowWords; w++)
+            {
+                uint64_t word = row[w];
+                while(word != 0)
+                {
+                    codes->push_back(getCode(i, (w << 6) + __builtin_ctzll(word)));
+                    word &= word - 1;
+                }
+            }
+        }
+    }
+}  // namespace grstaps
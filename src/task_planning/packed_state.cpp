@@ -0,0 +1,228 @@
+#include "grstaps/task_planning/packed_state.hpp"
+
+#include <algorithm>
+
+#include "grstaps/task_planning/state.hpp"
+
+namespace grstaps
+{
+    /********************************************************/
+    /* CLASS: PackedStateLayout                             */
+    /********************************************************/
+
+    PackedStateLayout::PackedStateLayout()
+    {
+        numSASVars = numNumVars = numSASWords = numWords = 0;
+    }
+
+    // Computes the domain of each variable (every value it can take or be compared with) and the position
+    // of its bits in the packed words
+    void PackedStateLayout::initialize(SASTask* task)
+    {
+        numSASVars = task->variables.size();
+        numNumVars = task->numVariables.size();
+        std::vector<std::vector<TValue>> domain(numSASVars);
+        for(unsigned int i = 0; i < numSASVars; i++)
+        {
+            SASVariable& v = task->variables[i];
+            for(unsigned int value : v.possibleValues)
+            {
+                domain[i].push_back(value);
+            }
+            for(unsigned int value : v.value)
+            {
+                domain[i].push_back(value);
+            }
+            domain[i].push_back(task->initialState[i]);
+        }
+        auto addConditions = [&domain](std::vector<SASCondition>& c) {
+            for(unsigned int i = 0; i < c.size(); i++)
+            {
+                domain[c[i].var].push_back(c[i].value);
+            }
+        };
+        for(std::vector<SASAction>* actions : {&(task->actions), &(task->goals)})
+        {
+            for(SASAction& a : *actions)
+            {
+                addConditions(a.startCond);
+                addConditions(a.overCond);
+                addConditions(a.endCond);
+                addConditions(a.startEff);
+                addConditions(a.endEff);
+            }
+        }
+
+        word.resize(numSASVars);
+        shift.resize(numSASVars);
+        mask.resize(numSASVars);
+        minValue.resize(numSASVars);
+        codeRange.resize(numSASVars);
+        codeOffset.resize(numSASVars);
+        outOfRange.resize(numSASVars);
+        valueOffset.resize(numSASVars);
+        localCode.clear();
+        globalValue.clear();
+        unsigned int currentWord = 0, currentBit = 0;
+        for(unsigned int i = 0; i < numSASVars; i++)
+        {
+            std::vector<TValue>& d = domain[i];
+            std::sort(d.begin(), d.end());
+            d.erase(std::unique(d.begin(), d.end()), d.end());
+            unsigned int bits = 0;
+            while((1UL << bits) < d.size())
+            {
+                bits++;
+            }
+            if(currentBit + bits > 64)
+            {
+                currentWord++;
+                currentBit = 0;
+            }
+            word[i]  = currentWord;
+            shift[i] = currentBit;
+            mask[i]  = bits == 64 ? ~0UL : (1UL << bits) - 1;
+            currentBit += bits;
+
+            valueOffset[i] = globalValue.size();
+            globalValue.insert(globalValue.end(), d.begin(), d.end());
+
+            // MAX_UINT16 (undefined value) is kept out of the dense table
+            outOfRange[i]       = mask[i] + 1;
+            unsigned int numDef = d.size();
+            if(d.back() == MAX_UINT16)
+            {
+                outOfRange[i] = numDef - 1;
+                numDef--;
+            }
+            minValue[i]   = numDef > 0 ? d[0] : 0;
+            codeRange[i]  = numDef > 0 ? d[numDef - 1] - d[0] + 1 : 0;
+            codeOffset[i] = localCode.size();
+            localCode.resize(localCode.size() + codeRange[i], mask[i] + 1);
+            for(unsigned int j = 0; j < numDef; j++)
+            {
+                localCode[codeOffset[i] + d[j] - minValue[i]] = j;
+            }
+        }
+        numSASWords = numSASVars == 0 ? 0 : currentWord + 1;
+        numWords    = numSASWords + (numNumVars + 1) / 2;
+        numWords += numWords & 1;  // Even number of words for the 128-bit comparisons
+    }
+
+    /********************************************************/
+    /* CLASS: PackedState                                   */
+    /********************************************************/
+
+    void PackedState::unpack(TState* s) const
+    {
+        for(unsigned int i = 0; i < layout->numSASVars; i++)
+        {
+            s->state[i] = getSASValue(i);
+        }
+        for(unsigned int i = 0; i < layout->numNumVars; i++)
+        {
+            s->numState[i] = getNumValue(i);
+        }
+    }
+
+    /********************************************************/
+    /* CLASS: PackedStatePool                               */
+    /********************************************************/
+
+    PackedStatePool::PackedStatePool()
+    {
+        usedInBlock = PACKED_STATE_BLOCK_SIZE;
+    }
+
+    PackedStatePool::~PackedStatePool()
+    {
+        for(unsigned int i = 0; i < blocks.size(); i++)
+        {
+            delete[] blocks[i];
+        }
+    }
+
+    void PackedStatePool::initialize(SASTask* task)
+    {
+        clear();
+        for(unsigned int i = 0; i < blocks.size(); i++)
+        {
+            delete[] blocks[i];
+        }
+        blocks.clear();
+        usedInBlock = PACKED_STATE_BLOCK_SIZE;
+        layout.initialize(task);
+    }
+
+    uint64_t* PackedStatePool::allocate()
+    {
+        uint64_t* words;
+        if(!freeStates.empty())
+        {
+            words = freeStates.back();
+            freeStates.pop_back();
+        }
+        else
+        {
+            if(usedInBlock == PACKED_STATE_BLOCK_SIZE)
+            {
+                blocks.push_back(new uint64_t[(size_t)PACKED_STATE_BLOCK_SIZE * layout.numWords]);
+                usedInBlock = 0;
+            }
+            words = blocks.back() + (size_t)usedInBlock * layout.numWords;
+            usedInBlock++;
+        }
+        std::fill(words, words + layout.numWords, 0);
+        return words;
+    }
+
+    PackedState PackedStatePool::pack(TState* s)
+    {
+        PackedState ps(&layout, allocate());
+        for(unsigned int i = 0; i < layout.numSASVars; i++)
+        {
+            ps.words[layout.word[i]] |= layout.encodeShifted(i, s->state[i]);
+        }
+        for(unsigned int i = 0; i < layout.numNumVars; i++)
+        {
+            ps.setNumValue(i, s->numState[i]);
+        }
+        return ps;
+    }
+
+    PackedState PackedStatePool::copy(const PackedState& s)
+    {
+        PackedState ps(&layout, allocate());
+        std::copy(s.words, s.words + layout.numWords, ps.words);
+        return ps;
+    }
+
+    void PackedStatePool::release(PackedState& s)
+    {
+        if(s.words != nullptr)
+        {
+            freeStates.push_back(s.words);
+            s.words = nullptr;
+        }
+    }
+
+    // Makes all the allocated states available again, keeping the blocks
+    void PackedStatePool::clear()
+    {
+        freeStates.clear();
+        for(unsigned int i = 0; i + 1 < blocks.size(); i++)
+        {
+            for(unsigned int j = 0; j < PACKED_STATE_BLOCK_SIZE; j++)
+            {
+                freeStates.push_back(blocks[i] + (size_t)j * layout.numWords);
+            }
+        }
+        if(!blocks.empty())
+        {
+            for(unsigned int j = 0; j < usedInBlock; j++)
+            {
+                freeStates.push_back(blocks.back() + (size_t)j * layout.numWords);
+            }
+        }
+    }
+}  // namespace grstaps
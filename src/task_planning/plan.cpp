@@ -1,4 +1,5 @@
 #include "grstaps/task_planning/plan.hpp"
+#include <algorithm>
 #include <iostream>
 
 // local
@@ -30,6 +31,7 @@ namespace grstaps
         openCond         = nullptr;
         h = hAux                     = FLOAT_INFINITY;
         hLand                        = MAX_UINT16;
+        achievedLandmarks            = nullptr;
         gc                           = 0;
         g                            = parentPlan == nullptr ? 0 : parentPlan->g + 1;
         repeatedState                = false;
@@ -47,6 +49,7 @@ namespace grstaps
         openCond         = nullptr;
         h = hAux                     = FLOAT_INFINITY;
         hLand                        = MAX_UINT16;
+        achievedLandmarks            = nullptr;
         gc                           = 0;
         g                            = parentPlan == nullptr ? 0 : parentPlan->g + 1;
         repeatedState                = false;
@@ -203,12 +206,24 @@ namespace grstaps
             delete openCond;
             openCond = nullptr;
         }
+        delete[] achievedLandmarks;
     }
 
-    // Adds the children of a plan
+    // Adds the children of a plan. If the plan already has children, only the new ones are appended
     void Plan::addChildren(std::vector<Plan*>& suc)
     {
-        childPlans = new std::vector<Plan*>(suc);
+        if(childPlans == nullptr)
+        {
+            childPlans = new std::vector<Plan*>(suc);
+            return;
+        }
+        for(Plan* p: suc)
+        {
+            if(std::find(childPlans->begin(), childPlans->end(), p) == childPlans->end())
+            {
+                childPlans->push_back(p);
+            }
+        }
     }
 
     // Removes the child plans. Call only if all the child plans have been expanded
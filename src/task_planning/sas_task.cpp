@@ -1,4 +1,5 @@
 #include "grstaps/task_planning/sas_task.hpp"
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
@@ -287,9 +288,11 @@ namespace grstaps
         createNewValue("<true>", FICTITIOUS_FUNCTION);
         createNewValue("<false>", FICTITIOUS_FUNCTION);
         createNewValue("<undefined>", FICTITIOUS_FUNCTION);
-        requirers         = nullptr;
-        producers         = nullptr;
-        numGoalsInPlateau = 1;
+        requirers                = nullptr;
+        producers                = nullptr;
+        numGoalsInPlateau        = 1;
+        numFluents               = 0;
+        hasPermanentMutexActions = false;
     }
 
     SASTask::~SASTask()
@@ -318,31 +321,67 @@ namespace grstaps
         }
     }
 
-    // Adds a mutex relationship between (var1, value1) and (var2, value2)
+    // Adds a mutex relationship between (var1, value1) and (var2, value2). The pairs are stored in the mutex
+    // matrix by computePermanentMutex, once all the variables and actions are known
     void SASTask::addMutex(unsigned int var1, unsigned int value1, unsigned int var2, unsigned int value2)
     {
-        mutex[getMutexCode(var1, value1, var2, value2)] = true;
-        mutex[getMutexCode(var2, value2, var1, value1)] = true;
+        mutexCodes.push_back(getMutexCode(var1, value1, var2, value2));
+        mutexCodes.push_back(getMutexCode(var2, value2, var1, value1));
         // cout << "Mutex added: " << variables[var1].name << "=" << values[value1].name << " and " <<
         //	variables[var2].name << "=" << values[value2].name << endl;
     }
 
-    // Checks if (var1, value1) and (var2, value2) are mutex
-    bool SASTask::isMutex(unsigned int var1, unsigned int value1, unsigned int var2, unsigned int value2)
+    // Assigns consecutive ids to the values of each variable, from the lowest to the highest value that appears
+    // in the domain, the actions, the goals or the mutex relationships
+    void SASTask::computeFluentIds()
     {
-        return mutex.find(getMutexCode(var1, value1, var2, value2)) != mutex.end();
-    }
-
-    bool SASTask::isPermanentMutex(unsigned int var1, unsigned int value1, unsigned int var2, unsigned int value2)
-    {
-        return permanentMutex.find(getMutexCode(var1, value1, var2, value2)) != mutex.end();
-    }
-
-    bool SASTask::isPermanentMutex(SASAction* a1, SASAction* a2)
-    {
-        uint64_t n = a1->index;
-        n          = (n << 32) + a2->index;
-        return permanentMutexActions.find(n) != permanentMutexActions.end();
+        unsigned int numVars = variables.size();
+        std::vector<TValue> maxValue(numVars, 0);
+        fluentMinValue.assign(numVars, MAX_UINT16);
+        auto addValue = [this, &maxValue](unsigned int var, unsigned int value) {
+            if(var < maxValue.size() && value < MAX_UINT16)
+            {
+                fluentMinValue[var] = std::min(fluentMinValue[var], (TValue)value);
+                maxValue[var]       = std::max(maxValue[var], (TValue)value);
+            }
+        };
+        for(unsigned int i = 0; i < numVars; i++)
+        {
+            for(unsigned int value : variables[i].possibleValues)
+            {
+                addValue(i, value);
+            }
+            for(unsigned int value : variables[i].value)
+            {
+                addValue(i, value);
+            }
+        }
+        for(std::vector<SASAction>* v : {&actions, &goals})
+        {
+            for(SASAction& a : *v)
+            {
+                for(std::vector<SASCondition>* c : {&a.startCond, &a.overCond, &a.endCond, &a.startEff, &a.endEff})
+                {
+                    for(SASCondition& cond : *c)
+                    {
+                        addValue(cond.var, cond.value);
+                    }
+                }
+            }
+        }
+        for(TMutex code : mutexCodes)
+        {
+            addValue((code >> 48) & 0xFFFF, (code >> 32) & 0xFFFF);
+        }
+        fluentValueRange.resize(numVars);
+        fluentOffset.resize(numVars);
+        numFluents = 0;
+        for(unsigned int i = 0; i < numVars; i++)
+        {
+            fluentValueRange[i] = fluentMinValue[i] == MAX_UINT16 ? 0 : maxValue[i] - fluentMinValue[i] + 1;
+            fluentOffset[i]     = numFluents;
+            numFluents += fluentValueRange[i];
+        }
     }
 
     // Adds a new variable
@@ -521,11 +560,9 @@ namespace grstaps
     void SASTask::computeMutexWithVarValues()
     {
         uint32_t vv1, vv2;
-        std::unordered_map<uint64_t, bool>::const_iterator got = mutex.begin();
         std::unordered_map<uint32_t, std::vector<uint32_t>*>::const_iterator it;
-        for(; got != mutex.end(); ++got)
+        for(TMutex n : mutexCodes)
         {
-            uint64_t n = got->first;
             vv2        = n & 0xFFFFFFFF;
             vv1        = (uint32_t)(n >> 32);
             it         = mutexWithVarValue.find(vv1);
@@ -565,12 +602,7 @@ namespace grstaps
             cout << " " << variables[getVariableIndex(itg->first)].name << "=" << values[getValueIndex(itg->first)].name
         << endl;
         */
-        unsigned int numActions = actions.size();
-        bool visited[numActions];
-        for(unsigned int i = 0; i < numActions; i++)
-        {
-            visited[i] = false;
-        }
+        std::vector<bool> visited(actions.size(), false);
         std::vector<TVarValue> state;
         std::unordered_map<TVarValue, bool> visitedVarValue;
         state.push_back(vv);
@@ -606,51 +638,118 @@ namespace grstaps
     void SASTask::computePermanentMutex()
     {
         // clock_t tini = clock();
+        computeFluentIds();
+        std::sort(mutexCodes.begin(), mutexCodes.end());
+        mutexCodes.erase(std::unique(mutexCodes.begin(), mutexCodes.end()), mutexCodes.end());
+        mutex.initialize(numFluents, mutexCodes.size());
+        for(TMutex code : mutexCodes)
+        {
+            mutex.set(getFluentId((code >> 48) & 0xFFFF, (code >> 32) & 0xFFFF),
+                      getFluentId((code >> 16) & 0xFFFF, code & 0xFFFF));
+        }
         computeMutexWithVarValues();
-        std::unordered_map<uint32_t, std::vector<uint32_t>*>::const_iterator it;
-        std::unordered_map<uint32_t, bool>::const_iterator ug;
-        for(it = mutexWithVarValue.begin(); it != mutexWithVarValue.end(); ++it)
+        mutexCodes.clear();
+        mutexCodes.shrink_to_fit();
+        // The reachability of each fluent is checked in parallel
+        std::vector<std::pair<TVarValue, std::vector<TVarValue>*>> entries(mutexWithVarValue.begin(),
+                                                                            mutexWithVarValue.end());
+        std::vector<std::vector<TMutex>> entryCodes(entries.size());
+#pragma omp parallel for schedule(dynamic)
+        for(int i = 0; i < (int)entries.size(); i++)
         {
-            // cout << it->second->size() << endl;
             std::unordered_map<uint32_t, bool> goals;
-            for(unsigned int i = 0; i < it->second->size(); i++)
+            for(unsigned int j = 0; j < entries[i].second->size(); j++)
             {
-                goals[it->second->at(i)] = true;
+                goals[entries[i].second->at(j)] = true;
             }
-            checkReachability(it->first, &goals);
-            for(ug = goals.begin(); ug != goals.end(); ++ug)
+            checkReachability(entries[i].first, &goals);
+            for(auto ug = goals.begin(); ug != goals.end(); ++ug)
+            {
+                entryCodes[i].push_back((((TMutex)entries[i].first) << 32) + ug->first);
+            }
+        }
+        size_t numPermanent = 0;
+        for(unsigned int i = 0; i < entryCodes.size(); i++)
+        {
+            numPermanent += entryCodes[i].size();
+        }
+        permanentMutex.initialize(numFluents, numPermanent);
+        std::vector<std::vector<TVarValue>> partners(numFluents);  // Fluent -> permanent mutex fluents
+        for(unsigned int i = 0; i < entryCodes.size(); i++)
+        {
+            for(TMutex code : entryCodes[i])
             {
-                TMutex code          = (((TMutex)it->first) << 32) + ug->first;
-                permanentMutex[code] = true;
+                uint32_t f = getFluentId((code >> 48) & 0xFFFF, (code >> 32) & 0xFFFF);
+                permanentMutex.set(f, getFluentId((code >> 16) & 0xFFFF, code & 0xFFFF));
+                partners[f].push_back(code & 0xFFFFFFFF);
             }
         }
-        if(permanentMutex.size() > 0)
+        computePermanentMutexActions(partners);
+        // cout << (float) (((int) (1000 * (clock() - tini)/(float) CLOCKS_PER_SEC))/1000.0) << " sec." << endl;
+    }
+
+    // Two actions are permanent mutex if each one has an effect that is permanent mutex with a condition of the
+    // other one. Instead of checking every pair of actions, the candidates for each action a1 are obtained by
+    // following its effects to their permanent mutex fluents and to the actions that require them. Actions are
+    // processed in parallel and the pairs found by each thread are merged at the end
+    void SASTask::computePermanentMutexActions(std::vector<std::vector<TVarValue>>& partners)
+    {
+        int numActions = actions.size();
+        std::vector<std::vector<uint64_t>> threadPairs;
+#pragma omp parallel
         {
-            unsigned int numActions = actions.size();
-            for(unsigned int i = 0; i < numActions - 1; i++)
+            std::vector<uint64_t> pairs;
+            std::vector<int> visited(numActions, -1);
+#pragma omp for schedule(dynamic, 16)
+            for(int i = 0; i < numActions; i++)
             {
                 SASAction* a1 = &(actions[i]);
-                for(unsigned int j = i + 1; j < numActions; j++)
+                for(std::vector<SASCondition>* eff : {&a1->startEff, &a1->endEff})
                 {
-                    if(checkActionMutex(a1, &(actions[j])))
+                    for(SASCondition& e : *eff)
                     {
-                        // cout << a1->name << " <- mutex -> " << actions[j].name << endl;
-                        uint64_t n               = a1->index;
-                        n                        = (n << 32) + actions[j].index;
-                        permanentMutexActions[n] = true;
-                        n                        = actions[j].index;
-                        n                        = (n << 32) + a1->index;
-                        permanentMutexActions[n] = true;
+                        uint32_t f = getFluentId(e.var, e.value);
+                        if(f == NO_FLUENT)
+                        {
+                            continue;
+                        }
+                        for(TVarValue vv : partners[f])
+                        {
+                            std::vector<SASAction*>& req = requirers[getVariableIndex(vv)][getValueIndex(vv)];
+                            for(SASAction* a2 : req)
+                            {
+                                int j = a2->index;
+                                if(j > i && visited[j] != i)
+                                {
+                                    visited[j] = i;  // a1 -> a2 ordering holds, a2 -> a1 must be checked
+                                    if(checkActionOrdering(a2, a1))
+                                    {
+                                        pairs.push_back((((uint64_t)i) << 32) + j);
+                                    }
+                                }
+                            }
+                        }
                     }
                 }
             }
+#pragma omp critical
+            threadPairs.push_back(std::move(pairs));
         }
-        // cout << (float) (((int) (1000 * (clock() - tini)/(float) CLOCKS_PER_SEC))/1000.0) << " sec." << endl;
-    }
-
-    bool SASTask::checkActionMutex(SASAction* a1, SASAction* a2)
-    {
-        return checkActionOrdering(a1, a2) && checkActionOrdering(a2, a1);
+        size_t numPairs = 0;
+        for(unsigned int i = 0; i < threadPairs.size(); i++)
+        {
+            numPairs += threadPairs[i].size();
+        }
+        permanentMutexActions.initialize(numActions, 2 * numPairs);
+        for(unsigned int i = 0; i < threadPairs.size(); i++)
+        {
+            for(uint64_t code : threadPairs[i])
+            {
+                permanentMutexActions.set(code >> 32, code & 0xFFFFFFFF);
+                permanentMutexActions.set(code & 0xFFFFFFFF, code >> 32);
+            }
+        }
+        hasPermanentMutexActions = numPairs > 0;
     }
 
     bool SASTask::checkActionOrdering(SASAction* a1, SASAction* a2)
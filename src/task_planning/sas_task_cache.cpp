@@ -0,0 +1,603 @@
+#include "grstaps/task_planning/sas_task_cache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <../lib/unordered_map/robin_hood.h>
+
+namespace grstaps
+{
+    /********************************************************/
+    /* CLASS: SASTaskCache                                  */
+    /********************************************************/
+
+    // Mapping of a whole file in memory
+    class MappedFile
+    {
+       public:
+        const char* data;
+        size_t length;
+
+        MappedFile(const char* fileName)
+        {
+            data   = nullptr;
+            length = 0;
+            int fd = open(fileName, O_RDONLY);
+            if(fd < 0)
+            {
+                return;
+            }
+            struct stat info;
+            if(fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+            {
+                void* buffer = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(buffer != MAP_FAILED)
+                {
+                    data   = static_cast<const char*>(buffer);
+                    length = info.st_size;
+                }
+            }
+            close(fd);
+        }
+
+        ~MappedFile()
+        {
+            if(data != nullptr)
+            {
+                munmap(const_cast<char*>(data), length);
+            }
+        }
+    };
+
+    SASTaskCache::SASTaskCache(const char* directory,
+                               const char* domainFileName,
+                               const char* problemFileName,
+                               bool keepStaticData,
+                               bool noSAS)
+    {
+        this->keepStaticData = keepStaticData;
+        key                  = 0;
+        pos                  = nullptr;
+        end                  = nullptr;
+        failed               = false;
+        uint64_t domainHash, problemHash;
+        if(directory == nullptr || !hashFile(domainFileName, &domainHash) || !hashFile(problemFileName, &problemHash))
+        {
+            return;
+        }
+        key = domainHash ^ (problemHash * 0x9E3779B97F4A7C15ULL) ^ (keepStaticData ? 0x1ULL : 0) ^
+              (noSAS ? 0x2ULL : 0);
+        std::ostringstream name;
+        name << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".sas";
+        fileName = name.str();
+    }
+
+    // Hash of the contents of a file. Returns false if the file cannot be read
+    bool SASTaskCache::hashFile(const char* fileName, uint64_t* hash)
+    {
+        if(fileName == nullptr)
+        {
+            return false;
+        }
+        MappedFile file(fileName);
+        if(file.data == nullptr)
+        {
+            return false;
+        }
+        *hash = robin_hood::hash_bytes(file.data, file.length) ^ file.length;
+        return true;
+    }
+
+    SASTask* SASTaskCache::load()
+    {
+        if(!isEnabled())
+        {
+            return nullptr;
+        }
+        MappedFile file(fileName.c_str());
+        if(file.data == nullptr)
+        {
+            return nullptr;
+        }
+        pos    = file.data;
+        end    = file.data + file.length;
+        failed = false;
+        if(read<uint64_t>() != SAS_TASK_CACHE_MAGIC || read<uint32_t>() != SAS_TASK_CACHE_VERSION ||
+           read<uint64_t>() != key)
+        {
+            return nullptr;
+        }
+        SASTask* task = readTask();
+        if(failed || pos != end)
+        {
+            delete task;
+            return nullptr;
+        }
+        task->computeInitialState();
+        task->computeRequirers();
+        task->computeProducers();
+        task->computeInitialActionsCost(keepStaticData);
+        return task;
+    }
+
+    bool SASTaskCache::save(SASTask* task)
+    {
+        if(!isEnabled())
+        {
+            return false;
+        }
+        buffer.clear();
+        write<uint64_t>(SAS_TASK_CACHE_MAGIC);
+        write<uint32_t>(SAS_TASK_CACHE_VERSION);
+        write<uint64_t>(key);
+        write((uint32_t)task->values.size());
+        for(SASValue& v : task->values)
+        {
+            write(v.fncIndex);
+            writeString(v.name);
+        }
+        write((uint32_t)task->variables.size());
+        for(SASVariable& v : task->variables)
+        {
+            writeString(v.name);
+            writeVector(v.possibleValues);
+            writeVector(v.value);
+            writeVector(v.time);
+        }
+        write((uint32_t)task->numVariables.size());
+        for(NumericVariable& v : task->numVariables)
+        {
+            writeString(v.name);
+            writeVector(v.value);
+            writeVector(v.time);
+        }
+        write((uint32_t)task->actions.size());
+        for(SASAction& a : task->actions)
+        {
+            writeString(a.name);
+            writeAction(a);
+        }
+        write((uint32_t)task->goals.size());
+        for(SASAction& a : task->goals)
+        {
+            writeAction(a);
+        }
+        write((uint32_t)task->preferenceNames.size());
+        for(std::string& name : task->preferenceNames)
+        {
+            writeString(name);
+        }
+        write((uint32_t)task->constraints.size());
+        for(SASConstraint& c : task->constraints)
+        {
+            writeConstraint(c);
+        }
+        write(task->metricType);
+        writeMetric(task->metric);
+        write((uint32_t)task->goalDeadlines.size());
+        for(GoalDeadline& d : task->goalDeadlines)
+        {
+            write(d.time);
+            writeVector(d.goals);
+        }
+        writeVector(task->fluentMinValue);
+        writeVector(task->fluentValueRange);
+        writeMutexMatrix(task->mutex);
+        writeMutexMatrix(task->permanentMutex);
+        writeMutexMatrix(task->permanentMutexActions);
+        write(task->hasPermanentMutexActions);
+
+        std::string tmpFileName = fileName + "." + std::to_string(getpid()) + ".tmp";
+        FILE* f                 = fopen(tmpFileName.c_str(), "wb");
+        if(f == nullptr)
+        {
+            buffer.clear();
+            return false;
+        }
+        bool ok = fwrite(buffer.data(), 1, buffer.size(), f) == buffer.size();
+        ok      = fclose(f) == 0 && ok;
+        ok      = ok && rename(tmpFileName.c_str(), fileName.c_str()) == 0;
+        if(!ok)
+        {
+            remove(tmpFileName.c_str());
+        }
+        buffer.clear();
+        buffer.shrink_to_fit();
+        return ok;
+    }
+
+    void SASTaskCache::writeString(const std::string& s)
+    {
+        write((uint32_t)s.length());
+        buffer.append(s);
+    }
+
+    void SASTaskCache::writeExpression(const SASNumericExpression& e)
+    {
+        write(e.type);
+        write(e.value);
+        write(e.var);
+        write((uint32_t)e.terms.size());
+        for(const SASNumericExpression& t : e.terms)
+        {
+            writeExpression(t);
+        }
+    }
+
+    void SASTaskCache::writeGoalDescription(const SASGoalDescription& g)
+    {
+        write(g.time);
+        write(g.type);
+        write(g.var);
+        write(g.value);
+        write((uint32_t)g.terms.size());
+        for(const SASGoalDescription& t : g.terms)
+        {
+            writeGoalDescription(t);
+        }
+        write((uint32_t)g.exp.size());
+        for(const SASNumericExpression& e : g.exp)
+        {
+            writeExpression(e);
+        }
+    }
+
+    void SASTaskCache::writeConditions(const std::vector<SASCondition>& v)
+    {
+        write((uint32_t)v.size());
+        for(const SASCondition& c : v)
+        {
+            write(c.var);
+            write(c.value);
+            write(c.isModified);
+        }
+    }
+
+    void SASTaskCache::writeNumericConditions(const std::vector<SASNumericCondition>& v)
+    {
+        write((uint32_t)v.size());
+        for(const SASNumericCondition& c : v)
+        {
+            write(c.comp);
+            write((uint32_t)c.terms.size());
+            for(const SASNumericExpression& e : c.terms)
+            {
+                writeExpression(e);
+            }
+        }
+    }
+
+    void SASTaskCache::writeNumericEffects(const std::vector<SASNumericEffect>& v)
+    {
+        write((uint32_t)v.size());
+        for(const SASNumericEffect& e : v)
+        {
+            write(e.op);
+            write(e.var);
+            writeExpression(e.exp);
+        }
+    }
+
+    // The fixed duration and cost of the action are not stored, as they are computed on load
+    void SASTaskCache::writeAction(const SASAction& a)
+    {
+        write((uint32_t)a.duration.size());
+        for(const SASDuration& d : a.duration)
+        {
+            write(d.time);
+            write(d.comp);
+            writeExpression(d.exp);
+        }
+        writeConditions(a.startCond);
+        writeConditions(a.overCond);
+        writeConditions(a.endCond);
+        writeNumericConditions(a.startNumCond);
+        writeNumericConditions(a.overNumCond);
+        writeNumericConditions(a.endNumCond);
+        writeConditions(a.startEff);
+        writeConditions(a.endEff);
+        writeNumericEffects(a.startNumEff);
+        writeNumericEffects(a.endNumEff);
+        write((uint32_t)a.preferences.size());
+        for(const SASPreference& p : a.preferences)
+        {
+            write(p.index);
+            writeGoalDescription(p.preference);
+        }
+    }
+
+    void SASTaskCache::writeConstraint(const SASConstraint& c)
+    {
+        write(c.type);
+        write((uint32_t)c.terms.size());
+        for(const SASConstraint& t : c.terms)
+        {
+            writeConstraint(t);
+        }
+        write(c.preferenceIndex);
+        write((uint32_t)c.goal.size());
+        for(const SASGoalDescription& g : c.goal)
+        {
+            writeGoalDescription(g);
+        }
+        writeVector(c.time);
+    }
+
+    void SASTaskCache::writeMetric(const SASMetric& m)
+    {
+        write(m.type);
+        write(m.value);
+        write(m.index);
+        write((uint32_t)m.terms.size());
+        for(const SASMetric& t : m.terms)
+        {
+            writeMetric(t);
+        }
+    }
+
+    void SASTaskCache::writeMutexMatrix(const MutexMatrix& m)
+    {
+        std::vector<uint64_t> pairs;
+        m.getPairs(&pairs);
+        write(m.getSize());
+        writeVector(pairs);
+    }
+
+    uint32_t SASTaskCache::readSize(size_t minBytes)
+    {
+        uint32_t n = read<uint32_t>();
+        if(failed || n * (uint64_t)std::max(minBytes, (size_t)1) > (uint64_t)(end - pos))
+        {
+            failed = true;
+            return 0;
+        }
+        return n;
+    }
+
+    std::string SASTaskCache::readString()
+    {
+        uint32_t n = readSize(1);
+        std::string s(pos, n);
+        pos += n;
+        return s;
+    }
+
+    void SASTaskCache::readExpression(SASNumericExpression* e)
+    {
+        e->type  = read<char>();
+        e->value = read<float>();
+        e->var   = read<uint16_t>();
+        e->terms.resize(readSize(1));
+        for(SASNumericExpression& t : e->terms)
+        {
+            readExpression(&t);
+        }
+    }
+
+    void SASTaskCache::readGoalDescription(SASGoalDescription* g)
+    {
+        g->time  = read<char>();
+        g->type  = read<char>();
+        g->var   = read<unsigned int>();
+        g->value = read<unsigned int>();
+        g->terms.resize(readSize(1));
+        for(SASGoalDescription& t : g->terms)
+        {
+            readGoalDescription(&t);
+        }
+        g->exp.resize(readSize(1));
+        for(SASNumericExpression& e : g->exp)
+        {
+            readExpression(&e);
+        }
+    }
+
+    void SASTaskCache::readConditions(std::vector<SASCondition>* v)
+    {
+        uint32_t n = readSize(1);
+        v->reserve(n);
+        for(uint32_t i = 0; i < n; i++)
+        {
+            unsigned int var   = read<unsigned int>();
+            unsigned int value = read<unsigned int>();
+            v->emplace_back(var, value);
+            v->back().isModified = read<bool>();
+        }
+    }
+
+    void SASTaskCache::readNumericConditions(std::vector<SASNumericCondition>* v)
+    {
+        v->resize(readSize(1));
+        for(SASNumericCondition& c : *v)
+        {
+            c.comp = read<char>();
+            c.terms.resize(readSize(1));
+            for(SASNumericExpression& e : c.terms)
+            {
+                readExpression(&e);
+            }
+        }
+    }
+
+    void SASTaskCache::readNumericEffects(std::vector<SASNumericEffect>* v)
+    {
+        v->resize(readSize(1));
+        for(SASNumericEffect& e : *v)
+        {
+            e.op  = read<char>();
+            e.var = read<unsigned int>();
+            readExpression(&e.exp);
+        }
+    }
+
+    void SASTaskCache::readAction(SASAction* a)
+    {
+        a->isTIL = false;
+        a->duration.resize(readSize(1));
+        for(SASDuration& d : a->duration)
+        {
+            d.time = read<char>();
+            d.comp = read<char>();
+            readExpression(&d.exp);
+        }
+        readConditions(&a->startCond);
+        readConditions(&a->overCond);
+        readConditions(&a->endCond);
+        readNumericConditions(&a->startNumCond);
+        readNumericConditions(&a->overNumCond);
+        readNumericConditions(&a->endNumCond);
+        readConditions(&a->startEff);
+        readConditions(&a->endEff);
+        readNumericEffects(&a->startNumEff);
+        readNumericEffects(&a->endNumEff);
+        a->preferences.resize(readSize(1));
+        for(SASPreference& p : a->preferences)
+        {
+            p.index = read<unsigned int>();
+            readGoalDescription(&p.preference);
+        }
+    }
+
+    void SASTaskCache::readConstraint(SASConstraint* c)
+    {
+        c->type = read<char>();
+        c->terms.resize(readSize(1));
+        for(SASConstraint& t : c->terms)
+        {
+            readConstraint(&t);
+        }
+        c->preferenceIndex = read<unsigned int>();
+        c->goal.resize(readSize(1));
+        for(SASGoalDescription& g : c->goal)
+        {
+            readGoalDescription(&g);
+        }
+        readVector(&c->time);
+    }
+
+    void SASTaskCache::readMetric(SASMetric* m)
+    {
+        m->type  = read<char>();
+        m->value = read<float>();
+        m->index = read<unsigned int>();
+        m->terms.resize(readSize(1));
+        for(SASMetric& t : m->terms)
+        {
+            readMetric(&t);
+        }
+    }
+
+    void SASTaskCache::readMutexMatrix(MutexMatrix* m, unsigned int size)
+    {
+        if(read<unsigned int>() != size)
+        {
+            failed = true;
+        }
+        std::vector<uint64_t> pairs;
+        readVector(&pairs);
+        if(failed)
+        {
+            return;
+        }
+        m->initialize(size, pairs.size());
+        for(uint64_t code : pairs)
+        {
+            unsigned int i = code >> 32, j = code & 0xFFFFFFFF;
+            if(i >= size || j >= size)
+            {
+                failed = true;
+                return;
+            }
+            m->set(i, j);
+        }
+    }
+
+    // Rebuilds the task in the same order used by the translator, so all the indexes are preserved
+    SASTask* SASTaskCache::readTask()
+    {
+        SASTask* task            = new SASTask();
+        task->initialState       = nullptr;
+        task->numInitialState    = nullptr;
+        task->staticNumFunctions = nullptr;
+        uint32_t n = readSize(1);
+        for(uint32_t i = 0; i < n && !failed; i++)
+        {
+            unsigned int fncIndex = read<unsigned int>();
+            if(task->createNewValue(readString(), fncIndex) != i)
+            {
+                failed = true;
+            }
+        }
+        n = readSize(1);
+        for(uint32_t i = 0; i < n && !failed; i++)
+        {
+            SASVariable* v = task->createNewVariable(readString());
+            readVector(&v->possibleValues);
+            readVector(&v->value);
+            readVector(&v->time);
+        }
+        n = readSize(1);
+        for(uint32_t i = 0; i < n && !failed; i++)
+        {
+            NumericVariable* v = task->createNewNumericVariable(readString());
+            readVector(&v->value);
+            readVector(&v->time);
+        }
+        n = readSize(1);
+        task->actions.reserve(n);
+        for(uint32_t i = 0; i < n && !failed; i++)
+        {
+            readAction(task->createNewAction(readString()));
+        }
+        n = readSize(1);
+        for(uint32_t i = 0; i < n && !failed; i++)
+        {
+            readAction(task->createNewGoal());
+        }
+        n = readSize(1);
+        for(uint32_t i = 0; i < n && !failed; i++)
+        {
+            task->preferenceNames.push_back(readString());
+        }
+        task->constraints.resize(readSize(1));
+        for(SASConstraint& c : task->constraints)
+        {
+            readConstraint(&c);
+        }
+        task->metricType = read<char>();
+        readMetric(&task->metric);
+        task->goalDeadlines.resize(readSize(1));
+        for(GoalDeadline& d : task->goalDeadlines)
+        {
+            d.time = read<float>();
+            readVector(&d.goals);
+        }
+        readVector(&task->fluentMinValue);
+        readVector(&task->fluentValueRange);
+        unsigned int numVars = task->variables.size();
+        if(failed || task->fluentMinValue.size() != numVars || task->fluentValueRange.size() != numVars)
+        {
+            failed = true;
+            return task;
+        }
+        task->fluentOffset.resize(numVars);
+        task->numFluents = 0;
+        for(unsigned int i = 0; i < numVars; i++)
+        {
+            task->fluentOffset[i] = task->numFluents;
+            task->numFluents += task->fluentValueRange[i];
+        }
+        readMutexMatrix(&task->mutex, task->numFluents);
+        readMutexMatrix(&task->permanentMutex, task->numFluents);
+        readMutexMatrix(&task->permanentMutexActions, task->actions.size());
+        task->hasPermanentMutexActions = read<bool>();
+        return task;
+    }
+}  // namespace grstaps
@@ -1,5 +1,9 @@
 #include "grstaps/task_planning/selector.hpp"
 
+#include <algorithm>
+#include <random>
+#include <thread>
+
 namespace grstaps
 {
     /*******************************************/
@@ -19,9 +23,51 @@ namespace grstaps
     // Adds a new plan to the list of open nodes
     void SearchQueue::add(Plan* p)
     {
-        unsigned int gap = pq.size();
-        uint32_t parent;
         pq.push_back(nullptr);
+        siftUp(pq.size() - 1, p);
+    }
+
+    // Adds a batch of plans to the list of open nodes, skipping the ones already in the queue. If the batch is
+    // large compared to the queue, the heap is rebuilt bottom-up once instead of inserting the plans one by one.
+    // Returns the number of plans added
+    unsigned int SearchQueue::add(const std::vector<Plan*>& plans)
+    {
+        unsigned int first = pq.size();
+        for(Plan* p: plans)
+        {
+            if(plan_position.emplace(p->id, pq.size()).second)
+            {
+                pq.push_back(p);
+            }
+        }
+        unsigned int added = pq.size() - first;
+        if(added == 0)
+        {
+            return 0;
+        }
+        unsigned int n       = pq.size() - 1;
+        unsigned int logSize = 32 - __builtin_clz(n);
+        if(added * logSize < n)
+        {
+            for(unsigned int i = first; i <= n; i++)
+            {
+                siftUp(i, pq[i]);
+            }
+        }
+        else
+        {
+            for(unsigned int i = n >> 1; i >= 1; i--)
+            {
+                heapify(i);
+            }
+        }
+        return added;
+    }
+
+    // Moves the plan up from the given position until the heap order is restored
+    void SearchQueue::siftUp(unsigned int gap, Plan* p)
+    {
+        uint32_t parent;
         while(gap > 1 && p->compare(pq[gap >> 1], index) < 0)
         {
             parent                        = gap >> 1;
@@ -37,6 +83,7 @@ namespace grstaps
     Plan* SearchQueue::poll()
     {
         Plan* best = pq[1];
+        plan_position.erase(best->id);
         if(pq.size() > 2)
         {
             pq[1]                    = pq.back();
@@ -83,6 +130,11 @@ namespace grstaps
         uint32_t k = plan_position[p->id], parent;
         Plan* ult  = pq.back();
         pq.pop_back();
+        plan_position.erase(p->id);
+        if(ult == p)
+        {
+            return;
+        }
         if(ult->compare(p, index) < 0)
         {
             while(k > 1 && ult->compare(pq[k >> 1], index) < 0)
@@ -110,6 +162,123 @@ namespace grstaps
         pq.push_back(nullptr);  // Position 0 empty
     }
 
+    /*******************************************/
+    /* ConcurrentSearchQueue                   */
+    /*******************************************/
+
+    ConcurrentSearchQueue::ConcurrentSearchQueue(int index, unsigned int numShards)
+    {
+        this->index = index;
+        numPlans    = 0;
+        for(unsigned int i = 0; i < std::max(numShards, 1u); i++)
+        {
+            shards.emplace_back(new Shard(index));
+        }
+    }
+
+    unsigned int ConcurrentSearchQueue::randomShard()
+    {
+        thread_local std::minstd_rand rng(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        return rng() % shards.size();
+    }
+
+    // Locks the i-th queue, or a random one if it is busy
+    ConcurrentSearchQueue::Shard* ConcurrentSearchQueue::lockShard(unsigned int i)
+    {
+        while(!shards[i]->lock.try_lock())
+        {
+            i = randomShard();
+        }
+        return shards[i].get();
+    }
+
+    void ConcurrentSearchQueue::add(Plan* p)
+    {
+        Shard* s = lockShard(randomShard());
+        s->queue.add(p);
+        updateTop(s);
+        numPlans.fetch_add(1, std::memory_order_release);
+        s->lock.unlock();
+    }
+
+    // The whole batch goes to the same queue, so it is inserted with a single lock and heap update
+    unsigned int ConcurrentSearchQueue::add(const std::vector<Plan*>& plans)
+    {
+        Shard* s           = lockShard(randomShard());
+        unsigned int added = s->queue.add(plans);
+        updateTop(s);
+        numPlans.fetch_add(added, std::memory_order_release);
+        s->lock.unlock();
+        return added;
+    }
+
+    Plan* ConcurrentSearchQueue::poll()
+    {
+        while(size() > 0)
+        {
+            unsigned int i = randomShard(), j = randomShard();
+            Plan* pi       = shards[i]->top.load(std::memory_order_acquire);
+            Plan* pj       = shards[j]->top.load(std::memory_order_acquire);
+            if(pi == nullptr && pj == nullptr)
+            {  // Both empty: look for any non-empty queue
+                for(i = 0; i < shards.size() && shards[i]->top.load(std::memory_order_acquire) == nullptr; i++)
+                    ;
+                if(i == shards.size())
+                {
+                    continue;  // Plans being added, or all taken by other threads
+                }
+            }
+            else if(pi == nullptr || (pj != nullptr && pj->compare(pi, index) < 0))
+            {
+                i = j;
+            }
+            Shard* s = shards[i].get();
+            if(!s->lock.try_lock())
+            {
+                continue;
+            }
+            Plan* best = nullptr;
+            if(s->queue.size() > 0)
+            {
+                best = s->queue.poll();
+                updateTop(s);
+                numPlans.fetch_sub(1, std::memory_order_release);
+            }
+            s->lock.unlock();
+            if(best != nullptr)
+            {
+                return best;
+            }
+        }
+        return nullptr;
+    }
+
+    void ConcurrentSearchQueue::remove(Plan* p)
+    {
+        for(std::unique_ptr<Shard>& s: shards)
+        {
+            std::lock_guard<std::mutex> lock(s->lock);
+            if(s->queue.contains(p))
+            {
+                s->queue.remove(p);
+                updateTop(s.get());
+                numPlans.fetch_sub(1, std::memory_order_release);
+                return;
+            }
+        }
+    }
+
+    void ConcurrentSearchQueue::clear()
+    {
+        for(std::unique_ptr<Shard>& s: shards)
+        {
+            std::lock_guard<std::mutex> lock(s->lock);
+            numPlans.fetch_sub(s->queue.size(), std::memory_order_release);
+            s->queue.clear();
+            updateTop(s.get());
+        }
+    }
+
     /*******************************************/
     /* Selector                               */
     /*******************************************/
@@ -151,14 +320,44 @@ namespace grstaps
         return false;
     }
 
+    // Adds a batch of plans to all the queues. Plans already in the queues are skipped. Returns the number of
+    // plans added
+    unsigned int Selector::add(const std::vector<Plan*>& plans)
+    {
+        SearchQueue* q     = queues[current_queue];
+        unsigned int added = queues[0]->add(plans);
+        for(unsigned int i = 1; i < queues.size(); i++)
+        {
+            queues[i]->add(plans);
+        }
+        for(Plan* p: plans)
+        {
+            float ph = p->getH(q->getIndex());
+            if(ph < q->best_h)
+            {
+                q->improved_h = true;
+                q->best_h     = ph;
+            }
+            if(p->h < overallBest)
+            {
+                iterations_without_improving = 0;
+                overallBest                  = p->h;
+                overall_best_plan            = p;
+            }
+        }
+        return added;
+    }
+
     void Selector::exportTo(Selector* s)
     {
         SearchQueue* q = queues[0];
-        unsigned int n = q->size();
-        for(unsigned int i = 1; i <= n; i++)
+        std::vector<Plan*> plans;
+        plans.reserve(q->size());
+        for(int i = 1; i <= q->size(); i++)
         {
-            s->add(q->getPlanAt(i));
+            plans.push_back(q->getPlanAt(i));
         }
+        s->add(plans);
     }
 
     // Removes and returns the best plan in the queue of open nodes
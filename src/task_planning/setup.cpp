@@ -1,4 +1,5 @@
 #include "grstaps/task_planning/setup.hpp"
+#include <cstdlib>
 #include <iostream>
 #include <time.h>
 
@@ -6,6 +7,7 @@
 #include "grstaps/task_planning/parser.hpp"
 #include "grstaps/task_planning/planner_parameters.hpp"
 #include "grstaps/task_planning/preprocess.hpp"
+#include "grstaps/task_planning/sas_task_cache.hpp"
 #include "grstaps/task_planning/sas_translator.hpp"
 
 #define _TRACE_OFF_
@@ -17,7 +19,31 @@ namespace grstaps
     SASTask* Setup::doPreprocess(PlannerParameters* parameters)
     {
         parameters->total_time = 0;
-        SASTask* sTask         = nullptr;
+        // The snapshot is not used if the grounded domain or the mutex file have to be generated
+        const char* cacheDirectory = parameters->cacheDirectory;
+        if(cacheDirectory == nullptr)
+        {
+            cacheDirectory = std::getenv("GRSTAPS_TASK_CACHE");
+        }
+        if(parameters->generateGroundedDomain || parameters->generateMutexFile)
+        {
+            cacheDirectory = nullptr;
+        }
+        clock_t t = clock();
+        SASTaskCache cache(cacheDirectory,
+                           parameters->domainFileName,
+                           parameters->problemFileName,
+                           parameters->keepStaticData,
+                           parameters->noSAS);
+        SASTask* sTask = cache.load();
+        if(sTask != nullptr)
+        {
+            parameters->total_time += toSeconds(t);
+#ifdef _TIME_ON_
+            cout << ";SAS task loaded from " << cacheDirectory << ": " << parameters->total_time << endl;
+#endif
+            return sTask;
+        }
         ParsedTask* parsedTask = parseStage(parameters);
         if(parsedTask != nullptr)
         {
@@ -28,6 +54,10 @@ namespace grstaps
                 if(gTask != nullptr)
                 {
                     sTask = sasTranslationStage(gTask, parameters);
+                    if(sTask != nullptr)
+                    {
+                        cache.save(sTask);
+                    }
                     delete gTask;
                 }
                 delete prepTask;
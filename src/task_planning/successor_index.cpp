@@ -0,0 +1,157 @@
+#include "grstaps/task_planning/successor_index.hpp"
+
+#include <algorithm>
+
+namespace grstaps
+{
+    /********************************************************/
+    /* CLASS: SparseActionBitset                            */
+    /********************************************************/
+
+    // Actions must be added in increasing order
+    void SparseActionBitset::set(unsigned int action)
+    {
+        uint32_t w = action >> 6;
+        if(index.empty() || index.back() != w)
+        {
+            index.push_back(w);
+            bits.push_back(0);
+        }
+        bits.back() |= 1ULL << (action & 63);
+    }
+
+    /********************************************************/
+    /* CLASS: SuccessorIndex                                */
+    /********************************************************/
+
+    SuccessorIndex::SuccessorIndex()
+    {
+        numActions = numWords = numFluents = 0;
+    }
+
+    void SuccessorIndex::initialize(SASTask* task, bool forceAtEndConditions)
+    {
+        unsigned int numVariables = task->variables.size();
+        numActions                = task->actions.size();
+        numWords                  = (numActions + 63) >> 6;
+
+        // Required values of each variable
+        std::vector<std::vector<TValue>> required(numVariables);
+        auto addConditions = [&required](std::vector<SASCondition>& c) {
+            for(unsigned int i = 0; i < c.size(); i++)
+            {
+                required[c[i].var].push_back(c[i].value);
+            }
+        };
+        for(unsigned int i = 0; i < numActions; i++)
+        {
+            SASAction& a = task->actions[i];
+            addConditions(a.startCond);
+            addConditions(a.overCond);
+            if(forceAtEndConditions)
+            {
+                addConditions(a.endCond);
+            }
+        }
+
+        minValue.resize(numVariables);
+        valueRange.resize(numVariables);
+        fluentOffset.resize(numVariables);
+        fluentId.clear();
+        varFluents.clear();
+        varFluents.resize(numVariables);
+        numFluents = 0;
+        for(unsigned int v = 0; v < numVariables; v++)
+        {
+            std::vector<TValue>& r = required[v];
+            std::sort(r.begin(), r.end());
+            r.erase(std::unique(r.begin(), r.end()), r.end());
+            minValue[v]     = r.empty() ? 0 : r.front();
+            valueRange[v]   = r.empty() ? 0 : r.back() - r.front() + 1;
+            fluentOffset[v] = fluentId.size();
+            fluentId.resize(fluentId.size() + valueRange[v], NO_FLUENT);
+            for(unsigned int i = 0; i < r.size(); i++)
+            {
+                varFluents[v].push_back(numFluents);
+                fluentId[fluentOffset[v] + r[i] - minValue[v]] = numFluents++;
+            }
+        }
+
+        // Actions are visited in increasing order, so the sparse bitsets are built sorted
+        requirers.clear();
+        requirers.resize(numFluents);
+        varRequirers.clear();
+        varRequirers.resize(numVariables);
+        auto setRequirer = [this](std::vector<SASCondition>& c, unsigned int action) {
+            for(unsigned int i = 0; i < c.size(); i++)
+            {
+                requirers[getFluent(c[i].var, c[i].value)].set(action);
+                varRequirers[c[i].var].set(action);
+            }
+        };
+        for(unsigned int i = 0; i < numActions; i++)
+        {
+            SASAction& a = task->actions[i];
+            setRequirer(a.startCond, i);
+            setRequirer(a.overCond, i);
+            if(forceAtEndConditions)
+            {
+                setRequirer(a.endCond, i);
+            }
+        }
+
+        supportedFluents.assign((numFluents + 63) >> 6, 0);
+        supportedRequirers.assign(numWords, 0);
+        blocked.assign(numWords, 0);
+    }
+
+    void SuccessorIndex::clearSupportedFluents()
+    {
+        std::fill(supportedFluents.begin(), supportedFluents.end(), 0);
+    }
+
+    // An action is discarded if, for some variable it requires, no supported value of that variable is
+    // required by the action. The result is a superset of the supported actions (an action with two
+    // conditions on the same variable is kept if one of them is supported), so the candidates must still
+    // be checked one by one
+    unsigned int SuccessorIndex::computeCandidates(std::vector<uint64_t>* candidates)
+    {
+        std::fill(blocked.begin(), blocked.end(), 0);
+        for(unsigned int v = 0; v < varRequirers.size(); v++)
+        {
+            SparseActionBitset& vr = varRequirers[v];
+            if(vr.index.empty())
+            {
+                continue;
+            }
+            for(unsigned int i = 0; i < vr.index.size(); i++)
+            {
+                supportedRequirers[vr.index[i]] = 0;
+            }
+            for(uint32_t fluent : varFluents[v])
+            {
+                if(isSupportedFluent(fluent))
+                {
+                    SparseActionBitset& req = requirers[fluent];
+                    for(unsigned int i = 0; i < req.index.size(); i++)
+                    {
+                        supportedRequirers[req.index[i]] |= req.bits[i];
+                    }
+                }
+            }
+            for(unsigned int i = 0; i < vr.index.size(); i++)
+            {
+                blocked[vr.index[i]] |= vr.bits[i] & ~supportedRequirers[vr.index[i]];
+            }
+        }
+        candidates->resize(numWords);
+        unsigned int numCandidates = 0;
+        for(unsigned int i = 0; i < numWords; i++)
+        {
+            uint64_t valid = i + 1 < numWords || (numActions & 63) == 0 ? ~0ULL : (1ULL << (numActions & 63)) - 1;
+            (*candidates)[i] = valid & ~blocked[i];
+            numCandidates += __builtin_popcountll((*candidates)[i]);
+        }
+        return numCandidates;
+    }
+}  // namespace grstaps
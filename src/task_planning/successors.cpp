@@ -2,6 +2,7 @@
 #include <iostream>
 
 #include "grstaps/logger.hpp"
+#include "grstaps/profiler.hpp"
 #include "grstaps/task_planning/state.hpp"
 
 namespace grstaps
@@ -206,6 +207,10 @@ namespace grstaps
         solution   = nullptr;
         evaluator.initialize(state, task, tilActions, forceAtEndConditions);
         memoization.initialize(task);
+        sharedMemoization = nullptr;
+        sharedIdPlan      = nullptr;
+        sharedPlansMutex  = nullptr;
+        successorIndex.initialize(task, forceAtEndConditions);
         successors = nullptr;
         basePlan   = nullptr;
         // basePlanState = nullptr;
@@ -229,9 +234,20 @@ namespace grstaps
         delete[] varChanges;
     }
 
+    // Shares the repeated-state filter and the plan counter with other successor generators, so several
+    // threads can expand plans of the same search space. plansMutex is the lock under which the other
+    // threads add child plans
+    void Successors::share(ConcurrentMemoization* memo, std::atomic<uint32_t>* planCounter, std::mutex* plansMutex)
+    {
+        sharedMemoization = memo;
+        sharedIdPlan      = planCounter;
+        sharedPlansMutex  = plansMutex;
+    }
+
     // Fills std::vector suc with the possible successor plans of the given base plan
     void Successors::computeSuccessors(Plan* base, std::vector<Plan*>* suc)
     {
+        GRSTAPS_PROFILE_ZONE(TaskPlannerExpand);
         // Calculate the frontier state for the base plan
         // std::cout << "SUC OF " << base->action->name << std::endl;
         linearizer.setCurrentBasePlan(base);
@@ -263,10 +279,13 @@ namespace grstaps
             {
                 fullActionCheck(&(task->goals[i]));
             }
-            for(unsigned int i = 0; i < task->actions.size(); i++)
+            successorIndex.computeCandidates(&candidateActions);
+            for(unsigned int w = 0; w < candidateActions.size(); w++)
             {
-                // std::cout << "Action " << i << std::endl;
-                fullActionCheck(&(task->actions[i]));
+                for(uint64_t bits = candidateActions[w]; bits != 0; bits &= bits - 1)
+                {
+                    fullActionCheck(&(task->actions[(w << 6) + __builtin_ctzll(bits)]));
+                }
             }
         }
         else
@@ -333,7 +352,7 @@ namespace grstaps
         suc->clear();
         computeSuccessorsSupportedByLastActions();
         computeSuccessorsThroughBrotherPlans();
-        TState* s = linearizer.getFrontierState(task, nullptr);
+        TState* s = linearizer.getFrontierState(task);
         for(unsigned int i = 0; i < s->numSASVars; i++)
         {
             std::vector<SASAction*>& req = task->requirers[i][s->state[i]];
@@ -354,6 +373,12 @@ namespace grstaps
     {
         unsigned int var, value;
         TTimePoint time;
+        // Only the full calculation of the root successors reads the supported fluents
+        const bool indexFluents = basePlan->isRoot();
+        if(indexFluents)
+        {
+            successorIndex.clearSupportedFluents();
+        }
         for(unsigned int i = 0; i < linearizer.numComponents(); i++)
         {
             SASAction* a = linearizer.getComponent(i)->action;
@@ -364,6 +389,10 @@ namespace grstaps
                 time  = stepToStartPoint(i);
                 planEffects[var][value].add(time, linearizer.getIteration());
                 varChanges[var].add(value, time, linearizer.getIteration());
+                if(indexFluents)
+                {
+                    successorIndex.setSupportedFluent(var, value);
+                }
             }
             for(unsigned int j = 0; j < a->endEff.size(); j++)
             {
@@ -372,6 +401,10 @@ namespace grstaps
                 time  = stepToEndPoint(i);
                 planEffects[var][value].add(time, linearizer.getIteration());
                 varChanges[var].add(value, time, linearizer.getIteration());
+                if(indexFluents)
+                {
+                    successorIndex.setSupportedFluent(var, value);
+                }
             }
         }
     }
@@ -491,7 +524,7 @@ namespace grstaps
             solveBasePlanOpenConditionIfPossible(0, pb);
             return;
         }
-        Plan* p = pb->generatePlan(basePlan, ++idPlan);
+        Plan* p = pb->generatePlan(basePlan, nextPlanId());
         if(postprocessPlan(p))
         {
             addSuccessor(p);
@@ -545,7 +578,7 @@ namespace grstaps
         }
         else
         {
-            Plan* p = pb->generatePlan(basePlan, ++idPlan);
+            Plan* p = pb->generatePlan(basePlan, nextPlanId());
             if(postprocessPlan(p))
             {
                 addSuccessor(p);
@@ -561,10 +594,10 @@ namespace grstaps
     void Successors::addSuccessor(Plan* p)
     {
         successors->push_back(p);
-        Logger::debug("Plan {} generated", p->id);
+        GRSTAPS_LOG_DEBUG("Plan {} generated", p->id);
         if(p->isSolution())
         {
-            Logger::debug("SOLUTION PLAN");
+            GRSTAPS_LOG_DEBUG("SOLUTION PLAN");
             // std::cout << "SOL.: " << p->gc << "," << p->g << std::endl;
             solution = p;
         }
@@ -834,16 +867,33 @@ namespace grstaps
     // Build successors by adding the las actions of the brother plans
     void Successors::computeSuccessorsThroughBrotherPlans()
     {
-        Plan* parentPlan                 = basePlan->parentPlan;
-        std::vector<Plan*>* brotherPlans = parentPlan->childPlans;
-        for(unsigned int i = 0; i < brotherPlans->size(); i++)
+        // Other threads may be adding children to the brother plans, so the actions are collected under
+        // their lock and the successors are built without it
+        std::vector<SASAction*> brotherActions;
+        {
+            std::unique_lock<std::mutex> lock;
+            if(sharedPlansMutex != nullptr)
+            {
+                lock = std::unique_lock<std::mutex>(*sharedPlansMutex);
+            }
+            Plan* parentPlan                 = basePlan->parentPlan;
+            std::vector<Plan*>* brotherPlans = parentPlan->childPlans;
+            for(unsigned int i = 0; i < brotherPlans->size(); i++)
+            {
+                Plan* brotherPlan = (*brotherPlans)[i];
+                if(brotherPlan != basePlan && !brotherPlan->expanded())
+                {
+                    brotherActions.push_back(brotherPlan->action);
+                }
+            }
+        }
+        for(SASAction* action: brotherActions)
         {
-            Plan* brotherPlan = (*brotherPlans)[i];
-            if(brotherPlan != basePlan && !brotherPlan->expanded() && !visitedAction(brotherPlan->action))
+            if(!visitedAction(action))
             {
                 // reuseAction(brotherPlan);
-                setVisitedAction(brotherPlan->action);
-                PlanBuilder pb(brotherPlan->action, &linearizer, newStep);
+                setVisitedAction(action);
+                PlanBuilder pb(action, &linearizer, newStep);
                 fullActionSupportCheck(&pb);
             }
         }
@@ -984,7 +1034,7 @@ namespace grstaps
                 else
                 {
                     // Unsolvable threat
-                    Logger::debug("Unsolvable threat");
+                    GRSTAPS_LOG_DEBUG("Unsolvable threat");
                 }
             }
             else
@@ -1015,13 +1065,13 @@ namespace grstaps
     {
         linearizer.setCurrentBasePlan(p);
         linearizer.setCurrentPlan(nullptr);
-        return linearizer.getFrontierState(task, nullptr);
+        return linearizer.getFrontierState(task);
     }
 
     void Successors::printState(Plan* p)
     {
         linearizer.setCurrentPlan(p);
-        TState* state = linearizer.getFrontierState(task, evaluator.getLandmarkHeuristic());
+        TState* state = linearizer.getFrontierState(task);
         for(unsigned int i = 0; i < state->numSASVars; i++)
         {
             std::cout << task->variables[i].name << "=" << task->values[state->state[i]].name << std::endl;
@@ -1037,8 +1087,7 @@ namespace grstaps
     bool Successors::postprocessPlan(Plan* p)
     {
         linearizer.setCurrentPlan(p);
-        TState* state = linearizer.getFrontierState(task,
-                                                    evaluator.getLandmarkHeuristic());  //, &(p->timeLastAddedStep));
+        TState* state = linearizer.getFrontierState(task);  //, &(p->timeLastAddedStep));
         if(state != nullptr)
         {
             if(p->isSolution())
@@ -1051,7 +1100,18 @@ namespace grstaps
             }
             p->gc = task->evaluateMetric(state->numState, linearizer.makespan);
             evaluator.evaluate(p, state, linearizer.makespan, helpfulActions);
-            p->repeatedState = filterRepeatedStates ? memoization.isRepeatedState(p, state) : false;
+            if(!filterRepeatedStates)
+            {
+                p->repeatedState = false;
+            }
+            else if(sharedMemoization != nullptr)
+            {
+                p->repeatedState = sharedMemoization->isRepeatedState(p, state);
+            }
+            else
+            {
+                p->repeatedState = memoization.isRepeatedState(p, state);
+            }
             // p->checkUsefulPlan();
             delete state;
             return true;
@@ -1067,7 +1127,7 @@ namespace grstaps
     {
         linearizer.setCurrentBasePlan(p);
         linearizer.setCurrentPlan(nullptr);
-        TState* state = linearizer.getFrontierState(task, evaluator.getLandmarkHeuristic());
+        TState* state = linearizer.getFrontierState(task);
         p->gc         = task->evaluateMetric(state->numState, linearizer.makespan);
         evaluator.evaluate(p, state, linearizer.makespan, helpfulActions);
         delete state;
@@ -4,12 +4,15 @@
 /* Splits the text into a list of syntatic tokens.      */
 /********************************************************/
 
-#include <algorithm>
 #include <cstdarg>
-#include <cstring>
 #include <fstream>
 #include <iostream>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "grstaps/task_planning/syntax_analyzer.hpp"
 
 namespace grstaps
@@ -18,24 +21,28 @@ namespace grstaps
     /* CLASS: Token (syntatic tokens)                       */
     /********************************************************/
 
+    static const std::string noDescription;
+
     // Creates a new token
     Token::Token(Symbol s)
+        : description(noDescription)
     {
         symbol = s;
     }
 
     // Creates a numeric token
     Token::Token(float v)
+        : description(noDescription)
     {
         symbol = Symbol::NUMBER;
         value  = v;
     }
 
-    // Creates a string token
+    // Creates a string token. The description must outlive the token
     Token::Token(Symbol s, std::string const& desc)
+        : description(desc)
     {
-        symbol      = s;
-        description = desc;
+        symbol = s;
     }
 
     // Returns a string representation of this token
@@ -55,6 +62,16 @@ namespace grstaps
         }
     }
 
+    /********************************************************/
+    /* CLASS: SymbolEntry (interned identifier)             */
+    /********************************************************/
+
+    SymbolEntry::SymbolEntry(Symbol s, std::string_view n)
+        : name(n)
+    {
+        symbol = s;
+    }
+
     /********************************************************/
     /* CLASS: SyntaxAnalyzer (Syntatic analyzer)            */
     /********************************************************/
@@ -63,17 +80,7 @@ namespace grstaps
     SyntaxAnalyzer::SyntaxAnalyzer(const char* fileName)
     {
         this->fileName = fileName;
-        std::ifstream in(fileName);
-        if(in.fail())
-        {
-            std::cout << "File not found: " << fileName << std::endl;
-            exit(1);
-        }
-        std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
-        std::transform(contents.begin(), contents.end(), contents.begin(), ::tolower);
-        bufferLength = contents.length() + 1;
-        buffer       = new char[bufferLength];
-        strcpy(buffer, contents.c_str());
+        loadFile();
         tokenIndex = 0;
         lineNumber = 1;
         position   = 0;
@@ -81,20 +88,71 @@ namespace grstaps
         for(unsigned int i = 0; i < numSymbols; i++)
         {
             if(symbolNames[i] != nullptr)
-                symbols[symbolNames[i]] = (Symbol)i;
+            {
+                symbolEntries.emplace_back((Symbol)i, symbolNames[i]);
+                symbols[symbolEntries.back().name] = &symbolEntries.back();
+            }
         }
     }
 
     // Disposes the syntatic analyzer
     SyntaxAnalyzer::~SyntaxAnalyzer()
     {
-        delete[] buffer;
-        for(unsigned int i = 0; i < tokens.size(); i++)
-            delete tokens[i];
+        if(mappedBuffer != nullptr)
+            munmap(mappedBuffer, mappedLength);
         tokens.clear();
         symbols.clear();
     }
 
+    // Maps the file in memory. If it is not possible (empty or special files), the file is read into a string
+    void SyntaxAnalyzer::loadFile()
+    {
+        mappedBuffer = nullptr;
+        mappedLength = 0;
+        int fd       = open(fileName, O_RDONLY);
+        if(fd < 0)
+        {
+            std::cout << "File not found: " << fileName << std::endl;
+            exit(1);
+        }
+        struct stat info;
+        if(fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+        {
+            void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(data != MAP_FAILED)
+            {
+                madvise(data, info.st_size, MADV_SEQUENTIAL);
+                mappedBuffer = data;
+                mappedLength = info.st_size;
+            }
+        }
+        close(fd);
+        if(mappedBuffer != nullptr)
+        {
+            buffer       = static_cast<const char*>(mappedBuffer);
+            bufferLength = mappedLength;
+        }
+        else
+        {
+            std::ifstream in(fileName);
+            fileContents.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            buffer       = fileContents.c_str();
+            bufferLength = fileContents.length();
+        }
+    }
+
+    // Returns the interned entry of an identifier, creating it the first time it is found
+    SymbolEntry* SyntaxAnalyzer::intern(std::string_view name)
+    {
+        auto it = symbols.find(name);
+        if(it != symbols.end())
+            return it->second;
+        symbolEntries.emplace_back(Symbol::NAME, name);
+        SymbolEntry* entry                     = &symbolEntries.back();
+        symbols[std::string_view(entry->name)] = entry;
+        return entry;
+    }
+
     // Returns the next token in the file
     Token* SyntaxAnalyzer::nextToken()
     {
@@ -142,53 +200,53 @@ namespace grstaps
         switch(buffer[position])
         {
             case '(':
-                token = new Token(Symbol::OPEN_PAR);
+                token = &tokenPool.emplace_back(Symbol::OPEN_PAR);
                 break;
             case ')':
-                token = new Token(Symbol::CLOSE_PAR);
+                token = &tokenPool.emplace_back(Symbol::CLOSE_PAR);
                 break;
             case ':':
-                token = new Token(Symbol::COLON);
+                token = &tokenPool.emplace_back(Symbol::COLON);
                 break;
             case '-':
-                token = new Token(Symbol::MINUS);
+                token = &tokenPool.emplace_back(Symbol::MINUS);
                 break;
             case '+':
-                token = new Token(Symbol::PLUS);
+                token = &tokenPool.emplace_back(Symbol::PLUS);
                 break;
             case '/':
-                token = new Token(Symbol::DIV);
+                token = &tokenPool.emplace_back(Symbol::DIV);
                 break;
             case '*':
-                token = new Token(Symbol::PROD);
+                token = &tokenPool.emplace_back(Symbol::PROD);
                 break;
             case '=':
-                token = new Token(Symbol::EQUAL);
+                token = &tokenPool.emplace_back(Symbol::EQUAL);
                 break;
             case '>':
-                if(buffer[position + 1] == '=')
+                if(position + 1 < bufferLength && buffer[position + 1] == '=')
                 {
-                    token = new Token(Symbol::GREATER_EQ);
+                    token = &tokenPool.emplace_back(Symbol::GREATER_EQ);
                     position++;
                 }
                 else
-                    token = new Token(Symbol::GREATER);
+                    token = &tokenPool.emplace_back(Symbol::GREATER);
                 break;
             case '<':
-                if(buffer[position + 1] == '=')
+                if(position + 1 < bufferLength && buffer[position + 1] == '=')
                 {
-                    token = new Token(Symbol::LESS_EQ);
+                    token = &tokenPool.emplace_back(Symbol::LESS_EQ);
                     position++;
                 }
                 else
                 {
-                    token = new Token(Symbol::LESS);
+                    token = &tokenPool.emplace_back(Symbol::LESS);
                 }
                 break;
             case '#':
-                if(buffer[position + 1] == 't')
+                if(position + 1 < bufferLength && charAt(position + 1) == 't')
                 {
-                    token = new Token(Symbol::SHARP_T);
+                    token = &tokenPool.emplace_back(Symbol::SHARP_T);
                     position++;
                 }
                 else
@@ -203,7 +261,8 @@ namespace grstaps
             float value;
             if(matchNumber(&value))
             {
-                token = new Token(-value);
+                tokenPool.pop_back();  // Negative number instead of a minus sign
+                token = &tokenPool.emplace_back(-value);
             }
         }
         else
@@ -211,33 +270,41 @@ namespace grstaps
             float value;
             if(matchNumber(&value))
             {
-                token = new Token(value);
+                token = &tokenPool.emplace_back(value);
             }
             else
             {
-                int start = position++;
-                while(position < bufferLength && ((buffer[position] >= 'a' && buffer[position] <= 'z') ||
-                                                  (buffer[position] >= '0' && buffer[position] <= '9') ||
-                                                  buffer[position] == '-' || buffer[position] == '_'))
+                int start    = position++;
+                bool capital = buffer[start] >= 'A' && buffer[start] <= 'Z';
+                while(position < bufferLength)
                 {
+                    char c = buffer[position];
+                    if(c >= 'A' && c <= 'Z')
+                    {
+                        capital = true;
+                    }
+                    else if(!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '_'))
+                    {
+                        break;
+                    }
                     position++;
                 }
-                std::string description(&buffer[start], position - start);
-                if(description.at(0) == '?')
+                std::string_view name(&buffer[start], position - start);
+                if(capital)
                 {
-                    token = new Token(Symbol::VARIABLE, description);
+                    loweredName.clear();
+                    for(int i = start; i < position; i++)
+                        loweredName.push_back(charAt(i));
+                    name = loweredName;
+                }
+                SymbolEntry* entry = intern(name);
+                if(entry->name.at(0) == '?')
+                {
+                    token = &tokenPool.emplace_back(Symbol::VARIABLE, entry->name);
                 }
                 else
                 {
-                    std::unordered_map<std::string, Symbol>::const_iterator index = symbols.find(description);
-                    if(index == symbols.end())
-                    {
-                        token = new Token(Symbol::NAME, description);
-                    }
-                    else
-                    {
-                        token = new Token(index->second, description);
-                    }
+                    token = &tokenPool.emplace_back(entry->symbol, entry->name);
                 }
             }
         }
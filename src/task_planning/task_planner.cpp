@@ -2,8 +2,8 @@
 
 namespace grstaps
 {
-    TaskPlanner::TaskPlanner(SASTask* task, float timeout, bool trace)
-        : TaskPlannerSetting(task, trace, timeout)
+    TaskPlanner::TaskPlanner(SASTask* task, float timeout, bool trace, unsigned int numThreads)
+        : TaskPlannerSetting(task, trace, timeout, numThreads)
     {}
 
     Plan* TaskPlanner::poll()
@@ -20,9 +20,9 @@ namespace grstaps
         return m_planner->getNextSuccessors(base);
     }
 
-    void TaskPlanner::update(Plan* base, std::vector<Plan*>& successors)
+    unsigned int TaskPlanner::update(Plan* base, std::vector<Plan*>& successors)
     {
-        m_planner->update(base, successors);
+        return m_planner->update(base, successors);
     }
 
     bool TaskPlanner::emptySearchSpace()
@@ -76,7 +76,7 @@ namespace grstaps
         unsigned int numActions = linearizer.basePlanComponents.size();
         unsigned int numTimeSteps = numActions << 1;
         double makespan = 0;
-        TState* state = linearizer.linearize(numActions, numTimeSteps, m_task, nullptr);
+        TState* state = linearizer.linearize(numActions, numTimeSteps, m_task);
         bool lastActionIsGoal = p->action != nullptr && p->action->isGoal;
         unsigned int last = lastActionIsGoal ? numActions - 1 : numActions;
         if (state != nullptr) {
@@ -105,7 +105,7 @@ namespace grstaps
         unsigned int numActions = linearizer.basePlanComponents.size();
         unsigned int numTimeSteps = numActions << 1;
         int numPlanActions = 0;
-        TState* state = linearizer.linearize(numActions, numTimeSteps, m_task, nullptr);
+        TState* state = linearizer.linearize(numActions, numTimeSteps, m_task);
         bool lastActionIsGoal = p->action != nullptr && p->action->isGoal;
         unsigned int last = lastActionIsGoal ? numActions - 1 : numActions;
         if (state != nullptr) {
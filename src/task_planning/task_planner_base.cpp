@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <iostream>
+#include <sstream>
 
 #include "grstaps/task_planning/hff.hpp"
 #include "grstaps/task_planning/task_planner_base.hpp"
@@ -27,6 +28,7 @@ namespace grstaps
         this->filterRepeatedStates = filterRepeatedStates;
         this->parentPlanner        = parentPlanner;
         this->expandedNodes        = 0;
+        this->visitedNodes         = 0;
         this->generateTrace        = generateTrace;
         this->tilActions           = tilActions;
         successors                 = new Successors();
@@ -45,7 +47,15 @@ namespace grstaps
         return toSeconds(startTime) >= timeout;
     }
 
-    void TaskPlannerBase::writeTrace(std::ofstream& f, Plan* p)
+    // Formats the trace of the plan on the calling thread and leaves the file output to the sink
+    void TaskPlannerBase::writeTrace(TraceSink& sink, Plan* p)
+    {
+        std::ostringstream f;
+        writeTrace(f, p);
+        sink.write(f.str());
+    }
+
+    void TaskPlannerBase::writeTrace(std::ostream& f, Plan* p)
     {
         // if (numTracedPlans > 1000) return;	// Only 1000 expanded plans in the trace at most
         f << "BASE PLAN" << std::endl;
@@ -143,6 +153,7 @@ namespace grstaps
                     successors->computeSuccessors(base, &sucPlans);
                 }
                 ++expandedNodes;
+                visitedNodes += sucPlans.size();
                 /*if (++expandedNodes % 100 == 0) {
                     cout << ".";
                 }*/
@@ -83,20 +83,17 @@ namespace grstaps
         return sel->size() == 0;
     }
 
-    void TaskPlannerConcurrent::update(Plan *base, std::vector<Plan *> &successors)
+    unsigned int TaskPlannerConcurrent::update(Plan *base, std::vector<Plan *> &successors)
     {
         base->addChildren(successors);
-        for(Plan *p: successors)
+        float bestH        = sel->getBestH();
+        unsigned int added = sel->add(successors);
+        if(sel->getBestH() < bestH && plateau != nullptr)
         {
-            if(sel->add(p))
-            {
-                if(plateau != nullptr)
-                {
-                    cancelPlateauSearch(true);
-                }
-            }
+            cancelPlateauSearch(true);
         }
         checkPlateau();
+        return added;
     }
 
     std::vector<Plan *> TaskPlannerConcurrent::getNextSuccessors(Plan *base)
@@ -125,6 +122,7 @@ namespace grstaps
         }
         successors->computeSuccessors(base, &sucPlans);
         ++expandedNodes;
+        visitedNodes += sucPlans.size();
         if(successors->solution != nullptr)
         {
             solution = successors->solution;
@@ -121,6 +121,7 @@ namespace grstaps
         }
         successors->computeSuccessors(base, &sucPlans);
         ++expandedNodes;
+        visitedNodes += sucPlans.size();
         if(successors->solution != nullptr)
         {
             solution = successors->solution;
@@ -169,20 +170,18 @@ namespace grstaps
         return base;
     }
 
-    void TaskPlannerDeadends::update(grstaps::Plan* base, std::vector<grstaps::Plan*>& successors)
+    unsigned int TaskPlannerDeadends::update(grstaps::Plan* base, std::vector<grstaps::Plan*>& successors)
     {
         base->addChildren(successors);
-        for(Plan* p: successors)
-        {
-            if(currentSelector->add(p))
-            {
-                if(currentSelectorA && currentSelector->getBestH() < otherSelector->getBestH())
-                {
-                    otherSelector->add(p);
-                }
-            }
+        float bestH        = currentSelector->getBestH();
+        unsigned int added = currentSelector->add(successors);
+        if(currentSelector->getBestH() < bestH && currentSelectorA &&
+           currentSelector->getBestH() < otherSelector->getBestH())
+        {  // Share the new best plan with the other selector
+            otherSelector->add(currentSelector->getBestPlan());
         }
         currentSelectorA = !currentSelectorA;
+        return added;
     }
 
     std::vector<Plan*> TaskPlannerDeadends::getNextSuccessors(Plan* base)
@@ -0,0 +1,215 @@
+#include <thread>
+
+#include "grstaps/task_planning/task_planner_parallel.hpp"
+
+#define MEMO_SHARDS_PER_THREAD 4
+
+namespace grstaps
+{
+    TaskPlannerParallel::TaskPlannerParallel(SASTask* task,
+                                             Plan* initialPlan,
+                                             TState* initialState,
+                                             bool forceAtEndConditions,
+                                             bool filterRepeatedStates,
+                                             bool generateTrace,
+                                             std::vector<SASAction*>* tilActions,
+                                             TaskPlannerBase* parentPlanner,
+                                             float timeout,
+                                             unsigned int numThreads)
+        : TaskPlannerBase(task,
+                          initialPlan,
+                          initialState,
+                          forceAtEndConditions,
+                          filterRepeatedStates,
+                          generateTrace,
+                          tilActions,
+                          parentPlanner,
+                          timeout)
+    {
+        wallStartTime     = std::chrono::steady_clock::now();
+        this->initialPlan = initialPlan;
+        this->numThreads  = numThreads < 1 ? 1 : numThreads;
+        activeWorkers     = 0;
+        finished          = false;
+        planCounter       = 0;
+        memoization.initialize(task, this->numThreads * MEMO_SHARDS_PER_THREAD);
+        successors->share(&memoization, &planCounter, &selectorMutex);
+        workers.push_back(successors);
+        for(unsigned int i = 1; i < this->numThreads; i++)
+        {
+            Successors* s = new Successors();
+            s->initialize(initialState, task, forceAtEndConditions, filterRepeatedStates, tilActions);
+            s->share(&memoization, &planCounter, &selectorMutex);
+            workers.push_back(s);
+        }
+        successors->evaluate(initialPlan);
+        sel = new Selector();
+        if(successors->informativeLandmarks() || 1.5f * initialPlan->hLand >= initialPlan->h)
+        {  // Landmarks available
+            sel->addQueue(SEARCH_HFF);
+            sel->addQueue(SEARCH_HLAND);
+        }
+        else
+        {  // No landmarks available
+            sel->addQueue(SEARCH_G_3HFF);
+        }
+        addInitialPlansToSelector();
+    }
+
+    TaskPlannerParallel::~TaskPlannerParallel()
+    {
+        for(unsigned int i = 1; i < workers.size(); i++)
+        {
+            delete workers[i];
+        }
+        delete sel;
+    }
+
+    void TaskPlannerParallel::addInitialPlansToSelector()
+    {
+        initialH = FLOAT_INFINITY;
+        solution = nullptr;
+        std::vector<Plan*> suc;
+        successors->computeSuccessors(initialPlan, &suc);
+        initialPlan->addChildren(suc);
+        for(Plan* p: suc)
+        {
+            if(p->isSolution())
+            {
+                solution = p;
+            }
+            else
+            {
+                sel->add(p);
+            }
+            if(p->h < initialH)
+            {
+                initialH = p->h;
+            }
+        }
+    }
+
+    // TaskPlannerBase::timeExceed measures processor time, which grows with the number of threads
+    bool TaskPlannerParallel::wallTimeExceed()
+    {
+        std::chrono::duration<float> elapsed = std::chrono::steady_clock::now() - wallStartTime;
+        return elapsed.count() >= timeout;
+    }
+
+    Plan* TaskPlannerParallel::plan()
+    {
+        if(solution != nullptr)
+        {
+            return solution;
+        }
+        finished = false;
+        std::vector<std::thread> threads;
+        for(unsigned int i = 0; i < numThreads; i++)
+        {
+            threads.emplace_back(&TaskPlannerParallel::work, this, i);
+        }
+        for(std::thread& t: threads)
+        {
+            t.join();
+        }
+        return solution;
+    }
+
+    // Worker loop. The selector is only accessed while holding selectorMutex; successors are computed
+    // without it. The successor generators read the children of the brother plans (Plan::expanded) to
+    // avoid repeating actions, and take selectorMutex for that read because addChildren runs under it
+    void TaskPlannerParallel::work(unsigned int worker)
+    {
+        Successors* suc = workers[worker];
+        std::vector<Plan*> plans;
+        std::unique_lock<std::mutex> lock(selectorMutex);
+        while(true)
+        {
+            selectorChanged.wait(lock, [this] { return finished || sel->size() > 0 || activeWorkers == 0; });
+            if(finished || sel->size() == 0)
+            {
+                break;  // Solution found or search space exhausted (nobody can add more plans)
+            }
+            if(wallTimeExceed())
+            {
+                finished = true;
+                break;
+            }
+            Plan* base = sel->poll();
+            if(base->expanded())
+            {
+                sel->add(*base->childPlans);
+                continue;
+            }
+            activeWorkers++;
+            lock.unlock();
+            suc->computeSuccessors(base, &plans);
+            lock.lock();
+            activeWorkers--;
+            ++expandedNodes;
+            visitedNodes += plans.size();
+            if(suc->solution != nullptr)
+            {
+                if(solution == nullptr || suc->solution->gc < solution->gc)
+                {
+                    solution = suc->solution;
+                }
+                finished = true;
+            }
+            else
+            {
+                base->addChildren(plans);
+                sel->add(plans);
+            }
+            selectorChanged.notify_all();
+        }
+        selectorChanged.notify_all();
+    }
+
+    // The methods below are used by the solvers, which drive the search one plan at a time. They run on
+    // the calling thread with the first successor generator
+    Plan* TaskPlannerParallel::searchStep()
+    {
+        Plan* base = sel->poll();
+        std::vector<Plan*> suc = getNextSuccessors(base);
+        if(solution == nullptr && !suc.empty())
+        {
+            update(base, suc);
+        }
+        return base;
+    }
+
+    bool TaskPlannerParallel::emptySearchSpace()
+    {
+        return sel->size() == 0;
+    }
+
+    unsigned int TaskPlannerParallel::update(Plan* base, std::vector<Plan*>& successors)
+    {
+        base->addChildren(successors);
+        return sel->add(successors);
+    }
+
+    std::vector<Plan*> TaskPlannerParallel::getNextSuccessors(Plan* base)
+    {
+        sucPlans.clear();
+        if(base->expanded())
+        {
+            sel->add(*base->childPlans);
+            return sucPlans;
+        }
+        successors->computeSuccessors(base, &sucPlans);
+        ++expandedNodes;
+        visitedNodes += sucPlans.size();
+        if(successors->solution != nullptr)
+        {
+            solution = successors->solution;
+        }
+        return sucPlans;
+    }
+
+    Plan* TaskPlannerParallel::poll()
+    {
+        return sel->poll();
+    }
+}  // namespace grstaps
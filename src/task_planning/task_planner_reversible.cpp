@@ -1,4 +1,5 @@
 #include <iostream>
+#include <memory>
 
 #include "grstaps/task_planning/task_planner_reversible.hpp"
 
@@ -80,25 +81,25 @@ namespace grstaps
 
     Plan* TaskPlannerReversible::plan()
     {
-        std::ofstream traceFile;
+        std::unique_ptr<TraceSink> traceFile;
         if(generateTrace)
         {
-            traceFile.open("trace.txt");
-            writeTrace(traceFile, initialPlan);
+            traceFile = std::make_unique<TraceSink>("trace.txt");
+            writeTrace(*traceFile, initialPlan);
         }
         while(solution == nullptr && !emptySearchSpace() && !timeExceed())
         {
             searchStep();
             if(generateTrace)
             {
-                writeTrace(traceFile, base);
+                writeTrace(*traceFile, base);
                 if(plateau != nullptr)
                     break;
             }
         }
         if(generateTrace)
         {
-            traceFile.close();
+            traceFile->close();
             exit(0);
         }
         return solution;
@@ -124,6 +125,7 @@ namespace grstaps
         }
         successors->computeSuccessors(base, &sucPlans);
         ++expandedNodes;
+        visitedNodes += sucPlans.size();
         if(successors->solution != nullptr)
         {
             solution = successors->solution;
@@ -200,20 +202,17 @@ namespace grstaps
         return base;
     }
 
-    void TaskPlannerReversible::update(Plan* base, std::vector<Plan*>& successors)
+    unsigned int TaskPlannerReversible::update(Plan* base, std::vector<Plan*>& successors)
     {
         base->addChildren(successors);
-        for(Plan* p: successors)
+        float bestH        = selector->getBestH();
+        unsigned int added = selector->add(successors);
+        if(selector->getBestH() < bestH && plateau != nullptr)
         {
-            if(selector->add(p))
-            {
-                if(plateau != nullptr)
-                {
-                    cancelPlateauSearch(true);
-                }
-            }
+            cancelPlateauSearch(true);
         }
         checkPlateau();
+        return added;
     }
 
     std::vector<Plan*> TaskPlannerReversible::getNextSuccessors(Plan* base)
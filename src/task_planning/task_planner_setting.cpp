@@ -5,6 +5,7 @@
 #include "grstaps/task_planning/linearizer.hpp"
 #include "grstaps/task_planning/task_planner_concurrent.hpp"
 #include "grstaps/task_planning/task_planner_deadends.hpp"
+#include "grstaps/task_planning/task_planner_parallel.hpp"
 #include "grstaps/task_planning/task_planner_reversible.hpp"
 #include "grstaps/task_planning/task_planner_setting.hpp"
 
@@ -12,10 +13,11 @@
 
 namespace grstaps
 {
-    TaskPlannerSetting::TaskPlannerSetting(SASTask* sTask, bool generateTrace, float timeout)
+    TaskPlannerSetting::TaskPlannerSetting(SASTask* sTask, bool generateTrace, float timeout, unsigned int numThreads)
     {
         m_initial_time   = clock();
         m_timeout        = timeout;
+        m_num_threads    = numThreads;
         m_task           = sTask;
         m_generate_trace = generateTrace;
         createInitialPlan();
@@ -32,7 +34,31 @@ namespace grstaps
         Logger::debug("   Memo: {}", m_filter_repeated_states ? 'Y' : 'N');
         Logger::debug("   Mutex: {}", m_task->hasPermanentMutexAction() ? 'Y' : 'N');
         float remainingTime = m_timeout - toSeconds(m_initial_time);
-        if(!m_filter_repeated_states || !m_force_at_end_conditions)
+        if(m_num_threads > 1)
+        {
+            if(!m_filter_repeated_states || !m_force_at_end_conditions)
+            {
+                m_task->domainType = DOMAIN_CONCURRENT;
+            }
+            else
+            {
+                m_task->domainType =
+                    m_task->hasPermanentMutexAction() ? DOMAIN_DEAD_ENDS : DOMAIN_REVERSIBLE;
+            }
+            Logger::debug("Parallel search ({} threads)", m_num_threads);
+            // The parallel search runs through plan(), so a negative timeout means no limit
+            m_planner = new TaskPlannerParallel(m_task,
+                                                m_initial_plan,
+                                                m_initial_state,
+                                                m_force_at_end_conditions,
+                                                m_filter_repeated_states,
+                                                m_generate_trace,
+                                                &m_til_actions,
+                                                nullptr,
+                                                m_timeout < 0 ? FLOAT_INFINITY : remainingTime,
+                                                m_num_threads);
+        }
+        else if(!m_filter_repeated_states || !m_force_at_end_conditions)
         {
             m_task->domainType = DOMAIN_CONCURRENT;
             Logger::debug("Concurrent domain");
@@ -91,6 +117,11 @@ namespace grstaps
         return m_planner->getExpandedNodes();
     }
 
+    unsigned int TaskPlannerSetting::getVisitedNodes()
+    {
+        return m_planner->getVisitedNodes();
+    }
+
     std::string TaskPlannerSetting::planToPDDL(Plan* p)
     {
         return m_planner->planToPDDL(p);
@@ -8,12 +8,66 @@
 
 namespace grstaps
 {
+    FluentLevel FluentLevelQueue::poll()
+    {
+        if(buckets[0].empty())
+        {
+            unsigned int i = 1;
+            while(buckets[i].empty())
+            {
+                i++;
+            }
+            std::vector<FluentLevel>& bucket = buckets[i];
+            uint32_t minKey                  = key(bucket[0].level);
+            for(unsigned int j = 1; j < bucket.size(); j++)
+            {
+                minKey = std::min(minKey, key(bucket[j].level));
+            }
+            last = minKey;
+            for(unsigned int j = 0; j < bucket.size(); j++)
+            {
+                buckets[bucketIndex(key(bucket[j].level))].push_back(bucket[j]);
+            }
+            bucket.clear();
+        }
+        FluentLevel fl = buckets[0].back();
+        buckets[0].pop_back();
+        count--;
+        return fl;
+    }
+
+    void FluentLevelQueue::clear()
+    {
+        for(unsigned int i = 0; i < NUM_BUCKETS; i++)
+        {
+            buckets[i].clear();
+        }
+        last  = 0;
+        count = 0;
+    }
+
+    TemporalRPG::TemporalRPG()
+    {
+        task         = nullptr;
+        numActions   = 0;
+        epoch        = 0;
+        untilGoals   = false;
+        verifyFluent = false;
+        tilActions   = nullptr;
+    }
+
     void TemporalRPG::initialize(bool untilGoals, SASTask* task, std::vector<SASAction*>* tilActions)
     {
         verifyFluent     = false;
         this->untilGoals = untilGoals;
         this->task       = task;
         this->tilActions = tilActions;
+        unsigned int numFluents = task->getNumFluents();
+        generationTime.assign(numFluents, -1);
+        generationEpoch.assign(numFluents, 0);
+        fluentIndex.assign(numFluents, -1);
+        epoch = 0;
+        goals.clear();
         if(untilGoals)
         {
             for(unsigned int i = 0; i < task->goals.size(); i++)
@@ -32,41 +86,34 @@ namespace grstaps
                     addGoalToAchieve(goal.endCond[j]);
                 }
             }
+            std::sort(goals.begin(), goals.end());
+            goals.erase(std::unique(goals.begin(), goals.end()), goals.end());
         }
-        numActions    = task->actions.size();
-        visitedAction = new char[numActions];
-        for(int i = 0; i < numActions; i++)
-        {
-            visitedAction[i] = 0;
-        }
-        actionLevels = nullptr;
-    }
-
-    TemporalRPG::~TemporalRPG()
-    {
-        delete[] visitedAction;
-        if(actionLevels != nullptr)
-        {
-            delete[] actionLevels;
-        }
+        numActions = task->actions.size();
+        visitedAction.assign(numActions, 0);
     }
 
     void TemporalRPG::addGoalToAchieve(SASCondition& c)
     {
-        TVarValue v = SASTask::getVariableValueCode(c.var, c.value);
-        if(std::find(goalsToAchieve.begin(), goalsToAchieve.end(), v) == goalsToAchieve.end())
+        uint32_t id = task->getFluentId(c.var, c.value);
+        if(id != SASTask::NO_FLUENT)
         {
-            goalsToAchieve.push_back(v);
+            goals.push_back(id);
         }
     }
 
-    void TemporalRPG::clearPriorityQueue()
+    // Starts a new epoch, invalidating the generation times and visited actions of the previous build
+    void TemporalRPG::nextEpoch()
     {
-        while(qPNormal.size() > 0)
-        {
-            FluentLevel* fl = (FluentLevel*)qPNormal.poll();
-            delete fl;
+        if(++epoch == 0)
+        {  // Wrap around: clear the arrays so that no stale entry matches the new epoch
+            std::fill(generationEpoch.begin(), generationEpoch.end(), 0);
+            std::fill(visitedAction.begin(), visitedAction.end(), 0);
+            epoch = 1;
         }
+        reachedFluents.clear();
+        qPNormal.clear();
+        goalsToAchieve = goals;
     }
 
     void TemporalRPG::build(TState* state)
@@ -74,24 +121,24 @@ namespace grstaps
         init(state);
         if(untilGoals && checkAcheivedGoals())
         {
-            clearPriorityQueue();
+            qPNormal.clear();
         }
         float auxLevel;
         while(qPNormal.size() > 0)
         {
-            FluentLevel* fl              = (FluentLevel*)qPNormal.poll();
-            std::vector<SASAction*>& req = task->requirers[fl->variable][fl->value];
+            FluentLevel fl               = qPNormal.poll();
+            std::vector<SASAction*>& req = task->requirers[fl.variable][fl.value];
 #ifdef DEBUG_TEMPORALRPG_ON
-            cout << "EXTR.: " << fl->toString(task) << ", " << req.size() << " requirers" << endl;
+            cout << "EXTR.: " << fl.toString(task) << ", " << req.size() << " requirers" << endl;
 #endif
             for(unsigned int i = 0; i < req.size(); i++)
             {
                 SASAction* a = req[i];
-                if(visitedAction[a->index] == 0)
+                if(!isVisited(a))
                 {
                     if(verifyFluent && actionProducesFluent(a))
                     {
-                        visitedAction[a->index] = 1;
+                        setVisited(a);
                     }
                     else
                     {
@@ -99,7 +146,7 @@ namespace grstaps
                         for(unsigned int j = 0; j < a->startCond.size(); j++)
                         {
                             auxLevel = getFirstGenerationTime(a->startCond[j].var, a->startCond[j].value);
-                            if(auxLevel < 0 || auxLevel > fl->level)
+                            if(auxLevel < 0 || auxLevel > fl.level)
                             {
                                 applicable = false;
                                 break;  // Non applicable
@@ -110,7 +157,7 @@ namespace grstaps
                             for(unsigned int j = 0; j < a->overCond.size(); j++)
                             {
                                 auxLevel = getFirstGenerationTime(a->overCond[j].var, a->overCond[j].value);
-                                if(auxLevel < 0 || auxLevel > fl->level)
+                                if(auxLevel < 0 || auxLevel > fl.level)
                                 {
                                     applicable = false;
                                     break;  // Non applicable
@@ -119,19 +166,19 @@ namespace grstaps
                             if(applicable)
                             {
 #ifdef DEBUG_TEMPORALRPG_ON
-                                cout << "N.ACTION " << fl->level << ": " << a->name << endl;
+                                cout << "N.ACTION " << fl.level << ": " << a->name << endl;
 #endif
-                                visitedAction[a->index] = 1;
-                                float effLevel          = fl->level + EPSILON;
+                                setVisited(a);
+                                float effLevel = fl.level + EPSILON;
                                 for(unsigned j = 0; j < a->startEff.size(); j++)
                                 {
                                     TVariable v  = a->startEff[j].var;
                                     TValue value = a->startEff[j].value;
                                     auxLevel     = getFirstGenerationTime(v, value);
-                                    if(auxLevel == -1 || auxLevel > effLevel)
+                                    if((auxLevel == -1 || auxLevel > effLevel) &&
+                                       setFirstGenerationTime(v, value, effLevel))
                                     {
-                                        firstGenerationTime[SASTask::getVariableValueCode(v, value)] = effLevel;
-                                        qPNormal.add(new FluentLevel(v, value, effLevel));
+                                        qPNormal.push(v, value, effLevel);
 #ifdef DEBUG_TEMPORALRPG_ON
                                         cout << "* PROG: (" << task->variables[v].name << ","
                                              << task->values[value].name << ") -> " << effLevel << endl;
@@ -144,10 +191,10 @@ namespace grstaps
                                     TVariable v  = a->endEff[j].var;
                                     TValue value = a->endEff[j].value;
                                     auxLevel     = getFirstGenerationTime(v, value);
-                                    if(auxLevel == -1 || auxLevel > effLevel)
+                                    if((auxLevel == -1 || auxLevel > effLevel) &&
+                                       setFirstGenerationTime(v, value, effLevel))
                                     {
-                                        firstGenerationTime[SASTask::getVariableValueCode(v, value)] = effLevel;
-                                        qPNormal.add(new FluentLevel(v, value, effLevel));
+                                        qPNormal.push(v, value, effLevel);
 #ifdef DEBUG_TEMPORALRPG_ON
                                         cout << "* PROG: (" << task->variables[v].name << ","
                                              << task->values[value].name << ") -> " << effLevel << endl;
@@ -159,28 +206,28 @@ namespace grstaps
                     }
                 }
             }
-            delete fl;
             if(untilGoals && checkAcheivedGoals())
             {
-                clearPriorityQueue();
+                qPNormal.clear();
             }
         }
     }
 
     void TemporalRPG::init(TState* state)
     {
+        nextEpoch();
         for(unsigned int i = 0; i < state->numSASVars; i++)
         {
-            firstGenerationTime[SASTask::getVariableValueCode(i, state->state[i])] = 0;
+            setFirstGenerationTime(i, state->state[i], 0);
         }
         if(verifyFluent)
         {
-            firstGenerationTime[SASTask::getVariableValueCode(fluentToVerify.variable, fluentToVerify.value)] = -1;
+            setFirstGenerationTime(fluentToVerify.variable, fluentToVerify.value, -1);
         }
         for(int i = 0; i < numActions; i++)
         {
             SASAction* a = &(task->actions[i]);
-            if(visitedAction[a->index] == 0)
+            if(!isVisited(a))
             {
                 programAction(a, state);
             }
@@ -226,17 +273,16 @@ namespace grstaps
 #endif
             if(a->index != MAX_UNSIGNED_INT)
             {
-                visitedAction[a->index] = 1;
+                setVisited(a);
             }
             for(unsigned int j = 0; j < a->startEff.size(); j++)
             {
                 v     = a->startEff[j].var;
                 value = a->startEff[j].value;
                 level = getFirstGenerationTime(v, value);
-                if(level == -1)
+                if(level == -1 && setFirstGenerationTime(v, value, EPSILON))
                 {
-                    firstGenerationTime[SASTask::getVariableValueCode(v, value)] = EPSILON;
-                    qPNormal.add(new FluentLevel(v, value, EPSILON));
+                    qPNormal.push(v, value, EPSILON);
 #ifdef DEBUG_TEMPORALRPG_ON
                     cout << "* PROG: (" << task->variables[v].name << "," << task->values[value].name << ") -> "
                          << EPSILON << endl;
@@ -255,8 +301,10 @@ namespace grstaps
                     {
                         duration = EPSILON + task->getActionDuration(a, state->numState);
                     }
-                    firstGenerationTime[SASTask::getVariableValueCode(v, value)] = duration;
-                    qPNormal.add(new FluentLevel(v, value, duration));
+                    if(setFirstGenerationTime(v, value, duration))
+                    {
+                        qPNormal.push(v, value, duration);
+                    }
 #ifdef DEBUG_TEMPORALRPG_ON
                     cout << "* PROG: (" << task->variables[v].name << "," << task->values[value].name << ") -> "
                          << duration << endl;
@@ -268,7 +316,8 @@ namespace grstaps
 
     bool TemporalRPG::checkAcheivedGoals()
     {
-        while(goalsToAchieve.size() > 0 && getFirstGenerationTime(goalsToAchieve[0]) >= 0)
+        while(goalsToAchieve.size() > 0 && generationEpoch[goalsToAchieve[0]] == epoch &&
+              generationTime[goalsToAchieve[0]] >= 0)
         {
             goalsToAchieve[0] = goalsToAchieve[goalsToAchieve.size() - 1];
             goalsToAchieve.pop_back();
@@ -297,44 +346,54 @@ namespace grstaps
 
     void TemporalRPG::computeLiteralLevels()
     {
-        clearPriorityQueue();
-        fluentList.reserve(firstGenerationTime.size());
+        qPNormal.clear();
+        for(LMFluent& f : fluentList)
+        {
+            fluentIndex[task->getFluentId(f.variable, f.value)] = -1;
+        }
+        fluentList.clear();
+        fluentLevels.clear();
+        fluentLevelIndex.clear();
+        fluentList.reserve(reachedFluents.size());
         int index = 0;
-        for(auto it = firstGenerationTime.begin(); it != firstGenerationTime.end(); ++it, ++index)
+        for(TVarValue vv : reachedFluents)
         {
-            LMFluent f;
-            f.initialize(it->first, it->second, index);
-            fluentList.push_back(f);
+            float level = getFirstGenerationTime(vv);
+            if(level >= 0)
+            {
+                LMFluent f;
+                f.initialize(vv, level, index++);
+                fluentList.push_back(f);
+            }
         }
         for(unsigned int i = 0; i < fluentList.size(); i++)
         {
-            TVariable v                                          = fluentList[i].variable;
-            TValue value                                         = fluentList[i].value;
-            fluentIndex[SASTask::getVariableValueCode(v, value)] = fluentList[i].index;
-            qPNormal.add(new FluentLevel(v, value, fluentList[i].level));
+            TVariable v                            = fluentList[i].variable;
+            TValue value                           = fluentList[i].value;
+            fluentIndex[task->getFluentId(v, value)] = fluentList[i].index;
+            qPNormal.push(v, value, fluentList[i].level);
         }
         float currentLevel = -1;
         int i              = -1;
         while(qPNormal.size() > 0)
         {
-            FluentLevel* fl = (FluentLevel*)qPNormal.poll();
-            if(fl->level > currentLevel)
+            FluentLevel fl = qPNormal.poll();
+            if(fl.level > currentLevel)
             {
 #ifdef DEBUG_TEMPORALRPG_ON
-                cout << "Level: " << fl->level << endl;
+                cout << "Level: " << fl.level << endl;
 #endif
                 fluentLevels.emplace_back();
-                currentLevel                   = fl->level;
+                currentLevel                   = fl.level;
                 fluentLevelIndex[currentLevel] = ++i;
             }
-            fluentLevels[i].push_back(SASTask::getVariableValueCode(fl->variable, fl->value));
-            delete fl;
+            fluentLevels[i].push_back(SASTask::getVariableValueCode(fl.variable, fl.value));
         }
     }
 
     void TemporalRPG::computeActionLevels(TState* state)
     {
-        actionLevels = new float[numActions];
+        actionLevels.resize(numActions);
         for(int i = 0; i < numActions; i++)
         {
             actionLevels[i] = getActionLevel(&(task->actions[i]), state);
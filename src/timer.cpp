@@ -17,7 +17,7 @@ namespace grstaps
     {
         if(!m_running)
         {
-            m_start_time = std::chrono::system_clock::now();
+            m_start_time = std::chrono::steady_clock::now();
             m_running = true;
         }
         else
@@ -30,7 +30,7 @@ namespace grstaps
     {
         if(m_running)
         {
-            auto end_time = std::chrono::system_clock::now();
+            auto end_time = std::chrono::steady_clock::now();
             m_time += std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - m_start_time).count() * 1.0E-9F;
             m_running = false;
         }
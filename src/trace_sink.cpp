@@ -0,0 +1,102 @@
+#include "grstaps/trace_sink.hpp"
+
+// global
+#include <chrono>
+
+namespace grstaps
+{
+    TraceSink::TraceSink(const std::string& filepath, unsigned int capacity)
+        : m_file(filepath)
+        , m_head(0)
+        , m_tail(0)
+        , m_closing(false)
+    {
+        unsigned int size = 2;
+        while(size < capacity)
+        {
+            size <<= 1;
+        }
+        m_ring.reset(new std::string[size]);
+        m_mask   = size - 1;
+        m_writer = std::thread(&TraceSink::run, this);
+    }
+
+    TraceSink::~TraceSink()
+    {
+        close();
+    }
+
+    void TraceSink::write(std::string&& record)
+    {
+        flushBacklog();
+        if(!m_backlog.empty() || !push(record))
+        {
+            m_backlog.push_back(std::move(record));
+        }
+    }
+
+    void TraceSink::close()
+    {
+        if(!m_writer.joinable())
+        {
+            return;
+        }
+        while(!m_backlog.empty())
+        {
+            flushBacklog();
+            std::this_thread::yield();
+        }
+        m_closing.store(true, std::memory_order_release);
+        m_writer.join();
+        m_file.close();
+    }
+
+    bool TraceSink::push(std::string& record)
+    {
+        unsigned int tail = m_tail.load(std::memory_order_relaxed);
+        if(tail - m_head.load(std::memory_order_acquire) > m_mask)
+        {
+            return false;  // Full
+        }
+        m_ring[tail & m_mask] = std::move(record);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    void TraceSink::flushBacklog()
+    {
+        while(!m_backlog.empty() && push(m_backlog.front()))
+        {
+            m_backlog.pop_front();
+        }
+    }
+
+    // Writer thread: empties the ring until the sink is closed
+    void TraceSink::run()
+    {
+        while(true)
+        {
+            unsigned int head = m_head.load(std::memory_order_relaxed);
+            unsigned int tail = m_tail.load(std::memory_order_acquire);
+            if(head == tail)
+            {
+                if(m_closing.load(std::memory_order_acquire) && tail == m_tail.load(std::memory_order_acquire))
+                {
+                    break;
+                }
+                m_file.flush();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            for(; head != tail; ++head)
+            {
+                std::string& record = m_ring[head & m_mask];
+                m_file << record;
+                record.clear();
+                record.shrink_to_fit();
+            }
+            m_head.store(head, std::memory_order_release);
+        }
+        m_file.flush();
+    }
+}  // namespace grstaps
@@ -18,13 +18,18 @@
 
 // external
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <chrono>
+#include <limits>
+#include <random>
+#include <thread>
 #include <boost/shared_ptr.hpp>
 #include <gtest/gtest.h>
 
 // local
+#include <grstaps/Connections/taskAllocationToScheduling.h>
 #include <grstaps/Scheduling/Scheduler.h>
 
 
@@ -122,5 +127,344 @@ namespace grstaps {
             }
 
         }
+
+        struct RandomProblem
+        {
+            std::vector<float> durations;
+            std::vector<std::vector<int>> orderingConstraints;
+            std::vector<std::vector<int>> disConstraints;
+        };
+
+        // Problem with random durations where each pair of actions is ordered with odds 1/orderingOdds, or else
+        // is disjunctive with odds 1/disjunctiveOdds. Odds of 0 leave out that kind of constraint
+        static RandomProblem randomProblem(unsigned int seed,
+                                           int numActions,
+                                           unsigned int orderingOdds,
+                                           unsigned int disjunctiveOdds,
+                                           unsigned int maxDisjuncts = std::numeric_limits<unsigned int>::max())
+        {
+            std::mt19937 gen(seed);
+            std::uniform_real_distribution<float> duration(1, 20);
+            RandomProblem problem;
+            problem.durations.resize(numActions);
+            for(float& d: problem.durations)
+            {
+                d = duration(gen);
+            }
+            for(int i = 0; i < numActions; ++i)
+            {
+                for(int j = i + 1; j < numActions; ++j)
+                {
+                    if(orderingOdds > 0 && gen() % orderingOdds == 0)
+                    {
+                        problem.orderingConstraints.push_back({i, j});
+                    }
+                    else if(disjunctiveOdds > 0 && gen() % disjunctiveOdds == 0 &&
+                            problem.disConstraints.size() < maxDisjuncts)
+                    {
+                        problem.disConstraints.push_back({i, j});
+                    }
+                }
+            }
+            return problem;
+        }
+
+        // Random disjunctive problems, each scheduled from the given seed
+        static std::vector<double> scheduleMakespans(unsigned int seed, unsigned int numThreads)
+        {
+            const int numProblems = 32;
+            std::vector<double> makespans(numProblems, -1);
+            std::vector<std::thread> threads;
+            for(unsigned int t = 0; t < numThreads; ++t)
+            {
+                threads.emplace_back([&, t]() {
+                    for(int p = t; p < numProblems; p += numThreads)
+                    {
+                        auto [durations, orderingConstraints, disConstraints] = randomProblem(p, 12, 6, 3);
+                        Scheduler sched;
+                        sched.setSeed(seed);
+                        sched.schedule(durations, orderingConstraints, disConstraints);
+                        makespans[p] = sched.getMakeSpan();
+                    }
+                });
+            }
+            for(std::thread& thread: threads)
+            {
+                thread.join();
+            }
+            return makespans;
+        }
+
+        TEST(TaskSchedule, seed_deterministic)
+        {
+            for(unsigned int seed: {0u, 7u, 12345u})
+            {
+                const std::vector<double> expected = scheduleMakespans(seed, 1);
+                EXPECT_EQ(scheduleMakespans(seed, 1), expected);
+                EXPECT_EQ(scheduleMakespans(seed, 4), expected);
+                EXPECT_EQ(scheduleMakespans(seed, 8), expected);
+            }
+        }
+
+        TEST(TaskSchedule, exact_matches_enumeration)
+        {
+            for(int p = 0; p < 20; ++p)
+            {
+                auto [durations, orderingConstraints, disConstraints] = randomProblem(p, 8, 5, 3, 10);
+
+                // Shortest makespan over every acyclic orientation of the disjunctive constraints
+                float best = std::numeric_limits<float>::max();
+                for(unsigned int orientation = 0; orientation < (1u << disConstraints.size()); ++orientation)
+                {
+                    Scheduler enumerated;
+                    enumerated.schedule(durations, orderingConstraints);
+                    bool valid = true;
+                    for(int i = 0; i < disConstraints.size() && valid; ++i)
+                    {
+                        const bool ordering = orientation & (1u << i);
+                        valid = ordering ? enumerated.addOC(disConstraints[i][1], disConstraints[i][0])
+                                         : enumerated.addOC(disConstraints[i][0], disConstraints[i][1]);
+                    }
+                    if(valid)
+                    {
+                        best = std::min(best, enumerated.getMakeSpan());
+                    }
+                }
+
+                Scheduler sched;
+                sched.setExactSearch(10, 20);
+                ASSERT_TRUE(sched.schedule(durations, orderingConstraints, disConstraints));
+                EXPECT_TRUE(sched.isOptimal());
+                EXPECT_FLOAT_EQ(sched.getMakeSpan(), best);
+
+                // Without the exact search, or when it runs out of time, the tabu search decides the orderings
+                Scheduler heuristic;
+                heuristic.schedule(durations, orderingConstraints, disConstraints);
+                EXPECT_FALSE(heuristic.isOptimal());
+                EXPECT_GE(heuristic.getMakeSpan(), best - 1e-3);
+
+                Scheduler limited;
+                limited.setExactSearch(1e-9, 20);
+                ASSERT_TRUE(limited.schedule(durations, orderingConstraints, disConstraints));
+                EXPECT_FALSE(limited.isOptimal());
+                EXPECT_GE(limited.getMakeSpan(), best - 1e-3);
+            }
+        }
+
+        TEST(TaskSchedule, plan_lower_bound)
+        {
+            taskAllocationToScheduling taToSched;
+            const std::vector<std::vector<float>> species{{1.0}, {2.0}};
+            const std::vector<int> numSpec{1, 1};
+
+            // Without requirements the bound is the longest chain of the ordering constraints
+            for(int p = 0; p < 20; ++p)
+            {
+                auto [durations, orderingConstraints, disConstraints] = randomProblem(p, 8, 4, 0);
+                const std::vector<std::vector<float>> none(8, std::vector<float>{0.0});
+
+                Scheduler sched;
+                ASSERT_TRUE(sched.schedule(durations, orderingConstraints));
+                EXPECT_FLOAT_EQ(
+                    taToSched.planLowerBound(durations, orderingConstraints, none, none, species, numSpec, -1, 0),
+                    sched.getMakeSpan());
+            }
+
+            // Two parallel actions that each need the whole fleet cannot overlap
+            const std::vector<float> durations{4, 6};
+            const std::vector<std::vector<float>> goal{{3.0}, {3.0}};
+            const std::vector<std::vector<float>> cumulative{{0.0}, {0.0}};
+            EXPECT_FLOAT_EQ(taToSched.planLowerBound(durations, {}, goal, cumulative, species, numSpec, -1, 0), 10);
+
+            // A cycle in the ordering constraints cannot be scheduled
+            EXPECT_EQ(taToSched.planLowerBound(durations, {{0, 1}, {1, 0}}, goal, cumulative, species, numSpec, -1, 0),
+                      -1);
+        }
+
+        // Start and end times of the actions computed from scratch, empty if the constraints contain a cycle
+        static std::vector<std::vector<float>> referenceSchedule(const std::vector<float>& durations,
+                                                                 const std::vector<std::vector<int>>& before)
+        {
+            std::vector<int> inDegree(durations.size(), 0);
+            for(const std::vector<int>& successors: before)
+            {
+                for(int next: successors)
+                {
+                    ++inDegree[next];
+                }
+            }
+            std::vector<int> ready;
+            for(int i = 0; i < durations.size(); ++i)
+            {
+                if(inDegree[i] == 0)
+                {
+                    ready.push_back(i);
+                }
+            }
+            std::vector<std::vector<float>> stn(durations.size(), std::vector<float>{0, 0});
+            int scheduled = 0;
+            while(!ready.empty())
+            {
+                const int action = ready.back();
+                ready.pop_back();
+                ++scheduled;
+                stn[action][1] = stn[action][0] + durations[action];
+                for(int next: before[action])
+                {
+                    stn[next][0] = std::max(stn[next][0], stn[action][1]);
+                    if(--inDegree[next] == 0)
+                    {
+                        ready.push_back(next);
+                    }
+                }
+            }
+            if(scheduled != durations.size())
+            {
+                return {};
+            }
+            return stn;
+        }
+
+        // Whether a path of ordering constraints leads from one action to another
+        static bool referenceReachable(const std::vector<std::vector<int>>& before, int from, int to)
+        {
+            std::vector<bool> visited(before.size(), false);
+            std::vector<int> open{from};
+            while(!open.empty())
+            {
+                const int action = open.back();
+                open.pop_back();
+                for(int next: before[action])
+                {
+                    if(next == to)
+                    {
+                        return true;
+                    }
+                    if(!visited[next])
+                    {
+                        visited[next] = true;
+                        open.push_back(next);
+                    }
+                }
+            }
+            return false;
+        }
+
+        static void expectSameConstraints(std::vector<std::vector<int>> actual, std::vector<std::vector<int>> expected)
+        {
+            ASSERT_EQ(actual.size(), expected.size());
+            for(int i = 0; i < actual.size(); ++i)
+            {
+                std::sort(actual[i].begin(), actual[i].end());
+                std::sort(expected[i].begin(), expected[i].end());
+                EXPECT_EQ(actual[i], expected[i]) << "action " << i;
+            }
+        }
+
+        static void expectSameSchedule(const std::vector<std::vector<float>>& actual,
+                                       const std::vector<std::vector<float>>& expected)
+        {
+            ASSERT_EQ(actual.size(), expected.size());
+            for(int i = 0; i < actual.size(); ++i)
+            {
+                EXPECT_NEAR(actual[i][0], expected[i][0], 1e-3) << "action " << i;
+                EXPECT_NEAR(actual[i][1], expected[i][1], 1e-3) << "action " << i;
+            }
+        }
+
+        TEST(TaskSchedule, incremental_matches_reference)
+        {
+            const int numActions = 12;
+            for(int p = 0; p < 20; ++p)
+            {
+                const std::vector<float> durations = randomProblem(p, numActions, 0, 0).durations;
+                std::mt19937 gen(p);
+                std::vector<std::vector<int>> noConstraints;
+                Scheduler sched;
+                ASSERT_TRUE(sched.schedule(durations, noConstraints));
+
+                std::vector<std::vector<int>> before(numActions);
+                for(int step = 0; step < 300; ++step)
+                {
+                    const int first  = gen() % numActions;
+                    const int second = gen() % numActions;
+                    auto found       = std::find(before[first].begin(), before[first].end(), second);
+                    if(found != before[first].end() && gen() % 2 == 0)
+                    {
+                        before[first].erase(found);
+                        sched.removeOC(first, second);
+                    }
+                    else if(first == second || referenceReachable(before, second, first))
+                    {
+                        // A constraint closing a cycle is rejected and leaves the schedule as it was
+                        const std::vector<std::vector<float>> stn = sched.stn;
+                        EXPECT_FALSE(sched.checkOC(first, second));
+                        EXPECT_FALSE(sched.addOC(first, second));
+                        EXPECT_EQ(sched.stn, stn);
+                        sched.scheduleValid = true;
+                    }
+                    else
+                    {
+                        EXPECT_TRUE(sched.checkOC(first, second));
+                        EXPECT_TRUE(sched.addOC(first, second));
+                        if(found == before[first].end())
+                        {
+                            before[first].push_back(second);
+                        }
+                    }
+
+                    expectSameConstraints(sched.beforeConstraints, before);
+                    const std::vector<std::vector<float>> expected = referenceSchedule(durations, before);
+                    ASSERT_FALSE(expected.empty());
+                    expectSameSchedule(sched.stn, expected);
+
+                    float makespan = 0;
+                    for(const std::vector<float>& times: expected)
+                    {
+                        makespan = std::max(makespan, times[1]);
+                    }
+                    EXPECT_NEAR(sched.getMakeSpan(), makespan, 1e-3);
+                }
+            }
+        }
+
+        TEST(TaskSchedule, switch_time_reverts)
+        {
+            for(int p = 0; p < 20; ++p)
+            {
+                auto [durations, orderingConstraints, disConstraints] = randomProblem(p, 10, 5, 3);
+                Scheduler sched;
+                ASSERT_TRUE(sched.schedule(durations, orderingConstraints, disConstraints));
+                const std::vector<std::vector<float>> stn              = sched.stn;
+                const std::vector<std::vector<int>> beforeConstraints = sched.beforeConstraints;
+                const std::vector<std::vector<int>> afterConstraints  = sched.afterConstraints;
+                const double makespan                                 = sched.getMakeSpan();
+                for(int i = 0; i < sched.getDisjuctiveSize(); ++i)
+                {
+                    // Switching for real gives the makespan that was read, or fails when the read did
+                    Scheduler switched(sched);
+                    const double switchTime = sched.getShedSwitchTime(i);
+                    if(switched.getShedSwitch(i))
+                    {
+                        const std::vector<std::vector<float>> expected =
+                            referenceSchedule(durations, switched.beforeConstraints);
+                        ASSERT_FALSE(expected.empty());
+                        expectSameSchedule(switched.stn, expected);
+                        EXPECT_NEAR(switchTime, switched.getMakeSpan(), 1e-3);
+                    }
+                    else
+                    {
+                        EXPECT_EQ(switchTime, -1);
+                    }
+
+                    // Reading the switch time leaves the schedule as it was
+                    EXPECT_TRUE(sched.scheduleValid);
+                    EXPECT_EQ(sched.stn, stn);
+                    expectSameConstraints(sched.beforeConstraints, beforeConstraints);
+                    expectSameConstraints(sched.afterConstraints, afterConstraints);
+                    EXPECT_EQ(sched.getMakeSpan(), makespan);
+                }
+            }
+        }
     }
-}
\ No newline at end of file
+}
@@ -17,6 +17,7 @@
  */
 
 // global
+#include <algorithm>
 #include <memory>
 
 // external
@@ -31,10 +32,12 @@
 #include <ompl/base/objectives/PathLengthOptimizationObjective.h>
 #include <ompl/base/spaces/RealVectorStateSpace.h>
 #include <ompl/geometric/planners/prm/LazyPRM.h>
+#include <ompl/util/RandomNumbers.h>
 
 // local
 #include <grstaps/motion_planning/motion_planner.hpp>
 #include <grstaps/motion_planning/validity_checker.hpp>
+#include <grstaps/motion_planning/visibility_graph.hpp>
 
 namespace ob = ompl::base;
 namespace og = ompl::geometric;
@@ -189,5 +192,106 @@ namespace grstaps
                 FAIL();
             }
         }
+
+        TEST(MotionPlanning, roadmap_one_to_many)
+        {
+            // The roadmap is sampled, so fix the seed to make the test repeatable
+            ompl::RNG::setSeed(1);
+
+            std::vector<b2PolygonShape> obstacles;
+
+            // Block the direct paths through the center
+            b2PolygonShape obstacle;
+            obstacle.SetAsBox(0.2, 0.2, b2Vec2(1.0, 1.0), 0);
+            obstacles.push_back(obstacle);
+
+            std::vector<Location> locations = {Location("a", 0.5, 0.5),
+                                               Location("b", 1.5, 1.5),
+                                               Location("c", 0.5, 1.5),
+                                               Location("d", 1.5, 0.5)};
+
+            MotionPlanner mp;
+            mp.setMap(obstacles, 0.0, 2.0);
+            mp.setLocations(locations);
+            mp.setQueryTime(0.0001);
+            mp.setConnectionRange(0.1);
+            mp.setRoadmapSize(2000);
+
+            // The first query from a location answers the paths to all others in both directions
+            for(unsigned int to = 1; to < locations.size(); ++to)
+            {
+                std::tuple<bool, float, std::vector<std::pair<float, float>>> forward = mp.getWaypoints(0, to);
+                std::tuple<bool, float, std::vector<std::pair<float, float>>> backward = mp.getWaypoints(to, 0);
+                ASSERT_TRUE(std::get<0>(forward));
+                ASSERT_TRUE(std::get<0>(backward));
+                EXPECT_FLOAT_EQ(std::get<1>(forward), std::get<1>(backward));
+                EXPECT_GE(std::get<1>(forward),
+                          std::hypot(locations[to].x() - locations[0].x(), locations[to].y() - locations[0].y()));
+                EXPECT_FLOAT_EQ(std::get<2>(forward).front().first, locations[0].x());
+                EXPECT_FLOAT_EQ(std::get<2>(forward).back().first, locations[to].x());
+            }
+        }
+
+        // Square from (min, min) to (max, max), scaled like the clipper maps
+        static ClipperLib2::Path square(float min, float max)
+        {
+            return ClipperLib2::Path{ClipperLib2::IntPoint(min * 1E6, min * 1E6),
+                                     ClipperLib2::IntPoint(max * 1E6, min * 1E6),
+                                     ClipperLib2::IntPoint(max * 1E6, max * 1E6),
+                                     ClipperLib2::IntPoint(min * 1E6, max * 1E6)};
+        }
+
+        TEST(MotionPlanning, visibility_graph_exact)
+        {
+            // Free space [0, 10] x [0, 10] with an obstacle at [4, 6] x [4, 6]
+            ClipperLib2::Paths map = {square(0, 10), square(4, 6)};
+            std::vector<Location> locations = {Location("a", 1, 5), Location("b", 9, 5), Location("c", 5, 5)};
+
+            VisibilityGraph graph(map, locations, 0);
+            std::tuple<bool, float, std::vector<std::pair<float, float>>> path = graph.query(0, 1);
+            ASSERT_TRUE(std::get<0>(path));
+            EXPECT_NEAR(std::get<1>(path), 2 * std::sqrt(10.0f) + 2, 1E-4);
+            ASSERT_EQ(std::get<2>(path).size(), 4);
+            EXPECT_FLOAT_EQ(std::get<2>(path).front().first, 1);
+            EXPECT_FLOAT_EQ(std::get<2>(path).back().first, 9);
+
+            // A location inside the obstacle cannot be reached
+            EXPECT_FALSE(std::get<0>(graph.query(0, 2)));
+
+            // The robot radius grows the obstacle
+            VisibilityGraph offset(map, locations, 0.5);
+            EXPECT_NEAR(std::get<1>(offset.query(0, 1)), 2 * std::sqrt(8.5f) + 3, 1E-4);
+
+            // Rebuilding gives exactly the same path
+            VisibilityGraph rebuilt(map, locations, 0);
+            EXPECT_EQ(std::get<1>(rebuilt.query(0, 1)), std::get<1>(path));
+            EXPECT_EQ(std::get<2>(rebuilt.query(0, 1)), std::get<2>(path));
+        }
+
+        TEST(MotionPlanning, distance_matrix_matches_waypoints)
+        {
+            std::vector<Location> locations = {Location("a", 1, 5), Location("b", 9, 5), Location("c", 5, 9)};
+
+            MotionPlanner mp;
+            mp.setMap(ClipperLib2::Paths{square(0, 10), square(4, 6)}, 0.0, 10.0);
+            mp.setLocations(locations);
+            mp.setVisibilityGraph(true);
+
+            for(unsigned int from = 0; from < locations.size(); ++from)
+            {
+                for(unsigned int to = 0; to < locations.size(); ++to)
+                {
+                    std::pair<bool, float> result = mp.query(from, to);
+                    std::tuple<bool, float, std::vector<std::pair<float, float>>> forward = mp.getWaypoints(from, to);
+                    std::tuple<bool, float, std::vector<std::pair<float, float>>> backward = mp.getWaypoints(to, from);
+                    EXPECT_EQ(result.first, std::get<0>(forward));
+                    EXPECT_EQ(result.second, std::get<1>(forward));
+
+                    // Both directions share one polyline in the waypoint arena
+                    std::reverse(std::get<2>(backward).begin(), std::get<2>(backward).end());
+                    EXPECT_EQ(std::get<2>(forward), std::get<2>(backward));
+                }
+            }
+        }
     }  // namespace test
 }  // namespace grstaps
@@ -20,10 +20,13 @@
 #include <fmt/format.h>
 #include <gtest/gtest.h>
 #include <chrono>
+#include <cstdio>
+#include <fstream>
 
 #include <nlohmann/json.hpp>
 
 // local
+#include <grstaps/compiled_map.hpp>
 #include <grstaps/problem.hpp>
 #include <grstaps/solver.hpp>
 
@@ -367,5 +370,37 @@ namespace grstaps
             // Save problem
             solver.writeSolution("tests/data/p10", solution);
         }
+
+        TEST(Problem, compiled_map_round_trip)
+        {
+            // Two overlapping buildings on a road
+            nlohmann::json map;
+            map["buildings"] = {{{{"x", 1}, {"y", 1}}, {{"x", 3}, {"y", 1}}, {{"x", 3}, {"y", 3}}, {{"x", 1}, {"y", 3}}},
+                                {{{"x", 2}, {"y", 2}}, {{"x", 4}, {"y", 2}}, {{"x", 4}, {"y", 4}}, {{"x", 2}, {"y", 4}}}};
+            map["roads"]     = {{{{"x", 0}, {"y", 0}}, {{"x", 5}, {"y", 0}}, {{"x", 5}, {"y", 1}}, {{"x", 0}, {"y", 1}}}};
+
+            std::ofstream("tests/data/maps/compiled_map_test.json") << map;
+            const CompiledMap compiled = CompiledMap::load("tests/data/maps/compiled_map_test.json");
+            EXPECT_FALSE(CompiledMap::isCompiled("tests/data/maps/compiled_map_test.json"));
+
+            // The union merges everything into a single polygon, the aerial map is the bounds
+            ASSERT_EQ(compiled.maps.size(), 2);
+            EXPECT_EQ(compiled.maps[0].size(), 1);
+            EXPECT_EQ(compiled.maps[1].size(), 1);
+            EXPECT_LT(compiled.boundaryMin, 0);
+            EXPECT_GT(compiled.boundaryMax, 4E6);
+            EXPECT_GT(compiled.longestPerimeter, 0);
+
+            compiled.write("tests/data/maps/compiled_map_test.bin");
+            ASSERT_TRUE(CompiledMap::isCompiled("tests/data/maps/compiled_map_test.bin"));
+            const CompiledMap loaded = CompiledMap::load("tests/data/maps/compiled_map_test.bin");
+            EXPECT_EQ(loaded.maps, compiled.maps);
+            EXPECT_EQ(loaded.boundaryMin, compiled.boundaryMin);
+            EXPECT_EQ(loaded.boundaryMax, compiled.boundaryMax);
+            EXPECT_EQ(loaded.longestPerimeter, compiled.longestPerimeter);
+
+            std::remove("tests/data/maps/compiled_map_test.json");
+            std::remove("tests/data/maps/compiled_map_test.bin");
+        }
     }  // namespace test
 }  // namespace grstaps
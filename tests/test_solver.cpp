@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2020 Andrew Messing
+ *
+ * grstaps is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 3 of the License,
+ * or any later version.
+ *
+ * grstaps is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with grstaps; if not, write to the Free Software Foundation,
+ * Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+// external
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include <nlohmann/json.hpp>
+
+// local
+#include <grstaps/problem.hpp>
+#include <grstaps/solution.hpp>
+#include <grstaps/solver_sequential.hpp>
+#include <grstaps/solver_single_threaded.hpp>
+
+namespace grstaps
+{
+    namespace test
+    {
+        /**
+         * Unique directory under the system temporary directory that is removed with everything in it on destruction
+         */
+        class TemporaryDirectory
+        {
+           public:
+            TemporaryDirectory()
+            {
+                std::string pattern = (std::filesystem::temp_directory_path() / "grstaps_test_XXXXXX").string();
+                if(mkdtemp(pattern.data()) == nullptr)
+                {
+                    throw std::runtime_error("Cannot create a temporary directory from " + pattern);
+                }
+                m_path = pattern;
+            }
+
+            ~TemporaryDirectory()
+            {
+                std::error_code error;
+                std::filesystem::remove_all(m_path, error);
+            }
+
+            TemporaryDirectory(const TemporaryDirectory&) = delete;
+            TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+            const std::filesystem::path& path() const
+            {
+                return m_path;
+            }
+
+           private:
+            std::filesystem::path m_path;
+        };
+
+        /**
+         * A site in an open square is inspected by one of two robots, so every motion plan is at least as long as the
+         * straight line to the site
+         */
+        void writeInspectionProblem(const std::filesystem::path& folder, bool lazy_motion_planning)
+        {
+            std::ofstream(folder / "domain.pddl") << R"((define (domain inspection)
+  (:requirements :typing :durative-actions)
+  (:types site)
+  (:predicates (pending ?s - site) (inspected ?s - site))
+  (:durative-action inspect
+    :parameters (?s - site)
+    :duration (= ?duration 10)
+    :condition (at start (pending ?s))
+    :effect (and (at start (not (pending ?s))) (at end (inspected ?s)))))
+)";
+            std::ofstream(folder / "problem.pddl") << R"((define (problem inspection1)
+  (:domain inspection)
+  (:objects s - site)
+  (:init (pending s))
+  (:goal (and (inspected s)))
+  (:metric minimize (total-time)))
+)";
+
+            auto location = [](const std::string& name, float x, float y) {
+                return nlohmann::json{{"name", name}, {"coord", {{"x", x}, {"y", y}}}};
+            };
+            auto rectangle = [](float x_min, float y_min, float x_max, float y_max) {
+                return nlohmann::json::array({{{"x", x_min}, {"y", y_min}},
+                                              {{"x", x_max}, {"y", y_min}},
+                                              {{"x", x_max}, {"y", y_max}},
+                                              {{"x", x_min}, {"y", y_max}}});
+            };
+
+            // Traits: MP, speed, payload, water capacity, construction ability
+            const nlohmann::json config = {
+                {"streets", {location("p", 0, 0), location("s", 3, 0), location("q", 1, 2)}},
+                {"buildings", nlohmann::json::array()},
+                {"hospital", location("hospital", 0, 0)},
+                {"fire_station", location("fire_station", 0, 0)},
+                {"construction_company", location("construction_company", 0, 0)},
+                {"robot_traits", {{0, 1, 1, 0, 0}, {0, 1, 1, 0, 0}}},
+                {"robot_start_locations", {0, 2}},
+                {"mp_index", 0},
+                {"speed_index", 1},
+                {"grounded_actions", {"inspect s"}},
+                {"actions_trait_requirements", {{0, 0.1, 1, 0, 0}}},
+                {"actions_start_end", {{1, 1}}},
+                {"lazy_motion_planning", lazy_motion_planning}};
+            std::ofstream(folder / "config.json") << config;
+
+            const nlohmann::json map = {{"buildings", nlohmann::json::array()}, {"roads", {rectangle(-1, -1, 4, 3)}}};
+            std::ofstream(folder / "map.json") << map;
+        }
+
+        std::shared_ptr<Solution> solveInspectionProblem(bool lazy_motion_planning, bool sequential)
+        {
+            TemporaryDirectory folder;
+            writeInspectionProblem(folder.path(), lazy_motion_planning);
+            Problem problem;
+            problem.init((folder.path() / "domain.pddl").c_str(),
+                         (folder.path() / "problem.pddl").c_str(),
+                         (folder.path() / "config.json").c_str(),
+                         (folder.path() / "map.json").c_str());
+
+            if(sequential)
+            {
+                SolverSequential solver;
+                return solver.solve(problem, 30, false);
+            }
+            SolverSingleThreaded solver;
+            return solver.solve(problem);
+        }
+
+        TEST(Solver, lazy_motion_planning_reports_exact_makespan)
+        {
+            // Robot 1 starts at q, which is the closest to the site
+            const float travel = std::hypot(3.0f - 1.0f, 0.0f - 2.0f);
+            for(bool sequential: {false, true})
+            {
+                std::shared_ptr<Solution> exact = solveInspectionProblem(false, sequential);
+                ASSERT_NE(exact, nullptr);
+                EXPECT_GE(exact->metrics()["makespan"].get<float>(), 10 + travel);
+
+                // The search scores with straight line travel times, the reported allocation has to be motion planned
+                std::shared_ptr<Solution> lazy = solveInspectionProblem(true, sequential);
+                ASSERT_NE(lazy, nullptr);
+                EXPECT_GE(lazy->metrics()["makespan"].get<float>(), 10 + travel);
+                EXPECT_FALSE(lazy->allocation().isScheduleLowerBound());
+            }
+        }
+    }  // namespace test
+}  // namespace grstaps
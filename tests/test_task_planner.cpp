@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2020 Andrew Messing
+ *
+ * grstaps is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 3 of the License,
+ * or any later version.
+ *
+ * grstaps is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with grstaps; if not, write to the Free Software Foundation,
+ * Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+// external
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include <nlohmann/json.hpp>
+
+// local
+#include <grstaps/solver_fcpop.hpp>
+#include <grstaps/task_planning/planner_parameters.hpp>
+#include <grstaps/task_planning/sas_task_cache.hpp>
+#include <grstaps/task_planning/setup.hpp>
+
+namespace grstaps
+{
+    namespace test
+    {
+        /**
+         * A robot carries a package along a corridor of waypoints, so there is a single shortest plan
+         */
+        void writeCorridorProblem(const std::string& domain_filepath, const std::string& problem_filepath)
+        {
+            std::ofstream(domain_filepath) << R"((define (domain corridor)
+  (:requirements :typing :durative-actions)
+  (:types waypoint)
+  (:predicates (at ?w - waypoint) (package ?w - waypoint) (holding) (connected ?a ?b - waypoint))
+  (:durative-action move
+    :parameters (?from ?to - waypoint)
+    :duration (= ?duration 2)
+    :condition (and (at start (at ?from)) (over all (connected ?from ?to)))
+    :effect (and (at start (not (at ?from))) (at end (at ?to))))
+  (:durative-action pick
+    :parameters (?w - waypoint)
+    :duration (= ?duration 1)
+    :condition (and (over all (at ?w)) (at start (package ?w)))
+    :effect (and (at start (not (package ?w))) (at end (holding))))
+  (:durative-action drop
+    :parameters (?w - waypoint)
+    :duration (= ?duration 1)
+    :condition (and (over all (at ?w)) (at start (holding)))
+    :effect (and (at start (not (holding))) (at end (package ?w)))))
+)";
+            std::ofstream(problem_filepath) << R"((define (problem corridor1)
+  (:domain corridor)
+  (:objects w1 w2 w3 w4 w5 - waypoint)
+  (:init (at w1) (package w2)
+    (connected w1 w2) (connected w2 w3) (connected w3 w4) (connected w4 w5)
+    (connected w2 w1) (connected w3 w2) (connected w4 w3) (connected w5 w4))
+  (:goal (and (package w5)))
+  (:metric minimize (total-time)))
+)";
+        }
+
+        TEST(TaskPlanner, parallel_matches_serial)
+        {
+            const std::string domain  = "tests/data/corridor_domain.pddl";
+            const std::string problem = "tests/data/corridor_problem.pddl";
+            writeCorridorProblem(domain, problem);
+
+            // Plans are partially ordered, so the order in which the actions were added can differ
+            auto sortedActions = [](const nlohmann::json& output) {
+                std::vector<std::string> actions = output["solution"]["actions"];
+                std::sort(actions.begin(), actions.end());
+                return actions;
+            };
+
+            SolverFcpop serial;
+            const nlohmann::json expected = serial.solve(domain, problem);
+            ASSERT_FALSE(expected.is_null());
+
+            for(unsigned int num_threads: {2u, 4u})
+            {
+                SolverFcpop parallel(num_threads);
+                const nlohmann::json output = parallel.solve(domain, problem);
+                ASSERT_FALSE(output.is_null());
+                EXPECT_EQ(sortedActions(output), sortedActions(expected));
+                EXPECT_FLOAT_EQ(output["makespan"].get<float>(), expected["makespan"].get<float>());
+
+                // The parallel search reports the same statistics as the sequential one
+                for(const auto& item: expected.items())
+                {
+                    EXPECT_TRUE(output.contains(item.key())) << item.key();
+                }
+            }
+
+            std::remove(domain.c_str());
+            std::remove(problem.c_str());
+        }
+
+        TEST(TaskPlanner, sas_task_cache_round_trip)
+        {
+            const std::string domain    = "tests/data/corridor_domain.pddl";
+            const std::string problem   = "tests/data/corridor_problem.pddl";
+            const std::string directory = "tests/data/sas_task_cache";
+            writeCorridorProblem(domain, problem);
+            std::filesystem::create_directories(directory);
+
+            // The first preprocessing translates the task and writes the snapshot
+            PlannerParameters parameters;
+            parameters.domainFileName  = domain.c_str();
+            parameters.problemFileName = problem.c_str();
+            parameters.cacheDirectory  = directory.c_str();
+            SASTask* translated        = Setup::doPreprocess(&parameters);
+            ASSERT_NE(translated, nullptr);
+
+            SASTaskCache cache(directory.c_str(), domain.c_str(), problem.c_str(), false, false);
+            ASSERT_TRUE(cache.isEnabled());
+            SASTask* loaded = cache.load();
+            ASSERT_NE(loaded, nullptr);
+            EXPECT_EQ(loaded->toString(), translated->toString());
+            ASSERT_EQ(loaded->getNumFluents(), translated->getNumFluents());
+            for(unsigned int var1 = 0; var1 < translated->variables.size(); ++var1)
+            {
+                for(unsigned int value1: translated->variables[var1].possibleValues)
+                {
+                    for(unsigned int var2 = 0; var2 < translated->variables.size(); ++var2)
+                    {
+                        for(unsigned int value2: translated->variables[var2].possibleValues)
+                        {
+                            EXPECT_EQ(loaded->isMutex(var1, value1, var2, value2),
+                                      translated->isMutex(var1, value1, var2, value2));
+                            EXPECT_EQ(loaded->isPermanentMutex(var1, value1, var2, value2),
+                                      translated->isPermanentMutex(var1, value1, var2, value2));
+                        }
+                    }
+                }
+            }
+            for(SASAction& a1: translated->actions)
+            {
+                for(SASAction& a2: translated->actions)
+                {
+                    EXPECT_EQ(loaded->isPermanentMutex(&loaded->actions[a1.index], &loaded->actions[a2.index]),
+                              translated->isPermanentMutex(&a1, &a2));
+                }
+            }
+
+            // A different problem is not served from the snapshot
+            std::ofstream(problem, std::ios::app) << ";";
+            SASTaskCache stale(directory.c_str(), domain.c_str(), problem.c_str(), false, false);
+            EXPECT_EQ(stale.load(), nullptr);
+
+            // Neither is a truncated snapshot
+            for(const auto& entry: std::filesystem::directory_iterator(directory))
+            {
+                std::filesystem::resize_file(entry.path(), std::filesystem::file_size(entry.path()) / 2);
+            }
+            EXPECT_EQ(cache.load(), nullptr);
+
+            delete translated;
+            delete loaded;
+            std::filesystem::remove_all(directory);
+            std::remove(domain.c_str());
+            std::remove(problem.c_str());
+        }
+    }  // namespace test
+}  // namespace grstaps